@@ -18,6 +18,16 @@ namespace ultrainio {
             return r;
         }
 
+        // writes 2 * len chars to out, no allocation
+        template <class T>
+        static void toHex(const T* c, size_t len, char* out) {
+            const char* hexStr="0123456789abcdef";
+            for (size_t i = 0; i < len; i++) {
+                out[i*2] = hexStr[(c[i]>>4)];
+                out[i*2 + 1] = hexStr[(c[i] & 0x0f)];
+            }
+        }
+
         template <class T>
         static size_t fromHex(const std::string& hexStr, T* out, size_t len) {
             std::string::const_iterator i = hexStr.begin();
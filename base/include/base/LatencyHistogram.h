@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ultrainio {
+    struct LatencySummary {
+        std::string name;
+        std::string labels;
+        uint64_t count = 0;
+        uint64_t sumUs = 0;
+        uint64_t maxUs = 0;
+        uint64_t p50Us = 0;
+        uint64_t p90Us = 0;
+        uint64_t p99Us = 0;
+        uint64_t p999Us = 0;
+    };
+
+    // Log-linear histogram of microsecond latencies, every power of two is split into kSubBuckets buckets
+    // so a percentile is off by at most 1 / kSubBuckets. record() only does relaxed atomic adds and can be
+    // called from any thread without a lock.
+    class LatencyHistogram {
+    public:
+        static const int kSubBucketBits = 3;
+        static const int kSubBuckets = 1 << kSubBucketBits;
+        // values >= 2 ^ kMaxBits us (about 12 days) are counted in the last bucket
+        static const int kMaxBits = 40;
+        static const int kBucketNumber = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+        LatencyHistogram(const std::string& name, const std::string& labels);
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator = (const LatencyHistogram&) = delete;
+
+        void record(uint64_t us);
+
+        uint64_t count() const;
+
+        uint64_t sum() const;
+
+        uint64_t max() const;
+
+        // upper bound of the bucket holding the p-th value, p in [0, 1]
+        uint64_t percentile(double p) const;
+
+        LatencySummary summary() const;
+
+        // appends the cumulative buckets (at every power of two), sum and count in Prometheus text format
+        void toPrometheus(std::string& out) const;
+
+        void reset();
+
+        const std::string& getName() const;
+
+        const std::string& getLabels() const;
+
+        static int bucketOf(uint64_t us);
+
+        // the largest value counted in bucket index
+        static uint64_t bucketUpperBound(int index);
+
+    private:
+        std::string m_name;
+        std::string m_labels;
+        std::atomic<uint64_t> m_buckets[kBucketNumber];
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_sum;
+        std::atomic<uint64_t> m_max;
+    };
+
+    // Records the time from construction to destruction into a histogram.
+    class ScopedLatency {
+    public:
+        explicit ScopedLatency(LatencyHistogram& histogram);
+
+        ~ScopedLatency();
+
+    private:
+        LatencyHistogram& m_histogram;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Process wide set of named histograms, a histogram is created on the first get() and lives until exit,
+    // so callers may keep the reference.
+    class LatencyRegistry {
+    public:
+        static LatencyRegistry& getInstance();
+
+        LatencyRegistry(const LatencyRegistry&) = delete;
+        LatencyRegistry& operator = (const LatencyRegistry&) = delete;
+
+        // labels is the Prometheus label list without braces, e.g. phase="ba1"
+        LatencyHistogram& get(const std::string& name, const std::string& labels = std::string(),
+                              const std::string& help = std::string());
+
+        std::vector<LatencySummary> summaries() const;
+
+        std::string toPrometheus() const;
+
+        void reset();
+
+    private:
+        LatencyRegistry() = default;
+
+        mutable std::mutex m_mutex;
+        // key - name + '\0' + labels, ordered so that the series of a metric stay together
+        std::map<std::string, std::unique_ptr<LatencyHistogram>> m_histograms;
+        std::map<std::string, std::string> m_help;
+    };
+
+    inline uint64_t elapsedUs(const std::chrono::steady_clock::time_point& start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+}
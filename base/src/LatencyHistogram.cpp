@@ -0,0 +1,218 @@
+#include "base/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ultrainio {
+    // Prometheus buckets are exported at 2 ^ k - 1 for k in [kFirstExportBits, kLastExportBits]
+    static const int kFirstExportBits = 7;
+    static const int kLastExportBits = 27;
+
+    static int highestBit(uint64_t v) {
+        int n = 0;
+        while (v >>= 1) {
+            n++;
+        }
+        return n;
+    }
+
+    static std::string seriesLabels(const std::string& labels, const std::string& extra) {
+        if (labels.empty() && extra.empty()) {
+            return std::string();
+        }
+        if (labels.empty()) {
+            return "{" + extra + "}";
+        }
+        if (extra.empty()) {
+            return "{" + labels + "}";
+        }
+        return "{" + labels + "," + extra + "}";
+    }
+
+    LatencyHistogram::LatencyHistogram(const std::string& name, const std::string& labels)
+            : m_name(name), m_labels(labels), m_count(0), m_sum(0), m_max(0) {
+        for (auto& b : m_buckets) {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int LatencyHistogram::bucketOf(uint64_t us) {
+        if (us < kSubBuckets) {
+            return static_cast<int>(us);
+        }
+        int bits = highestBit(us);
+        if (bits >= kMaxBits) {
+            return kBucketNumber - 1;
+        }
+        int shift = bits - kSubBucketBits;
+        return (shift + 1) * kSubBuckets + static_cast<int>((us >> shift) & (kSubBuckets - 1));
+    }
+
+    uint64_t LatencyHistogram::bucketUpperBound(int index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        int shift = index / kSubBuckets - 1;
+        uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(uint64_t us) {
+        m_buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(us, std::memory_order_relaxed);
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (us > max && !m_max.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t LatencyHistogram::count() const {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::sum() const {
+        return m_sum.load(std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::max() const {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::percentile(double p) const {
+        uint64_t counts[kBucketNumber];
+        uint64_t total = 0;
+        for (int i = 0; i < kBucketNumber; i++) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return 0;
+        }
+        p = std::min(1.0, std::max(0.0, p));
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * total)));
+        uint64_t seen = 0;
+        for (int i = 0; i < kBucketNumber; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(bucketUpperBound(i), max());
+            }
+        }
+        return max();
+    }
+
+    LatencySummary LatencyHistogram::summary() const {
+        LatencySummary s;
+        s.name = m_name;
+        s.labels = m_labels;
+        s.count = count();
+        s.sumUs = sum();
+        s.maxUs = max();
+        s.p50Us = percentile(0.5);
+        s.p90Us = percentile(0.9);
+        s.p99Us = percentile(0.99);
+        s.p999Us = percentile(0.999);
+        return s;
+    }
+
+    void LatencyHistogram::toPrometheus(std::string& out) const {
+        uint64_t cumulative = 0;
+        int index = 0;
+        for (int bits = kFirstExportBits; bits <= kLastExportBits; bits++) {
+            int end = bucketOf(uint64_t(1) << bits);
+            for (; index < end; index++) {
+                cumulative += m_buckets[index].load(std::memory_order_relaxed);
+            }
+            out += m_name + "_bucket" + seriesLabels(m_labels, "le=\"" + std::to_string((uint64_t(1) << bits) - 1) + "\"")
+                    + " " + std::to_string(cumulative) + "\n";
+        }
+        for (; index < kBucketNumber; index++) {
+            cumulative += m_buckets[index].load(std::memory_order_relaxed);
+        }
+        out += m_name + "_bucket" + seriesLabels(m_labels, "le=\"+Inf\"") + " " + std::to_string(cumulative) + "\n";
+        out += m_name + "_sum" + seriesLabels(m_labels, std::string()) + " " + std::to_string(sum()) + "\n";
+        out += m_name + "_count" + seriesLabels(m_labels, std::string()) + " " + std::to_string(cumulative) + "\n";
+    }
+
+    void LatencyHistogram::reset() {
+        for (auto& b : m_buckets) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    const std::string& LatencyHistogram::getName() const {
+        return m_name;
+    }
+
+    const std::string& LatencyHistogram::getLabels() const {
+        return m_labels;
+    }
+
+    // ScopedLatency
+    ScopedLatency::ScopedLatency(LatencyHistogram& histogram)
+            : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+
+    ScopedLatency::~ScopedLatency() {
+        m_histogram.record(elapsedUs(m_start));
+    }
+
+    // LatencyRegistry
+    LatencyRegistry& LatencyRegistry::getInstance() {
+        static LatencyRegistry registry;
+        return registry;
+    }
+
+    LatencyHistogram& LatencyRegistry::get(const std::string& name, const std::string& labels, const std::string& help) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // the name ends at '\0' so a metric whose name is a prefix of another one still sorts apart
+        std::string key = name;
+        key.push_back('\0');
+        key += labels;
+        auto itor = m_histograms.find(key);
+        if (itor == m_histograms.end()) {
+            itor = m_histograms.insert(std::make_pair(key, std::unique_ptr<LatencyHistogram>(new LatencyHistogram(name, labels)))).first;
+        }
+        if (!help.empty()) {
+            m_help[name] = help;
+        }
+        return *itor->second;
+    }
+
+    std::vector<LatencySummary> LatencyRegistry::summaries() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<LatencySummary> v;
+        v.reserve(m_histograms.size());
+        for (const auto& e : m_histograms) {
+            v.push_back(e.second->summary());
+        }
+        return v;
+    }
+
+    std::string LatencyRegistry::toPrometheus() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string out;
+        std::string lastName;
+        for (const auto& e : m_histograms) {
+            const std::string& name = e.second->getName();
+            if (name != lastName) {
+                auto help = m_help.find(name);
+                if (help != m_help.end()) {
+                    out += "# HELP " + name + " " + help->second + "\n";
+                }
+                out += "# TYPE " + name + " histogram\n";
+                lastName = name;
+            }
+            e.second->toPrometheus(out);
+        }
+        return out;
+    }
+
+    void LatencyRegistry::reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& e : m_histograms) {
+            e.second->reset();
+        }
+    }
+}
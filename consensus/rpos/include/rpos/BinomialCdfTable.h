@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ultrainio {
+    // cdf of binomial(trials, p) from k = 0 until it reaches 1, so that the sortition of a proof
+    // is a binary search instead of a cdf evaluation per k
+    class BinomialCdfTable {
+    public:
+        BinomialCdfTable();
+
+        BinomialCdfTable(int trials, double p);
+
+        // the smallest k with rand <= cdf(k)
+        int reverse(double rand) const;
+
+        size_t size() const;
+
+    private:
+        std::vector<double> m_cdf;
+    };
+}
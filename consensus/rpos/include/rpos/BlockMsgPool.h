@@ -2,6 +2,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <core/Message.h>
@@ -9,10 +10,14 @@
 
 namespace ultrainio {
     class StakeVoteBase;
+    struct CommitteeState;
 
     class BlockMsgPool {
     public:
         BlockMsgPool(uint32_t blockNum);
+
+        BlockMsgPool(uint32_t blockNum, std::shared_ptr<CommitteeState> committeeStatePtr, const std::string& random);
+
         std::shared_ptr<StakeVoteBase> getStakeVote();
     private:
         uint32_t m_blockNum = 0;
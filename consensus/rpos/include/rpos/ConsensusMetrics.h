@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include <base/LatencyHistogram.h>
+#include <core/Message.h>
+
+namespace ultrainio {
+    // Latency histograms of the consensus path, kept in LatencyRegistry and exported by monitor_plugin.
+    // The step state is only touched from the app thread, as Node and Scheduler are.
+    class ConsensusMetrics {
+    public:
+        static std::shared_ptr<ConsensusMetrics> getInstance();
+
+        ConsensusMetrics();
+
+        // called by MsgMgr::moveToNewStep
+        void newStep(uint32_t blockNum, ConsensusPhase phase, int baxCount);
+
+        // a valid propose of the current block, records the delay from the start of BA0
+        void proposeArrived(uint32_t blockNum);
+
+        bool reached2f() const;
+
+        // the first block id with 2f + 1 echoes in the current step, records the time from the step start
+        void reach2f(uint32_t blockNum, ConsensusPhase phase, int baxCount);
+
+        LatencyHistogram& echoVerify();
+
+        LatencyHistogram& produceBlock(bool sync);
+
+        LatencyHistogram& pushBlock();
+
+    private:
+        static std::shared_ptr<ConsensusMetrics> s_self;
+
+        uint32_t m_blockNum = 0;
+        ConsensusPhase m_phase = kPhaseInit;
+        int m_baxCount = 0;
+        std::chrono::steady_clock::time_point m_stepStart;
+        std::chrono::steady_clock::time_point m_ba0Start;
+        bool m_reached2f = false;
+
+        LatencyHistogram& m_proposeArrival;
+        LatencyHistogram& m_echoVerify;
+        LatencyHistogram& m_timeTo2fBa0;
+        LatencyHistogram& m_timeTo2fBa1;
+        LatencyHistogram& m_timeTo2fBax;
+        LatencyHistogram& m_produceBlock;
+        LatencyHistogram& m_produceSyncBlock;
+        LatencyHistogram& m_pushBlock;
+    };
+}
@@ -12,6 +12,9 @@ namespace ultrainio {
 
         std::vector<int> shuffle();
 
+        // only the first count elements are shuffled, they are the same as the ones of shuffle()
+        std::vector<int> shuffle(uint32_t count);
+
     private:
         int findNext(const fc::sha256& rand, uint32_t size);
         fc::sha256 m_rand;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <core/Message.h>
@@ -11,6 +12,7 @@
 
 namespace ultrainio {
     class StakeVoteBase;
+    struct CommitteeState;
 
     enum MessageStatus {
         kSuccess = 0,
@@ -39,6 +41,9 @@ namespace ultrainio {
 
         std::shared_ptr<StakeVoteBase> getStakeVote(uint32_t blockNum);
 
+        // use a fixed committee and random instead of the world state, for the consensus simulator
+        void setCommitteeState(std::shared_ptr<CommitteeState> committeeStatePtr, const std::string& random);
+
     private:
         MsgMgr() = default;
 
@@ -46,8 +51,12 @@ namespace ultrainio {
 
         void clearSomeBlockMessage(uint32_t blockNum);
 
+        bool isNonProducingNode() const;
+
         static std::shared_ptr<MsgMgr> s_self;
         std::map<int, BlockMsgPoolPtr> m_blockMsgPoolMap; // key - blockNum
+        std::shared_ptr<CommitteeState> m_committeeStatePtr = nullptr;
+        std::string m_random;
 
         // Only for debug purpose.
         friend class Scheduler;
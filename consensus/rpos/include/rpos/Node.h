@@ -65,6 +65,9 @@ namespace ultrainio {
 
         bool syncCancel();
 
+        // the write queue to the peer has drained, so the sync stream blocked on it can go on
+        void syncWritable(const fc::sha256& nodeId);
+
         void run();
 
         void reset();
@@ -75,6 +78,9 @@ namespace ultrainio {
 
         void sendMessage(const fc::sha256& nodeId, const SyncBlockMsg& msg);
 
+        // send a block as packed in the block log, returns false if the peer can not take more now
+        bool sendPackedBlock(const fc::sha256& nodeId, uint32_t seqNum, const std::vector<char>& packedBlock, const std::string& proof);
+
         bool sendMessage(const ReqSyncMsg& msg);
 
         void sendMessage(const fc::sha256& nodeId, const RspBlockNumRangeMsg& msg);
@@ -99,6 +105,22 @@ namespace ultrainio {
 
         uint32_t getRoundCount();
 
+        // phases since the genesis time and ms left in the current phase, at the given time
+        static uint32_t getRoundCount(const fc::time_point& now);
+
+        static uint32_t getLeftTime(const fc::time_point& now);
+
+        // BA0 time of a non proposer before it checks for the BA1 echoes, in ms
+        static uint32_t getFastLoopTime();
+
+        static bool isFastLoop(uint32_t leftTime, bool isProposer);
+
+        // from phase + baxCount kMaxBaxCount on, the voters echo the empty block only
+        static bool isEmptyBlockPhase(uint32_t phaseCount);
+
+        // the empty block phases are skipped to when f + 1 echoes of them arrived
+        static bool isSkipToEmptyBlockPhase(ConsensusPhase phase, uint32_t baxCount, bool changePhase);
+
         int getCommitteeMemberNumber();
 
         void setGenesisTime(const fc::time_point& tp);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <core/Message.h>
@@ -13,17 +14,27 @@ namespace ultrainio {
     public:
         RoleSelection(const std::vector<std::string>& committeeV, const RoleRandom& rand);
 
-        bool isProposer(const std::string& account);
+        bool isProposer(const std::string& account) const;
 
-        bool isVoter(const std::string& account);
+        bool isVoter(const std::string& account) const;
 
-        uint32_t proposerPriority(const std::string& account);
+        uint32_t proposerPriority(const std::string& account) const;
+
+        // index is the position of the account in committeeV
+        bool isProposer(int index) const;
+
+        bool isVoter(int index) const;
+
+        uint32_t proposerPriority(int index) const;
 
         uint32_t proposerNumber() const;
 
         int voterNumber() const;
     private:
-        std::vector<std::string> m_voterV;
+        std::vector<bool> m_voterBits; // indexed by committee index
+        std::vector<int> m_proposerIndexV; // committee index ordered by priority
+        std::unordered_set<std::string> m_voterSet;
         std::vector<std::string> m_proposerV;
+        int m_voterNumber = 0;
     };
-}
\ No newline at end of file
+}
@@ -19,5 +19,9 @@ namespace ultrainio {
             }
             return false;
         }
+
+        bool operator == (const RoundInfo& rhs) const {
+            return blockNum == rhs.blockNum && phase == rhs.phase;
+        }
     };
 }
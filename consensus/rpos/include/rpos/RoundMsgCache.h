@@ -0,0 +1,204 @@
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <core/Message.h>
+#include <core/types.h>
+#include <rpos/RoundInfo.h>
+
+namespace ultrainio {
+    struct ProposeCacheSlot {
+        std::vector<ProposeMsg> msgs;
+
+        void add(const ProposeMsg& propose);
+
+        bool contains(const BlockIdType& blockId) const;
+
+        void clear();
+    };
+
+    // Echoes of one round with their tallies, kept up to date on every add so that
+    // isNeedSync / isChangePhase / satisfyVoteRules do not rebuild them.
+    struct EchoCacheSlot {
+        std::vector<EchoMsg> msgs;
+        // echoes sent by an account in this round
+        std::map<AccountName, uint32_t> accountEchoes;
+        // distinct voters of every block id
+        std::map<BlockIdType, std::set<AccountName>> voters;
+        // the largest voter number of a block id
+        uint32_t maxVoters = 0;
+
+        void add(const EchoMsg& echo);
+
+        bool contains(const EchoMsg& echo) const;
+
+        uint32_t echoesOf(const AccountName& account) const;
+
+        void clear();
+    };
+
+    /**
+     * Messages that arrive ahead of the local round, keyed by RoundInfo (blockNum, phase + baxCount).
+     * The near rounds live in a fixed ring of kBlockWindow blocks by PhaseWindow rounds whose slots keep the
+     * capacity of their vectors when reused. A round whose ring slot is held by a nearer round goes to an
+     * overflow map of at most maxOverflowRounds rounds, so messages several blocks ahead are still kept for
+     * isNeedSync. Rounds before the floor are dropped in O(1) from the ring by moving the floor, a slot is
+     * reclaimed on its next use.
+     */
+    template <class Slot, uint32_t PhaseWindow>
+    class RoundMsgCache {
+    public:
+        static const uint32_t kBlockWindow = 4;
+
+        explicit RoundMsgCache(size_t maxOverflowRounds)
+                : m_slots(kBlockWindow * PhaseWindow), m_floor(0, 0), m_maxOverflowRounds(maxOverflowRounds) {}
+
+        Slot* find(const RoundInfo& info) {
+            Entry& e = m_slots[indexOf(info)];
+            if (live(e) && e.info == info) {
+                return &e.slot;
+            }
+            auto itor = m_overflow.find(info);
+            return itor == m_overflow.end() ? nullptr : &itor->second;
+        }
+
+        const Slot* find(const RoundInfo& info) const {
+            const Entry& e = m_slots[indexOf(info)];
+            if (live(e) && e.info == info) {
+                return &e.slot;
+            }
+            auto itor = m_overflow.find(info);
+            return itor == m_overflow.end() ? nullptr : &itor->second;
+        }
+
+        // the slot of info, nullptr if info is before the floor
+        Slot* findOrClaim(const RoundInfo& info) {
+            if (info < m_floor) {
+                return nullptr;
+            }
+            auto itor = m_overflow.find(info);
+            if (itor != m_overflow.end()) {
+                return &itor->second;
+            }
+            Entry& e = m_slots[indexOf(info)];
+            if (live(e)) {
+                if (e.info == info) {
+                    return &e.slot;
+                }
+                if (e.info < info) {
+                    return claimOverflow(info);
+                }
+                // the nearer round takes the ring slot, the farther one moves to the overflow
+                Slot* moved = claimOverflow(e.info);
+                if (moved) {
+                    std::swap(*moved, e.slot);
+                }
+            }
+            e.slot.clear();
+            e.info = info;
+            e.used = true;
+            return &e.slot;
+        }
+
+        void erase(const RoundInfo& info) {
+            Entry& e = m_slots[indexOf(info)];
+            if (live(e) && e.info == info) {
+                e.slot.clear();
+                e.used = false;
+            }
+            m_overflow.erase(info);
+        }
+
+        // drops every round before floor
+        void expireBefore(const RoundInfo& floor) {
+            if (m_floor < floor) {
+                m_floor = floor;
+                m_overflow.erase(m_overflow.begin(), m_overflow.lower_bound(floor));
+            }
+        }
+
+        void clear() {
+            for (auto& e : m_slots) {
+                e.slot.clear();
+                e.used = false;
+            }
+            m_overflow.clear();
+            m_floor = RoundInfo(0, 0);
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        // number of live rounds
+        size_t size() const {
+            size_t n = m_overflow.size();
+            for (const auto& e : m_slots) {
+                if (live(e)) {
+                    n++;
+                }
+            }
+            return n;
+        }
+
+        // f(const RoundInfo&, const Slot&) on every live round, in no particular order
+        template <class F>
+        void forEach(F f) const {
+            for (const auto& e : m_slots) {
+                if (live(e)) {
+                    f(e.info, e.slot);
+                }
+            }
+            for (const auto& it : m_overflow) {
+                f(it.first, it.second);
+            }
+        }
+
+    private:
+        struct Entry {
+            RoundInfo info;
+            Slot slot;
+            bool used = false;
+        };
+
+        static size_t indexOf(const RoundInfo& info) {
+            return (info.blockNum % kBlockWindow) * PhaseWindow + info.phase % PhaseWindow;
+        }
+
+        bool live(const Entry& e) const {
+            return e.used && !(e.info < m_floor);
+        }
+
+        // a new overflow round, the rounds of the oldest block are dropped when the overflow is full
+        Slot* claimOverflow(const RoundInfo& info) {
+            if (m_maxOverflowRounds == 0) {
+                return nullptr;
+            }
+            if (m_overflow.size() >= m_maxOverflowRounds) {
+                uint32_t oldBlockNum = m_overflow.begin()->first.blockNum;
+                m_overflow.erase(m_overflow.begin(), m_overflow.lower_bound(RoundInfo(oldBlockNum + 1, 0)));
+            }
+            return &m_overflow[info];
+        }
+
+        std::vector<Entry> m_slots;
+        RoundInfo m_floor;
+        std::map<RoundInfo, Slot> m_overflow;
+        size_t m_maxOverflowRounds;
+    };
+
+    // true if a round after blockNum has a block id echoed by at least minVoters accounts
+    template <uint32_t PhaseWindow>
+    bool hasEchoesAhead(const RoundMsgCache<EchoCacheSlot, PhaseWindow>& cache, uint32_t blockNum, uint32_t minVoters) {
+        bool found = false;
+        cache.forEach([blockNum, minVoters, &found](const RoundInfo& info, const EchoCacheSlot& slot) {
+            if (info.blockNum > blockNum && slot.maxVoters >= minVoters) {
+                found = true;
+            }
+        });
+        return found;
+    }
+}
@@ -8,11 +8,13 @@
 #include <vector>
 
 #include <ultrainio/chain/callback.hpp>
+#include <ultrainio/chain/pending_transaction_pool.hpp>
 #include <ultrainio/chain/transaction_metadata.hpp>
 #include <ultrainio/chain/types.hpp>
 
 #include <core/Message.h>
 #include <core/types.h>
+#include <core/BlockHashCache.h>
 #include <core/BlsVoterSet.h>
 #include <boost/asio/steady_timer.hpp>
 
@@ -20,6 +22,7 @@
 #include <rpos/EvilMultiProposeDetector.h>
 #include <rpos/EvilMultiVoteDetector.h>
 #include <rpos/RoundInfo.h>
+#include <rpos/RoundMsgCache.h>
 #include <rpos/SyncTask.h>
 #include <rpos/VoterSet.h>
 
@@ -57,12 +60,15 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         bool handleMessage(const fc::sha256 &nodeId, const SyncStopMsg &msg);
 
+        // pump the streaming task of nodeId at once instead of on the next credit grant or timer tick
+        void resumeSyncTask(const fc::sha256 &nodeId);
+
         void resetEcho();
 
         void processCache(const RoundInfo& roundInfo);
 
         void produceBlock(const chain::signed_block_ptr &block, bool force_push_whole_block = false);
-        void clearTrxQueue();
+        void clearTrxQueue(const chain::signed_block& block);
 
         void init();
 
@@ -72,6 +78,8 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         const Block* getBa0Block();
 
+        const BlockIdType& getBa0BlockId();
+
         Block produceBaxBlock();
 
         bool isNeedSync();
@@ -96,6 +104,9 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         void processSyncTask();
 
+        // returns true when all the blocks of the streaming task have been sent
+        bool pumpSyncTask(SyncTask& task);
+
         template<class T>
         void clearMsgCache(T &cache, uint32_t blockNum);
 
@@ -111,12 +122,8 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         void resetTimestamp();
 
-        void clearOldCachedProposeMsg();
-
-        void clearOldCachedEchoMsg();
-
         // is invalid block
-        bool isBlank(const BlockIdType& blockId);
+        static bool isBlank(const BlockIdType& blockId);
 
         // is block without trxs
         bool isEmpty(const BlockIdType& blockId);
@@ -125,6 +132,9 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         Block emptyBlock();
 
+        // id of emptyBlock(), hashed once per block num
+        const BlockIdType& emptyBlockId();
+
         void setBa0Block(const Block& block);
 
         void insertAccount(VoterSet &info, const EchoMsg &echo);
@@ -141,12 +151,39 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         void reportMaxBaxCountStatistics(const BlockIdType& blockId, bool syncing);
 
+        // BA rules on the messages of one block, they only read the StakeVote of MsgMgr
+        static bool is2fEcho(const VoterSet& voterSet, uint32_t blockNum, uint32_t phaseCount);
+
+        static bool isMinFEcho(const VoterSet& voterSet, const BlockIdVoterSetMap& blockIdVoterSetMap);
+
+        static bool isMinPropose(const ProposeMsg& proposeMsg, const std::map<BlockIdType, ProposeMsg>& proposerMsgMap);
+
+        // the block with >= 2f + 1 echoes and the min proposer priority, BlockIdType() if not found
+        static BlockIdType findMin2fEcho(const BlockIdVoterSetMap& blockIdVoterSetMap, uint32_t blockNum, uint32_t phaseCount);
+
+        // a BA0 voter echoes the min block with f + 1 echoes once
+        static bool isResponseEcho(const VoterSet& voterSet, const BlockIdVoterSetMap& blockIdVoterSetMap,
+                                   ConsensusPhase phase, int threshold);
+
+        // f + 1 echoes of an empty block phase of blockNum are cached
+        static bool isChangePhase(const RoundMsgCache<EchoCacheSlot, 64>& cacheEchoMsgMap, uint32_t blockNum, uint32_t threshold);
+
+        // more than threshold echoes of the next phase are cached
+        static bool isFastba0(const EchoCacheSlot* echoSlot, uint32_t threshold);
+
+        // the min priority echoes of a former phase with >= 2f + 1 echoes whose block is known, empty if not found
+        static VoterSet findBax2fEcho(const std::map<RoundInfo, BlockIdVoterSetMap>& echoMsgAllPhase, uint32_t blockNum,
+                                      uint32_t phaseCount, const BlockIdType& emptyBlockId,
+                                      const std::map<BlockIdType, ProposeMsg>& proposerMsgMap);
+
     private:
         std::shared_ptr<Block> generateEmptyBlock();
 
+        const Block& currentEmptyBlock();
+
         bool updateAndMayResponse(VoterSet &info, const EchoMsg &echo, bool response);
 
-        size_t runPendingTrxs(std::list<chain::transaction_metadata_ptr> *trxs,
+        size_t runPendingTrxs(chain::pending_transaction_pool& trxs,
                               fc::time_point hard_cpu_deadline, fc::time_point block_time);
 
         size_t runScheduledTrxs(std::vector<chain::transaction_id_type> &trxs,
@@ -200,7 +237,8 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         bool is2fEcho(const VoterSet& voterSet, uint32_t phaseCount) const;
 
-        bool isMinFEcho(const VoterSet& voterSet, const BlockIdVoterSetMap& blockIdVoterSetMap) const;
+        // feeds ConsensusMetrics when the echo brings its block to 2f + 1 first in this step
+        void record2fEcho(const VoterSet& voterSet, const EchoMsg& echo, bool updated);
 
         bool isMinFEcho(const VoterSet& voterSet) const;
 
@@ -210,10 +248,14 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
 
         bool isMinPropose(const ProposeMsg& proposeMsg);
 
-        bool theSameOne(const ultrainio::chain::signed_block& lhs, const ultrainio::chain::signed_block_ptr& rhs);
+        bool isBa0Block(const ultrainio::chain::signed_block_ptr& block);
 
         // data member
         Block m_ba0Block;
+        BlockHashCache m_ba0BlockHashes;
+        // the empty block of the current block num, generated on demand
+        std::shared_ptr<Block> m_emptyBlock;
+        BlockHashCache m_emptyBlockHashes;
         BlockIdType m_ba0VerifiedBlkId = BlockIdType();
         BlockIdType m_ba0FailedBlkId = BlockIdType();
         bool m_voterPreRunBa0InProgress = false;
@@ -222,16 +264,21 @@ class Scheduler : public std::enable_shared_from_this<Scheduler> {
         std::map<chain::transaction_id_type, uint32_t>  m_blacklistTrx;
         std::map<BlockIdType, ProposeMsg> m_proposerMsgMap;
         BlockIdVoterSetMap m_echoMsgMap;
-        std::map<RoundInfo, std::vector<ProposeMsg>> m_cacheProposeMsgMap;
-        std::map<RoundInfo, std::vector<EchoMsg>> m_cacheEchoMsgMap;
-        std::map<RoundInfo, BlockIdVoterSetMap> m_echoMsgAllPhase;
+        // rounds cached outside the ring, declared before the caches they size
         const uint32_t m_maxCacheEcho = 200;
         const uint32_t m_maxCachePropose = 100;
+        // a propose is only sent in BA0, one round per block
+        RoundMsgCache<ProposeCacheSlot, 1> m_cacheProposeMsgMap;
+        // phase + baxCount of a block wraps at 64, beyond kDeadlineCnt
+        RoundMsgCache<EchoCacheSlot, 64> m_cacheEchoMsgMap;
+        std::map<RoundInfo, BlockIdVoterSetMap> m_echoMsgAllPhase;
         const uint32_t m_maxCommitteeSize = 1000; //This is not strict, just to limit cache size.
         const uint32_t m_maxCachedAllPhaseKeys = 200;
         const uint32_t m_maxSyncClients = 10;
         const uint32_t m_maxPacketsOnce = 80;
         const uint32_t m_maxSyncBlocks = 1000;
+        const uint32_t m_syncBatchBlocks = 32; // blocks read from the block log at once by a streaming task
+        const uint32_t m_maxSyncIdlePeriods = 15; // sync task periods a stalled streaming task is kept
         uint32_t m_fastTimestamp = 0;
         boost::asio::steady_timer::duration m_syncTaskPeriod{std::chrono::seconds{2}};
         std::unique_ptr<boost::asio::steady_timer> m_syncTaskTimer;
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <core/Message.h>
@@ -27,6 +28,9 @@ namespace ultrainio {
         // static function
         static std::shared_ptr<NodeInfo> getNodeInfo();
 
+        // switch the account this process votes as, the consensus simulator runs many accounts in one process
+        static void setNodeInfo(std::shared_ptr<NodeInfo> nodeInfo);
+
         static AccountName getMyAccount();
 
         static PrivateKey getMyPrivateKey();
@@ -122,9 +126,21 @@ namespace ultrainio {
 
         CommitteeInfo findInCommitteeMemberList(const AccountName& account) const;
 
+        // nullptr if the account is not in the committee
+        const CommitteeInfo* findCommitteeMember(const AccountName& account) const;
+
+        // index in cinfo, -1 if the account is not in the committee
+        int committeeIndexOf(const AccountName& account) const;
+
         uint32_t m_blockNum = 0;
 
     private:
+        void buildCommitteeIndex();
+
         static std::shared_ptr<NodeInfo> s_nodeInfo;
+
+        std::unordered_map<uint64_t, size_t> m_committeeIndex; // account name value -> index in cinfo
+
+        std::vector<PublicKey> m_committeePublicKeys; // decoded cinfo[i].pk, same order as cinfo
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 namespace ultrainio {
     struct CommitteeState;
@@ -9,7 +10,7 @@ namespace ultrainio {
     class StakeVoteFactory {
     public:
         static std::shared_ptr<StakeVoteBase> createRandom(uint32_t blockNum,
-                std::shared_ptr<CommitteeState> committeeStatePtr);
+                std::shared_ptr<CommitteeState> committeeStatePtr, const std::string& random = std::string());
         static std::shared_ptr<StakeVoteBase> createVrf(uint32_t blockNum,
                 std::shared_ptr<CommitteeState> committeeStatePtr);
     };
@@ -9,7 +9,9 @@ namespace ultrainio {
 
     class StakeVoteRandom : public StakeVoteBase {
     public:
-        StakeVoteRandom(uint32_t blockNum, std::shared_ptr<CommitteeState> committeeStatePtr);
+        // random is read from the world state when empty
+        StakeVoteRandom(uint32_t blockNum, std::shared_ptr<CommitteeState> committeeStatePtr,
+                        const std::string& random = std::string());
 
         virtual uint32_t proposerPriority(const AccountName& account, ConsensusPhase phase, int baxCount);
 
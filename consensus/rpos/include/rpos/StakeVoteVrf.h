@@ -1,5 +1,6 @@
 #pragma once
 
+#include <rpos/BinomialCdfTable.h>
 #include <rpos/StakeVoteBase.h>
 #include <rpos/Proof.h>
 
@@ -34,9 +35,7 @@ namespace ultrainio {
 
         bool isCommitteeMember(const AccountName& account) const;
 
-        int commonCalSelectedStake(const Proof& proof, int stakes, double p);
-
-        int reverseBinoCdf(double rand, int stake, double p);
+        int commonCalSelectedStake(const Proof& proof, const BinomialCdfTable& table);
 
         long getTotalStakes() const;
 
@@ -46,5 +45,7 @@ namespace ultrainio {
         std::map<int, Proof> m_phaseProofMap; // key = phase + baxCount
         double m_proposerRatio = 0.0;
         double m_voterRatio = 0.0;
+        BinomialCdfTable m_proposerTable;
+        BinomialCdfTable m_voterTable;
     };
 }
\ No newline at end of file
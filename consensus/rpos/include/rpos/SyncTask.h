@@ -10,6 +10,10 @@ namespace ultrainio {
         uint32_t startBlock;
         uint32_t endBlock;
         uint32_t seqNum;
+        // streaming task is paced by the credits granted by the receiver instead of the sync task timer
+        bool streaming = false;
+        uint32_t credits = 0;
+        uint32_t idlePeriods = 0;
 
         SyncTask(uint32_t _checkBlock, const BlsVoterSet& _bvs, const SHA256& _nodeId,
                 uint32_t _startBlock, uint32_t _endBlock, uint32_t _seqNum);
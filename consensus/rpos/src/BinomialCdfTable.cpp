@@ -0,0 +1,28 @@
+#include "rpos/BinomialCdfTable.h"
+
+#include <algorithm>
+
+#include <boost/math/distributions/binomial.hpp>
+
+namespace ultrainio {
+    BinomialCdfTable::BinomialCdfTable() {}
+
+    BinomialCdfTable::BinomialCdfTable(int trials, double p) {
+        boost::math::binomial b(trials, p);
+        for (int k = 0; k <= trials; k++) {
+            double cdf = boost::math::cdf(b, k);
+            m_cdf.push_back(cdf);
+            if (cdf >= 1.0) {
+                break;
+            }
+        }
+    }
+
+    int BinomialCdfTable::reverse(double rand) const {
+        return std::lower_bound(m_cdf.begin(), m_cdf.end(), rand) - m_cdf.begin();
+    }
+
+    size_t BinomialCdfTable::size() const {
+        return m_cdf.size();
+    }
+}
@@ -12,6 +12,11 @@ namespace ultrainio {
         m_stakeVote = StakeVoteFactory::createRandom(m_blockNum, nullptr);
     }
 
+    BlockMsgPool::BlockMsgPool(uint32_t blockNum, std::shared_ptr<CommitteeState> committeeStatePtr, const std::string& random)
+            : m_blockNum(blockNum) {
+        m_stakeVote = StakeVoteFactory::createRandom(m_blockNum, committeeStatePtr, random);
+    }
+
     std::shared_ptr<StakeVoteBase> BlockMsgPool::getStakeVote() {
         ULTRAIN_ASSERT(m_stakeVote, chain::chain_exception, "m_stakeVote is nullptr");
         return m_stakeVote;
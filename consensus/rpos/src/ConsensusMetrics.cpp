@@ -0,0 +1,79 @@
+#include <rpos/ConsensusMetrics.h>
+
+namespace ultrainio {
+    static const char* const kTimeTo2fHelp = "Time from the start of a phase to the first block with 2f + 1 echoes";
+    static const char* const kProduceBlockHelp = "Duration of Scheduler::produceBlock";
+
+    std::shared_ptr<ConsensusMetrics> ConsensusMetrics::s_self = nullptr;
+
+    std::shared_ptr<ConsensusMetrics> ConsensusMetrics::getInstance() {
+        if (!s_self) {
+            s_self = std::make_shared<ConsensusMetrics>();
+        }
+        return s_self;
+    }
+
+    ConsensusMetrics::ConsensusMetrics()
+            : m_stepStart(std::chrono::steady_clock::now()),
+              m_ba0Start(m_stepStart),
+              m_proposeArrival(LatencyRegistry::getInstance().get("ultrain_consensus_propose_arrival_us", "",
+                      "Delay from the start of BA0 to the arrival of a valid propose")),
+              m_echoVerify(LatencyRegistry::getInstance().get("ultrain_consensus_echo_verify_us", "",
+                      "Signature and voter check of an echo")),
+              m_timeTo2fBa0(LatencyRegistry::getInstance().get("ultrain_consensus_time_to_2f_us", "phase=\"ba0\"", kTimeTo2fHelp)),
+              m_timeTo2fBa1(LatencyRegistry::getInstance().get("ultrain_consensus_time_to_2f_us", "phase=\"ba1\"", kTimeTo2fHelp)),
+              m_timeTo2fBax(LatencyRegistry::getInstance().get("ultrain_consensus_time_to_2f_us", "phase=\"bax\"", kTimeTo2fHelp)),
+              m_produceBlock(LatencyRegistry::getInstance().get("ultrain_consensus_produce_block_us", "source=\"consensus\"", kProduceBlockHelp)),
+              m_produceSyncBlock(LatencyRegistry::getInstance().get("ultrain_consensus_produce_block_us", "source=\"sync\"", kProduceBlockHelp)),
+              m_pushBlock(LatencyRegistry::getInstance().get("ultrain_consensus_push_block_us", "",
+                      "Duration of controller::push_block for a block not pre-run")) {}
+
+    void ConsensusMetrics::newStep(uint32_t blockNum, ConsensusPhase phase, int baxCount) {
+        m_blockNum = blockNum;
+        m_phase = phase;
+        m_baxCount = baxCount;
+        m_stepStart = std::chrono::steady_clock::now();
+        if (phase == kPhaseBA0) {
+            m_ba0Start = m_stepStart;
+        }
+        m_reached2f = false;
+    }
+
+    void ConsensusMetrics::proposeArrived(uint32_t blockNum) {
+        if (blockNum != m_blockNum || m_phase != kPhaseBA0) {
+            return;
+        }
+        m_proposeArrival.record(elapsedUs(m_ba0Start));
+    }
+
+    bool ConsensusMetrics::reached2f() const {
+        return m_reached2f;
+    }
+
+    void ConsensusMetrics::reach2f(uint32_t blockNum, ConsensusPhase phase, int baxCount) {
+        if (m_reached2f || blockNum != m_blockNum || phase != m_phase || baxCount != m_baxCount) {
+            return;
+        }
+        m_reached2f = true;
+        uint64_t us = elapsedUs(m_stepStart);
+        if (phase == kPhaseBA0) {
+            m_timeTo2fBa0.record(us);
+        } else if (phase == kPhaseBA1) {
+            m_timeTo2fBa1.record(us);
+        } else {
+            m_timeTo2fBax.record(us);
+        }
+    }
+
+    LatencyHistogram& ConsensusMetrics::echoVerify() {
+        return m_echoVerify;
+    }
+
+    LatencyHistogram& ConsensusMetrics::produceBlock(bool sync) {
+        return sync ? m_produceSyncBlock : m_produceBlock;
+    }
+
+    LatencyHistogram& ConsensusMetrics::pushBlock() {
+        return m_pushBlock;
+    }
+}
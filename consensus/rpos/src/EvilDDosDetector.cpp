@@ -46,7 +46,7 @@ namespace ultrainio {
 
     bool EvilDDosDetector::evil(const ProposeMsg& propose, uint32_t now, uint32_t localBlockNum) const {
         if (stillEffect(now)) {
-            uint32_t blockNum = BlockHeader::num_from_id(propose.block.id());
+            uint32_t blockNum = BlockHeader::num_from_id(propose.blockId());
             return blockNum > m_maxBlockNum && blockNum > localBlockNum;
         }
         return false;
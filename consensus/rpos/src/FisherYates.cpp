@@ -10,12 +10,16 @@ namespace ultrainio {
     }
 
     std::vector<int> FisherYates::shuffle() {
+        return shuffle(m_size);
+    }
+
+    std::vector<int> FisherYates::shuffle(uint32_t count) {
         std::vector<int> v(m_size);
         for (int i = 0; i < m_size; i++) {
             v[i] = i;
         }
         fc::sha256 rand = m_rand;
-        for (int i = 0; i < m_size - 1; i++) {
+        for (int i = 0; i < m_size - 1 && i < count; i++) {
             int next = findNext(rand, m_size - i);
             next += i;
             std::swap(v[i], v[next]);
@@ -22,13 +22,13 @@ namespace ultrainio {
         // initialized at the end
         echo.signature = std::string(Signer::sign<UnsignedEchoMsg>(echo, StakeVoteBase::getMyPrivateKey()));
         ilog("account : ${account} sign block ${id} signature ${signature}",
-             ("account", std::string(StakeVoteBase::getMyAccount()))("id", short_hash(block.id()))("signature", short_sig(echo.signature)));
+             ("account", std::string(StakeVoteBase::getMyAccount()))("id", short_hash(echo.blockId))("signature", short_sig(echo.signature)));
         return echo;
     }
 
     EchoMsg MsgBuilder::constructMsg(const ProposeMsg &propose) {
         EchoMsg echo;
-        echo.blockId = propose.block.id();
+        echo.blockId = propose.blockId();
         echo.phase = Node::getInstance()->getPhase();
         echo.baxCount = Node::getInstance()->getBaxCount();
         echo.account = StakeVoteBase::getMyAccount();
@@ -39,7 +39,7 @@ namespace ultrainio {
         echo.timestamp = Node::getInstance()->getRoundCount();
         echo.signature = std::string(Signer::sign<UnsignedEchoMsg>(echo, StakeVoteBase::getMyPrivateKey()));
         ilog("account : ${account} sign block ${id} signature ${signature}",
-             ("account", std::string(StakeVoteBase::getMyAccount()))("id", short_hash(propose.block.id()))("signature", short_sig(echo.signature)));
+             ("account", std::string(StakeVoteBase::getMyAccount()))("id", short_hash(propose.blockId()))("signature", short_sig(echo.signature)));
         return echo;
     }
 
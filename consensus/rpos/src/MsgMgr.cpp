@@ -3,6 +3,7 @@
 #include <ultrainio/chain/exceptions.hpp>
 
 #include <rpos/Config.h>
+#include <rpos/ConsensusMetrics.h>
 #include <rpos/Node.h>
 #include <rpos/Seed.h>
 #include <rpos/StakeVoteBase.h>
@@ -30,13 +31,16 @@ namespace ultrainio {
         }
         std::shared_ptr<StakeVoteBase> stakeVotePtr = getStakeVote(blockNum);
         stakeVotePtr->moveToNewStep(blockNum, phase, baxCount);
+        ConsensusMetrics::getInstance()->newStep(blockNum, phase, baxCount);
     }
 
     BlockMsgPoolPtr MsgMgr::getBlockMsgPool(uint32_t blockNum) {
         ULTRAIN_ASSERT(blockNum > 1, chain::chain_exception, "blockNum should > 1");
         auto itor = m_blockMsgPoolMap.find(blockNum);
         if (itor == m_blockMsgPoolMap.end()) {
-            BlockMsgPoolPtr blockMsgPoolPtr = std::make_shared<BlockMsgPool>(blockNum);
+            BlockMsgPoolPtr blockMsgPoolPtr = m_committeeStatePtr
+                    ? std::make_shared<BlockMsgPool>(blockNum, m_committeeStatePtr, m_random)
+                    : std::make_shared<BlockMsgPool>(blockNum);
             m_blockMsgPoolMap.insert(make_pair(blockNum, blockMsgPoolPtr));
             return blockMsgPoolPtr;
         }
@@ -46,13 +50,18 @@ namespace ultrainio {
     bool MsgMgr::isVoter(uint32_t blockNum, ConsensusPhase phase, int baxCount) {
         std::shared_ptr<StakeVoteBase> stakeVotePtr = getStakeVote(blockNum);
         ULTRAIN_ASSERT(stakeVotePtr != nullptr, chain::chain_exception, "not init StakeVote");
-        return stakeVotePtr->isVoter(StakeVoteBase::getMyAccount(), phase, baxCount, Node::getInstance()->getNonProducingNode());
+        return stakeVotePtr->isVoter(StakeVoteBase::getMyAccount(), phase, baxCount, isNonProducingNode());
     }
 
     bool MsgMgr::isProposer(uint32_t blockNum) {
         std::shared_ptr<StakeVoteBase> stakeVotePtr = getStakeVote(blockNum);
         ULTRAIN_ASSERT(stakeVotePtr != nullptr, chain::chain_exception, "not init StakeVote");
-        return stakeVotePtr->isProposer(StakeVoteBase::getMyAccount(), Node::getInstance()->getNonProducingNode());
+        return stakeVotePtr->isProposer(StakeVoteBase::getMyAccount(), isNonProducingNode());
+    }
+
+    bool MsgMgr::isNonProducingNode() const {
+        // no Node in the consensus simulator
+        return Node::getInstance() && Node::getInstance()->getNonProducingNode();
     }
 
     void MsgMgr::clearSomeBlockMessage(uint32_t blockNum) {
@@ -66,6 +75,12 @@ namespace ultrainio {
         }
     }
 
+    void MsgMgr::setCommitteeState(std::shared_ptr<CommitteeState> committeeStatePtr, const std::string& random) {
+        m_committeeStatePtr = committeeStatePtr;
+        m_random = random;
+        m_blockMsgPoolMap.clear();
+    }
+
     std::shared_ptr<StakeVoteBase> MsgMgr::getStakeVote(uint32_t blockNum) {
         BlockMsgPoolPtr blockMsgPoolPtr = getBlockMsgPool(blockNum);
         return blockMsgPoolPtr->getStakeVote();
@@ -63,6 +63,20 @@ namespace ultrainio {
         }
     }
 
+    bool send_packed_sync_block(const fc::sha256 &nodeId, uint32_t seqNum, const std::vector<char> &packedBlock, const std::string &proof) {
+        set_sync_using_net_plugin();
+        if (sync_using_net_plugin == 1) {
+            return app().get_plugin<net_plugin>().send_block(nodeId, seqNum, packedBlock, proof);
+        } else {
+            SyncBlockMsg msg;
+            msg.seqNum = seqNum;
+            msg.block = fc::raw::unpack<Block>(packedBlock);
+            msg.proof = proof;
+            app().get_plugin<kcp_plugin>().send_block(nodeId, msg);
+            return true;
+        }
+    }
+
     bool send_req_sync_msg(const ReqSyncMsg &msg) {
         set_sync_using_net_plugin();
         if (sync_using_net_plugin == 1) {
@@ -304,7 +318,7 @@ namespace ultrainio {
         }
         //monitor end
         m_schedulerPtr->setBa0Block(ba0Block);
-        if ((!isBlank(ba0Block.id()))
+        if ((!isBlank(m_schedulerPtr->getBa0BlockId()))
             && (ba0Block.previous != m_schedulerPtr->getPreviousBlockhash())) {
             elog("ba0Process error. previous block hash error. hash = ${hash1} local hash = ${hash2}",
                  ("hash1", ba0Block.previous)("hash2", m_schedulerPtr->getPreviousBlockhash()));
@@ -361,7 +375,7 @@ namespace ultrainio {
 
         if (MsgMgr::getInstance()->isVoter(blockNum, phase, baxCount)) {
             const Block* ba0Block = m_schedulerPtr->getBa0Block();
-            if (isEmpty(ba0Block->id())) {
+            if (isEmpty(m_schedulerPtr->getBa0BlockId())) {
                 elog("vote ba0Block is empty, and send echo for empty block");
                 sendEchoForEmptyBlock();
             } else if (m_schedulerPtr->verifyBa0Block()) { // not empty, verify
@@ -437,8 +451,7 @@ namespace ultrainio {
         }
 
         //fast into baxcount 20
-        if ((m_baxCount < (Config::kMaxBaxCount - m_phase))
-            && (m_schedulerPtr->isChangePhase())) {
+        if (isSkipToEmptyBlockPhase(m_phase, m_baxCount, m_schedulerPtr->isChangePhase())) {
             m_baxCount = Config::kMaxBaxCount - m_phase - 1;
             dlog("baxProcess.ChangePhase to baxcount[20]. blockNum = ${id}, m_baxCount = ${phase}", ("id", getBlockNum())("phase", m_baxCount));
             baxLoop(getLeftTime());
@@ -575,7 +588,7 @@ namespace ultrainio {
              ("Voter", MsgMgr::getInstance()->isVoter(getBlockNum(), kPhaseBAX, m_baxCount))
                      ("count",m_baxCount));
 
-        if ((m_baxCount + m_phase) >= Config::kMaxBaxCount) {
+        if (isEmptyBlockPhase(m_phase + m_baxCount)) {
             if (MsgMgr::getInstance()->isVoter(getBlockNum(), kPhaseBAX, m_baxCount)) {
                 sendEchoForEmptyBlock();
             }
@@ -664,6 +677,10 @@ namespace ultrainio {
         return true;
     }
 
+    void Node::syncWritable(const fc::sha256 &nodeId) {
+        m_schedulerPtr->resumeSyncTask(nodeId);
+    }
+
     void Node::cancelTimer() {
         m_timer.cancel();
         setTimerCanceled(m_currentTimerHandlerNo);
@@ -691,6 +708,10 @@ namespace ultrainio {
         send_sync_block(nodeId, msg);
     }
 
+    bool Node::sendPackedBlock(const fc::sha256 &nodeId, uint32_t seqNum, const std::vector<char> &packedBlock, const std::string &proof) {
+        return send_packed_sync_block(nodeId, seqNum, packedBlock, proof);
+    }
+
     bool Node::sendMessage(const ReqSyncMsg &msg) {
         return send_req_sync_msg(msg);
     }
@@ -739,8 +760,8 @@ namespace ultrainio {
 
         vote(getBlockNum(), kPhaseBA0, 0);
 
-        if ((getLeftTime() > (Config::s_maxTrxMicroSeconds/1000 + 300)) && (!MsgMgr::getInstance()->isProposer(getBlockNum()))) {
-            fastLoop(Config::s_maxTrxMicroSeconds/1000 + 300);
+        if (isFastLoop(getLeftTime(), isProposer)) {
+            fastLoop(getFastLoopTime());
         } else {
             ba0Loop(getLeftTime());
         }
@@ -815,8 +836,7 @@ namespace ultrainio {
         m_schedulerPtr->resetEcho();
 
         //fast into baxcount 20
-        if ((m_baxCount < (Config::kMaxBaxCount - m_phase))
-            && (m_schedulerPtr->isChangePhase())) {
+        if (isSkipToEmptyBlockPhase(m_phase, m_baxCount, m_schedulerPtr->isChangePhase())) {
             m_baxCount = Config::kMaxBaxCount - m_phase;
             dlog("fastBax.ChangePhase to baxcount[20]. blockNum = ${id}, m_baxCount = ${phase}", ("id", getBlockNum())("phase", m_baxCount));
         }
@@ -891,20 +911,42 @@ namespace ultrainio {
     }
 
     uint32_t Node::getRoundCount() {
-        fc::time_point currentTime = fc::time_point::now();
-        int64_t passTimeFromGenesis = (currentTime - Genesis::s_time).to_seconds();
+        return getRoundCount(fc::time_point::now());
+    }
+
+    uint32_t Node::getRoundCount(const fc::time_point& now) {
+        int64_t passTimeFromGenesis = (now - Genesis::s_time).to_seconds();
         return passTimeFromGenesis / Config::s_maxPhaseSeconds;
     }
 
     uint32_t Node::getLeftTime() {
-        fc::time_point currentTime = fc::time_point::now();
-        int64_t passTimeFromGenesis = (currentTime - Genesis::s_time).to_seconds() * 1000;
+        return getLeftTime(fc::time_point::now());
+    }
+
+    uint32_t Node::getLeftTime(const fc::time_point& now) {
+        int64_t passTimeFromGenesis = (now - Genesis::s_time).to_seconds() * 1000;
 
         uint32_t round = 1000 * Config::s_maxPhaseSeconds - (passTimeFromGenesis % (1000 * Config::s_maxPhaseSeconds));
         dlog("interval = ${id}", ("id", round));
         return round;
     }
 
+    uint32_t Node::getFastLoopTime() {
+        return Config::s_maxTrxMicroSeconds / 1000 + 300;
+    }
+
+    bool Node::isFastLoop(uint32_t leftTime, bool isProposer) {
+        return leftTime > getFastLoopTime() && !isProposer;
+    }
+
+    bool Node::isEmptyBlockPhase(uint32_t phaseCount) {
+        return phaseCount >= Config::kMaxBaxCount;
+    }
+
+    bool Node::isSkipToEmptyBlockPhase(ConsensusPhase phase, uint32_t baxCount, bool changePhase) {
+        return (baxCount < (Config::kMaxBaxCount - phase)) && changePhase;
+    }
+
     BlockIdType Node::getPreviousHash() {
         return m_schedulerPtr->getPreviousBlockhash();
     }
@@ -923,7 +965,7 @@ namespace ultrainio {
 
     void Node::sendEchoForEmptyBlock() {
         Block block = m_schedulerPtr->emptyBlock();
-        dlog("vote empty block. blockNum = ${blockNum} hash = ${hash}", ("blockNum",getBlockNum())("hash", short_hash(block.id())));
+        dlog("vote empty block. blockNum = ${blockNum} hash = ${hash}", ("blockNum",getBlockNum())("hash", short_hash(m_schedulerPtr->emptyBlockId())));
         EchoMsg echoMsg = MsgBuilder::constructMsg(block);
         ULTRAIN_ASSERT(m_schedulerPtr->verifyMyBlsSignature(echoMsg), chain::chain_exception, "bls signature error, check bls private key pls");
         m_schedulerPtr->insert(echoMsg);
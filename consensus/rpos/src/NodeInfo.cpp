@@ -33,7 +33,7 @@ namespace ultrainio {
                     chain::chain_exception,
                     "genesis key pair invalid");
         }
-        if (Node::getInstance()->getNonProducingNode()) {
+        if (Node::getInstance() && Node::getInstance()->getNonProducingNode()) {
             ilog("Non Producer Node");
             return;
         }
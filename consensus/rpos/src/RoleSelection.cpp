@@ -7,29 +7,35 @@
 #include <rpos/RoleRandom.h>
 
 namespace ultrainio {
-    RoleSelection::RoleSelection(const std::vector<std::string>& committeeV, const RoleRandom& rand) {
+    RoleSelection::RoleSelection(const std::vector<std::string>& committeeV, const RoleRandom& rand)
+            : m_voterBits(committeeV.size(), false) {
         ULTRAIN_ASSERT(committeeV.size() > 0, chain::chain_exception, "committee size");
         FisherYates fys(rand.getRand(), committeeV.size());
-        std::vector<int> c = fys.shuffle();
+        // only the voters are needed, so the committee is shuffled partially
+        std::vector<int> c = fys.shuffle(Config::kDesiredVoterNumber);
+        m_voterSet.reserve(std::min<size_t>(committeeV.size(), Config::kDesiredVoterNumber));
         for (int i = 0; i < committeeV.size() && i < Config::kDesiredVoterNumber; i++) {
             int index = c[i];
             if (i < Config::kDesiredProposerNumber && rand.getPhase() == kPhaseBA0 && rand.getBaxCount() == 0) {
+                m_proposerIndexV.push_back(index);
                 m_proposerV.push_back(committeeV[index]);
                 ilog("proposer[${i}] = ${proposer}", ("i", i)("proposer", committeeV[index]));
             }
-            m_voterV.push_back(committeeV[index]);
+            m_voterBits[index] = true;
+            m_voterSet.insert(committeeV[index]);
+            m_voterNumber++;
         }
     }
 
-    bool RoleSelection::isProposer(const std::string& account) {
+    bool RoleSelection::isProposer(const std::string& account) const {
         return std::find(m_proposerV.begin(), m_proposerV.end(), account) != m_proposerV.end();
     }
 
-    bool RoleSelection::isVoter(const std::string& account) {
-        return std::find(m_voterV.begin(), m_voterV.end(), account) != m_voterV.end();
+    bool RoleSelection::isVoter(const std::string& account) const {
+        return m_voterSet.find(account) != m_voterSet.end();
     }
 
-    uint32_t RoleSelection::proposerPriority(const std::string& account) {
+    uint32_t RoleSelection::proposerPriority(const std::string& account) const {
         for (uint32_t i = 0; i < m_proposerV.size(); i++) {
             if (account == m_proposerV[i]) {
                 return i;
@@ -38,11 +44,28 @@ namespace ultrainio {
         return m_proposerV.size();
     }
 
+    bool RoleSelection::isProposer(int index) const {
+        return std::find(m_proposerIndexV.begin(), m_proposerIndexV.end(), index) != m_proposerIndexV.end();
+    }
+
+    bool RoleSelection::isVoter(int index) const {
+        return index >= 0 && index < m_voterBits.size() && m_voterBits[index];
+    }
+
+    uint32_t RoleSelection::proposerPriority(int index) const {
+        for (uint32_t i = 0; i < m_proposerIndexV.size(); i++) {
+            if (index == m_proposerIndexV[i]) {
+                return i;
+            }
+        }
+        return m_proposerIndexV.size();
+    }
+
     uint32_t RoleSelection::proposerNumber() const {
         return m_proposerV.size();
     }
 
     int RoleSelection::voterNumber() const {
-        return m_voterV.size();
+        return m_voterNumber;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,56 @@
+#include <rpos/RoundMsgCache.h>
+
+namespace ultrainio {
+    // ProposeCacheSlot
+    void ProposeCacheSlot::add(const ProposeMsg& propose) {
+        msgs.push_back(propose);
+    }
+
+    bool ProposeCacheSlot::contains(const BlockIdType& blockId) const {
+        for (const auto& e : msgs) {
+            if (e.blockId() == blockId) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ProposeCacheSlot::clear() {
+        msgs.clear();
+    }
+
+    // EchoCacheSlot
+    void EchoCacheSlot::add(const EchoMsg& echo) {
+        msgs.push_back(echo);
+        accountEchoes[echo.account]++;
+        std::set<AccountName>& v = voters[echo.blockId];
+        v.insert(echo.account);
+        if (v.size() > maxVoters) {
+            maxVoters = v.size();
+        }
+    }
+
+    bool EchoCacheSlot::contains(const EchoMsg& echo) const {
+        if (echoesOf(echo.account) == 0) {
+            return false;
+        }
+        for (const auto& e : msgs) {
+            if (e == echo) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t EchoCacheSlot::echoesOf(const AccountName& account) const {
+        auto itor = accountEchoes.find(account);
+        return itor == accountEchoes.end() ? 0 : itor->second;
+    }
+
+    void EchoCacheSlot::clear() {
+        msgs.clear();
+        accountEchoes.clear();
+        voters.clear();
+        maxVoters = 0;
+    }
+}
@@ -33,6 +33,7 @@
 #include <lightclient/LightClientProducer.h>
 #include <lightclient/LightClientMgr.h>
 #include <rpos/Config.h>
+#include <rpos/ConsensusMetrics.h>
 #include <rpos/EvilBlsDetector.h>
 #include <rpos/Genesis.h>
 #include <rpos/MsgBuilder.h>
@@ -55,7 +56,7 @@ namespace ultrainio {
     Scheduler::~Scheduler() {}
 
     Scheduler::Scheduler() : m_ba0Block(), m_proposerMsgMap(), m_echoMsgMap(),
-                                           m_cacheProposeMsgMap(), m_cacheEchoMsgMap(),
+                                           m_cacheProposeMsgMap(m_maxCachePropose), m_cacheEchoMsgMap(m_maxCacheEcho),
                                            m_echoMsgAllPhase() {
         m_syncTaskTimer.reset(new boost::asio::steady_timer(app().get_io_service()));
         m_memleakCheck.reset(new boost::asio::steady_timer(app().get_io_service()));
@@ -91,15 +92,15 @@ namespace ultrainio {
 
                 int s4 = m_cacheProposeMsgMap.size();
                 int s5 = 0;
-                for(const auto& it: m_cacheProposeMsgMap) {
-                    s5 += it.second.size();
-                }
+                m_cacheProposeMsgMap.forEach([&s5](const RoundInfo&, const ProposeCacheSlot& slot) {
+                    s5 += slot.msgs.size();
+                });
 
                 int s6 = m_cacheEchoMsgMap.size();
                 int s7 = 0;
-                for(const auto& it: m_cacheEchoMsgMap) {
-                    s7 += it.second.size();
-                }
+                m_cacheEchoMsgMap.forEach([&s7](const RoundInfo&, const EchoCacheSlot& slot) {
+                    s7 += slot.msgs.size();
+                });
 
                 int s8 = m_echoMsgAllPhase.size();
                 int s9 = 0;
@@ -130,13 +131,14 @@ namespace ultrainio {
     void Scheduler::reset() {
         uint32_t blockNum = getLastBlocknum();
         m_ba0Block = Block();
+        m_ba0BlockHashes.reset();
         m_ba0VerifiedBlkId = BlockIdType();
         m_ba0FailedBlkId = BlockIdType();
         clearPreRunStatus();
         m_proposerMsgMap.clear();
         m_echoMsgMap.clear();
-        clearMsgCache(m_cacheProposeMsgMap, blockNum);
-        clearMsgCache(m_cacheEchoMsgMap, blockNum);
+        m_cacheProposeMsgMap.expireBefore(RoundInfo(blockNum + 1, 0));
+        m_cacheEchoMsgMap.expireBefore(RoundInfo(blockNum + 1, 0));
         clearMsgCache(m_echoMsgAllPhase, blockNum);
     }
 
@@ -168,8 +170,8 @@ namespace ultrainio {
     }
 
     bool Scheduler::insert(const ProposeMsg &propose) {
-        dlog("insert.save propose msg.blockhash = ${blockhash}", ("blockhash", short_hash(propose.block.id())));
-        m_proposerMsgMap.insert(make_pair(propose.block.id(), propose));
+        dlog("insert.save propose msg.blockhash = ${blockhash}", ("blockhash", short_hash(propose.blockId())));
+        m_proposerMsgMap.insert(make_pair(propose.blockId(), propose));
         return true;
     }
 
@@ -202,36 +204,22 @@ namespace ultrainio {
 
     bool Scheduler::processLaterMsg(const EchoMsg& echo) {
         RoundInfo info(BlockHeader::num_from_id(echo.blockId), echo.phase + echo.baxCount);
-        auto itor = m_cacheEchoMsgMap.find(info);
-        if (itor == m_cacheEchoMsgMap.end()) {
-            if (m_cacheEchoMsgMap.size() >= m_maxCacheEcho) {
-                //NOTE: itor will be invalid after the operation below.
-                clearOldCachedEchoMsg();
-            }
-            std::vector<EchoMsg> echoV;
-            echoV.push_back(echo);
-            m_cacheEchoMsgMap.insert(make_pair(info, echoV));
+        EchoCacheSlot* slot = m_cacheEchoMsgMap.findOrClaim(info);
+        if (!slot) {
+            dlog("echo of blockNum : ${n} phase : ${p} is before the cached rounds", ("n", info.blockNum)("p", info.phase));
+            return true;
+        }
+        if (slot->msgs.size() < m_maxCommitteeSize) {
+            slot->add(echo);
         } else {
-            if (itor->second.size() < m_maxCommitteeSize) {
-                itor->second.emplace_back(echo);
-            } else {
-                ilog("Size of vector in m_cacheEchoMsgMap exceeds ${mcs}", ("mcs", m_maxCommitteeSize));
-            }
+            ilog("Size of vector in m_cacheEchoMsgMap exceeds ${mcs}", ("mcs", m_maxCommitteeSize));
         }
         return true;
     }
 
     bool Scheduler::duplicated(const EchoMsg& echo) const {
-        RoundInfo info(echo.blockNum(), echo.phase + echo.baxCount);
-        auto itor = m_cacheEchoMsgMap.find(info);
-        if (itor != m_cacheEchoMsgMap.end()) {
-            for (auto e : itor->second) {
-                if (e == echo) {
-                    return true;
-                }
-            }
-        }
-        return false;
+        const EchoCacheSlot* slot = m_cacheEchoMsgMap.find(RoundInfo(echo.blockNum(), echo.phase + echo.baxCount));
+        return slot && slot->contains(echo);
     }
 
     bool Scheduler::satisfyVoteRules(const EchoMsg& echo) const {
@@ -239,15 +227,9 @@ namespace ultrainio {
          * 1. In BA0, Voter can vote multi propose, but not great the number of proposer
          * 2. In the other, voter can vote one
          */
-        RoundInfo info(echo.blockNum(), echo.phase + echo.baxCount);
-        auto itor = m_cacheEchoMsgMap.find(info);
-        if (itor != m_cacheEchoMsgMap.end()) {
-            int existCount = 0;
-            for (auto e : itor->second) {
-                if (e.account == echo.account) {
-                    existCount++;
-                }
-            }
+        const EchoCacheSlot* slot = m_cacheEchoMsgMap.find(RoundInfo(echo.blockNum(), echo.phase + echo.baxCount));
+        if (slot) {
+            int existCount = slot->echoesOf(echo.account);
             if ((echo.phase == kPhaseBA0 && existCount >= Config::kDesiredProposerNumber) || (echo.phase != kPhaseBA0 && existCount >= 1)) {
                 return false;
             }
@@ -256,36 +238,21 @@ namespace ultrainio {
     }
 
     bool Scheduler::duplicated(const ProposeMsg& propose) const {
-        RoundInfo info(propose.block.block_num(), kPhaseBA0);
-        auto itor = m_cacheProposeMsgMap.find(info);
-        if (itor != m_cacheProposeMsgMap.end()) {
-            for (auto e : itor->second) {
-                if (e.block.id() == propose.block.id()) {
-                    return true;
-                }
-            }
-        }
-        return false;
+        const ProposeCacheSlot* slot = m_cacheProposeMsgMap.find(RoundInfo(propose.block.block_num(), kPhaseBA0));
+        return slot && slot->contains(propose.blockId());
     }
 
     bool Scheduler::processLaterMsg(const ProposeMsg& propose) {
         RoundInfo info(propose.block.block_num(), kPhaseBA0);
-        auto itor = m_cacheProposeMsgMap.find(info);
-        if (itor == m_cacheProposeMsgMap.end()) {
-            if (m_cacheProposeMsgMap.size() >= m_maxCachePropose) {
-                //NOTE: itor will be invalid after the operation below.
-                clearOldCachedProposeMsg();
-            }
-            std::vector<ProposeMsg> proposeV;
-            proposeV.push_back(propose);
-            m_cacheProposeMsgMap.insert(make_pair(info, proposeV));
+        ProposeCacheSlot* slot = m_cacheProposeMsgMap.findOrClaim(info);
+        if (!slot) {
+            dlog("propose of blockNum : ${n} is before the cached rounds", ("n", info.blockNum));
+            return true;
+        }
+        if (slot->msgs.size() < m_maxCommitteeSize) {
+            slot->add(propose);
         } else {
-            if (itor->second.size() < m_maxCommitteeSize) {
-                itor->second.emplace_back(propose);
-            }
-            else {
-                wlog("Size of vector in cacheProposeMsgMap exceeds ${mcs}", ("mcs", m_maxCommitteeSize));
-            }
+            wlog("Size of vector in cacheProposeMsgMap exceeds ${mcs}", ("mcs", m_maxCommitteeSize));
         }
         return true;
     }
@@ -369,8 +336,8 @@ namespace ultrainio {
             voterSet.sigPool.push_back(echo.signature);
             voterSet.timePool.push_back(echo.timestamp);
             std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(blockNum);
-            if (response && voterSet.getTotalVoterWeight() >= stakeVotePtr->getSendEchoThreshold() && !voterSet.hasSend
-                && Node::getInstance()->getPhase() == kPhaseBA0 && isMinFEcho(voterSet)) {
+            if (response && isResponseEcho(voterSet, m_echoMsgMap, Node::getInstance()->getPhase(),
+                                           stakeVotePtr->getSendEchoThreshold())) {
                 if (MsgMgr::getInstance()->isVoter(Node::getInstance()->getBlockNum(), echo.phase,
                                                            echo.baxCount)) {
                     ilog("send echo when > f + 1");
@@ -396,34 +363,7 @@ namespace ultrainio {
             return false;
         }
 
-        uint32_t maxBlockNum = Node::getInstance()->getBlockNum();
-
-        for (auto vector_itor = m_cacheEchoMsgMap.begin(); vector_itor != m_cacheEchoMsgMap.end(); ++vector_itor) {
-            if (vector_itor->first.blockNum > maxBlockNum) {
-                BlockIdVoterSetMap echo_msg_map;
-
-                for (auto &echo : vector_itor->second) {
-                    auto itor = echo_msg_map.find(echo.blockId);
-                    if (itor != echo_msg_map.end()) {
-                        insertAccount(itor->second, echo);
-                    } else {
-                        VoterSet voterSet;
-                        voterSet.commonEchoMsg = echo;
-                        insertAccount(voterSet, echo);
-                        echo_msg_map.insert(make_pair(echo.blockId, voterSet));
-                    }
-                }
-
-                for (auto echo_itor = echo_msg_map.begin(); echo_itor != echo_msg_map.end(); ++echo_itor) {
-                    if (echo_itor->second.accountPool.size() >= THRESHOLD_SYNCING) {
-                        maxBlockNum = vector_itor->first.blockNum;
-                        return true;
-                    }
-                }
-            }
-        }
-
-        return false;
+        return hasEchoesAhead(m_cacheEchoMsgMap, Node::getInstance()->getBlockNum(), THRESHOLD_SYNCING);
     }
 
     bool Scheduler::isChangePhase() {
@@ -431,35 +371,23 @@ namespace ultrainio {
             return false;
         }
 
-        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(Node::getInstance()->getBlockNum());
-        for (auto vector_itor = m_cacheEchoMsgMap.begin(); vector_itor != m_cacheEchoMsgMap.end(); ++vector_itor) {
-            if ((vector_itor->first.blockNum == Node::getInstance()->getBlockNum())
-                && (vector_itor->first.phase >= Config::kMaxBaxCount)) {
-                BlockIdVoterSetMap echo_msg_map;
-                for (auto &echo : vector_itor->second) {
-                    auto itor = echo_msg_map.find(echo.blockId);
-                    if (itor != echo_msg_map.end()) {
-                        updateAndMayResponse(itor->second, echo, false);
-                    } else {
-                        VoterSet voterSet;
-                        voterSet.commonEchoMsg = echo;
-                        updateAndMayResponse(voterSet, echo, false);
-                        echo_msg_map.insert(make_pair(echo.blockId, voterSet));
-                    }
-                }
+        uint32_t blockNum = Node::getInstance()->getBlockNum();
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(blockNum);
+        return isChangePhase(m_cacheEchoMsgMap, blockNum, stakeVotePtr->getSendEchoThreshold());
+    }
 
-                for (auto echo_itor = echo_msg_map.begin(); echo_itor != echo_msg_map.end(); ++echo_itor) {
-                    if (echo_itor->second.getTotalVoterWeight() >= stakeVotePtr->getSendEchoThreshold()) {
-                        return true;
-                    }
-                }
+    bool Scheduler::isChangePhase(const RoundMsgCache<EchoCacheSlot, 64>& cacheEchoMsgMap, uint32_t blockNum, uint32_t threshold) {
+        bool changePhase = false;
+        cacheEchoMsgMap.forEach([blockNum, threshold, &changePhase](const RoundInfo& info, const EchoCacheSlot& slot) {
+            if (info.blockNum == blockNum && Node::isEmptyBlockPhase(info.phase) && slot.maxVoters >= threshold) {
+                changePhase = true;
             }
-        }
-
-        return false;
+        });
+        return changePhase;
     }
 
     bool Scheduler::isValid(const EchoMsg &echo) const {
+        ScopedLatency latency(ConsensusMetrics::getInstance()->echoVerify());
         uint32_t blockNum = BlockHeader::num_from_id(echo.blockId);
         std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(blockNum);
         PublicKey publicKey = stakeVotePtr->getPublicKey(echo.account);
@@ -492,13 +420,13 @@ namespace ultrainio {
     bool Scheduler::isValid(const ProposeMsg& propose) const {
         if (propose.block.previous != getPreviousBlockhash()) {
             elog("block ${blockId} 's previous hash ${previous} not equal current head : ${head}",
-                    ("blockId", propose.block.id())("previous", propose.block.previous)("head", getPreviousBlockhash()));
+                    ("blockId", propose.blockId())("previous", propose.block.previous)("head", getPreviousBlockhash()));
             return false;
         }
 
         std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(propose.block.block_num());
         PublicKey publicKey = stakeVotePtr->getPublicKey(propose.block.proposer);
-        if (!Validator::verify<BlockHeader>(Signature(propose.block.signature), propose.block, publicKey)) {
+        if (!Validator::verifyDigest(Signature(propose.block.signature), propose.blockDigest(), publicKey)) {
             elog("validator proposer error. proposer : ${proposer}", ("proposer", std::string(propose.block.proposer)));
             return false;
         }
@@ -543,6 +471,7 @@ namespace ultrainio {
             if (!isValid(propose)) {
                 return false;
             }
+            ConsensusMetrics::getInstance()->proposeArrived(propose.block.block_num());
 
             std::shared_ptr<PunishMgr> punishMgrPtr = PunishMgr::getInstance();
             if (punishMgrPtr->isPunished(propose.block.proposer)) {
@@ -554,16 +483,16 @@ namespace ultrainio {
             if (m_evilMultiProposeDetector.hasMultiPropose(m_proposerMsgMap, propose, evidence)) {
                 ilog("${account} sign multiple propose message", ("account", std::string(evidence.getEvilAccount())));
                 EvilDesc evilDesc(appbase::app().get_plugin<chain_plugin>().get_chain_name(), evidence.getEvilAccount(),
-                                  BlockHeader::num_from_id(propose.block.id()));
+                                  BlockHeader::num_from_id(propose.blockId()));
                 NativeTrx::reportEvil(evilDesc, evidence);
                 punishMgrPtr->punish(evidence.getEvilAccount(), Evidence::kMultiPropose);
                 return false;
             }
 
-            auto itor = m_proposerMsgMap.find(propose.block.id());
+            auto itor = m_proposerMsgMap.find(propose.blockId());
             if (itor == m_proposerMsgMap.end()) {
                 if (isMinPropose(propose)) {
-                    m_proposerMsgMap.insert(make_pair(propose.block.id(), propose));
+                    m_proposerMsgMap.insert(make_pair(propose.blockId(), propose));
                     return true;
                 }
             }
@@ -632,7 +561,7 @@ namespace ultrainio {
                 if (m_evilDDosDetector.evil(propose, Node::getInstance()->getRoundCount(),
                                             Node::getInstance()->getBlockNum())) {
                     elog("evil propose id : ${id} : blockNum : ${blockNum} local : ${local}",
-                         ("id", propose.block.id())("blockNum", propose.block.block_num())("local",
+                         ("id", propose.blockId())("blockNum", propose.block.block_num())("local",
                                                                                            Node::getInstance()->getBlockNum()));
                     return false;
                 }
@@ -647,7 +576,7 @@ namespace ultrainio {
                          ("p", std::string(propose.block.proposer))("num", Node::getInstance()->getBlockNum()));
                     return false;
                 }
-                if (!Validator::verify<BlockHeader>(Signature(propose.block.signature), propose.block, publicKey)) {
+                if (!Validator::verifyDigest(Signature(propose.block.signature), propose.blockDigest(), publicKey)) {
                     elog("validator proposer error. proposer : ${p} at block ${num} sig : ${sig}",
                          ("p", std::string(propose.block.proposer))("num", Node::getInstance()->getBlockNum())("sig",
                                                                                                                short_sig(
@@ -662,10 +591,11 @@ namespace ultrainio {
             if (!isValid(propose)) {
                 return false;
             }
+            ConsensusMetrics::getInstance()->proposeArrived(propose.block.block_num());
 
             if (Node::getInstance()->isSyncing()) {
                 dlog("receive propose msg. node is syncing. blockhash = ${blockhash}",
-                     ("blockhash", short_hash(propose.block.id())));
+                     ("blockhash", short_hash(propose.blockId())));
                 return true;
             }
 
@@ -679,14 +609,14 @@ namespace ultrainio {
             if (m_evilMultiProposeDetector.hasMultiPropose(m_proposerMsgMap, propose, evidence)) {
                 ilog("${account} sign multiple propose message", ("account", std::string(propose.block.proposer)));
                 EvilDesc evilDesc(appbase::app().get_plugin<chain_plugin>().get_chain_name(), evidence.getEvilAccount(),
-                                  BlockHeader::num_from_id(propose.block.id()));
+                                  BlockHeader::num_from_id(propose.blockId()));
                 NativeTrx::reportEvil(evilDesc, evidence);
                 punishMgrPtr->punish(evidence.getEvilAccount(), Evidence::kMultiPropose);
                 return false;
             }
 
-            dlog("receive propose msg.blockhash = ${blockhash}", ("blockhash", short_hash(propose.block.id())));
-            auto itor = m_proposerMsgMap.find(propose.block.id());
+            dlog("receive propose msg.blockhash = ${blockhash}", ("blockhash", short_hash(propose.blockId())));
+            auto itor = m_proposerMsgMap.find(propose.blockId());
             if (itor == m_proposerMsgMap.end()) {
                 if (isMinPropose(propose)) {
                     if (MsgMgr::getInstance()->isVoter(propose.block.block_num(), kPhaseBA0, 0)) {
@@ -696,8 +626,8 @@ namespace ultrainio {
                         Node::getInstance()->sendMessage(echo);
                         insert(echo);
                     }
-                    dlog("save propose msg.blockhash = ${blockhash}", ("blockhash", short_hash(propose.block.id())));
-                    m_proposerMsgMap.insert(make_pair(propose.block.id(), propose));
+                    dlog("save propose msg.blockhash = ${blockhash}", ("blockhash", short_hash(propose.blockId())));
+                    m_proposerMsgMap.insert(make_pair(propose.blockId(), propose));
                     return true;
                 }
             }
@@ -752,7 +682,12 @@ namespace ultrainio {
                          ("account", std::string(echo.account))("num", Node::getInstance()->getBlockNum()));
                     return false;
                 }
-                if (!Validator::verify<UnsignedEchoMsg>(Signature(echo.signature), echo, publicKey)) {
+                bool verified = false;
+                {
+                    ScopedLatency latency(ConsensusMetrics::getInstance()->echoVerify());
+                    verified = Validator::verify<UnsignedEchoMsg>(Signature(echo.signature), echo, publicKey);
+                }
+                if (!verified) {
                     elog("validator echo error. account : ${account} at block : ${num} sig : ${sig}",
                          ("account", std::string(echo.account))("num", Node::getInstance()->getBlockNum())("sig",
                                                                                                            short_sig(
@@ -806,6 +741,7 @@ namespace ultrainio {
             bool bret;
             if (itor != m_echoMsgMap.end()) {
                 bret = updateAndMayResponse(itor->second, echo, true);
+                record2fEcho(itor->second, echo, bret);
                 if ((isMinEcho(itor->second) || isMinFEcho(itor->second)) && bret) {
                     return true;
                 }
@@ -813,6 +749,7 @@ namespace ultrainio {
                 VoterSet voterSet;
                 voterSet.commonEchoMsg = echo;
                 bret = updateAndMayResponse(voterSet, echo, true);
+                record2fEcho(voterSet, echo, bret);
                 m_echoMsgMap.insert(make_pair(echo.blockId, voterSet));
                 if ((isMinEcho(voterSet) || isMinFEcho(voterSet)) && bret) {
                     return true;
@@ -825,10 +762,38 @@ namespace ultrainio {
         }
     }
 
+    static bool getSyncCredits(const ReqSyncMsg &msg, uint32_t key, uint32_t &credits) {
+        for (const auto& e : msg.ext) {
+            if (e.key == key) {
+                char* end = nullptr;
+                credits = std::strtoul(e.value.c_str(), &end, 10);
+                return end != e.value.c_str() && *end == '\0';
+            }
+        }
+        return false;
+    }
+
     bool Scheduler::handleMessage(const fc::sha256 &nodeId, const ReqSyncMsg &msg) {
+        uint32_t credits = 0;
+        if (getSyncCredits(msg, kSyncCreditGrant, credits)) {
+            for (std::list<SyncTask>::iterator it = m_syncTaskQueue.begin(); it != m_syncTaskQueue.end(); ++it) {
+                if (it->nodeId == nodeId && it->seqNum == msg.seqNum && it->streaming) {
+                    it->credits += credits;
+                    it->idlePeriods = 0;
+                    if (pumpSyncTask(*it)) {
+                        m_syncTaskQueue.erase(it);
+                    }
+                    return true;
+                }
+            }
+            // the stream has finished or been stopped, never open a new one from a grant
+            return true;
+        }
+
         if (Node::getInstance()->isSyncing()) {
             return true;
         }
+        bool streaming = getSyncCredits(msg, kSyncCredit, credits) && credits > 0;
 
         if (nodeId == fc::sha256() || m_syncTaskQueue.size() >= m_maxSyncClients) {
             ilog("peer node id is empty or sync task queue is full. node id:${n} queue size:${qz}",
@@ -842,6 +807,9 @@ namespace ultrainio {
                 if (l_it->startBlock == last_block_num + 1 && Node::getInstance()->getBaxCount() > 0) { // When the whole chain blocks at bax, we erase the old task and will add new one.
                     m_syncTaskQueue.erase(l_it);
                     break;
+                } else if (streaming && l_it->seqNum != msg.seqNum) { // The peer has given up the old task.
+                    m_syncTaskQueue.erase(l_it);
+                    break;
                 } else {
                     ilog("peer node ${node} has been already in sync queue.", ("node", nodeId));
                     return false;
@@ -850,6 +818,19 @@ namespace ultrainio {
         }
 
         uint32_t end_block_num = msg.endBlockNum <= last_block_num + 1 ? msg.endBlockNum : last_block_num + 1;
+        if (streaming) {
+            if (msg.startBlockNum <= end_block_num) {
+                m_syncTaskQueue.emplace_back(last_block_num, m_currentBlsVoterSet, nodeId, msg.startBlockNum, end_block_num, msg.seqNum);
+                SyncTask& task = m_syncTaskQueue.back();
+                task.streaming = true;
+                task.credits = credits;
+                if (pumpSyncTask(task)) {
+                    m_syncTaskQueue.pop_back();
+                }
+            }
+            return true;
+        }
+
         chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
         uint32_t max_count = m_maxPacketsOnce / 3;
         uint32_t send_count = 0;
@@ -935,11 +916,11 @@ namespace ultrainio {
                     produceBlock(std::make_shared<chain::signed_block>(block), true);
                 }
                 dlog("sync block finish blockNum = ${block_num}, hash = ${hash}, head_hash = ${head_hash}",
-                     ("block_num", getLastBlocknum())("hash", short_hash(block.id()))("head_hash", short_hash(block.previous)));
+                     ("block_num", getLastBlocknum())("hash", short_hash(msg.blockId()))("head_hash", short_hash(block.previous)));
                 return true;
             } else {
                 elog("block error. block in local chain: blockNum = ${localNum} hash = ${localHash} comming block num:${n} hash:${h} previous hash:${ph}",
-                        ("localNum", last_num)("localHash", b->id())("n", block.block_num())("h", block.id())("ph", block.previous));
+                        ("localNum", last_num)("localHash", b->id())("n", block.block_num())("h", msg.blockId())("ph", block.previous));
                 return false;
             }
         }
@@ -967,8 +948,26 @@ namespace ultrainio {
         return true;
     }
 
+    void Scheduler::resumeSyncTask(const fc::sha256 &nodeId) {
+        for (std::list<SyncTask>::iterator it = m_syncTaskQueue.begin(); it != m_syncTaskQueue.end(); ++it) {
+            if (it->nodeId == nodeId && it->streaming) {
+                uint32_t start = it->startBlock;
+                if (pumpSyncTask(*it)) {
+                    m_syncTaskQueue.erase(it);
+                } else if (it->startBlock != start) {
+                    it->idlePeriods = 0;
+                }
+                return;
+            }
+        }
+    }
+
     bool Scheduler::is2fEcho(const VoterSet& voterSet, uint32_t phaseCount) const {
-        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(Node::getInstance()->getBlockNum());
+        return is2fEcho(voterSet, Node::getInstance()->getBlockNum(), phaseCount);
+    }
+
+    bool Scheduler::is2fEcho(const VoterSet& voterSet, uint32_t blockNum, uint32_t phaseCount) {
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(blockNum);
         ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
         int totalVoterWeight = voterSet.getTotalVoterWeight();
 
@@ -981,11 +980,22 @@ namespace ultrainio {
         }
     }
 
+    void Scheduler::record2fEcho(const VoterSet& voterSet, const EchoMsg& echo, bool updated) {
+        std::shared_ptr<ConsensusMetrics> metrics = ConsensusMetrics::getInstance();
+        if (updated && !metrics->reached2f() && is2fEcho(voterSet, echo.phase + echo.baxCount)) {
+            metrics->reach2f(echo.blockNum(), echo.phase, echo.baxCount);
+        }
+    }
+
     bool Scheduler::isMinPropose(const ProposeMsg &proposeMsg) {
+        return isMinPropose(proposeMsg, m_proposerMsgMap);
+    }
+
+    bool Scheduler::isMinPropose(const ProposeMsg& proposeMsg, const std::map<BlockIdType, ProposeMsg>& proposerMsgMap) {
         std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(proposeMsg.block.block_num());
         ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
         uint32_t priority = stakeVotePtr->proposerPriority(proposeMsg.block.proposer, kPhaseBA0, 0);
-        for (auto itor = m_proposerMsgMap.begin(); itor != m_proposerMsgMap.end(); ++itor) {
+        for (auto itor = proposerMsgMap.begin(); itor != proposerMsgMap.end(); ++itor) {
             if (stakeVotePtr->proposerPriority(itor->second.block.proposer, kPhaseBA0, 0) < priority) {
                 return false;
             }
@@ -993,7 +1003,7 @@ namespace ultrainio {
         return true;
     }
 
-    bool Scheduler::isMinFEcho(const VoterSet& voterSet, const BlockIdVoterSetMap& blockIdVoterSetMap) const {
+    bool Scheduler::isMinFEcho(const VoterSet& voterSet, const BlockIdVoterSetMap& blockIdVoterSetMap) {
         std::shared_ptr<StakeVoteBase> stakeVotePtr
                 = MsgMgr::getInstance()->getStakeVote(BlockHeader::num_from_id(voterSet.commonEchoMsg.blockId));
         ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
@@ -1008,6 +1018,12 @@ namespace ultrainio {
         return true;
     }
 
+    bool Scheduler::isResponseEcho(const VoterSet& voterSet, const BlockIdVoterSetMap& blockIdVoterSetMap,
+                                   ConsensusPhase phase, int threshold) {
+        return voterSet.getTotalVoterWeight() >= threshold && !voterSet.hasSend && phase == kPhaseBA0
+               && isMinFEcho(voterSet, blockIdVoterSetMap);
+    }
+
     bool Scheduler::isMinFEcho(const VoterSet& voterSet) const {
         return isMinFEcho(voterSet, m_echoMsgMap);
     }
@@ -1143,37 +1159,27 @@ namespace ultrainio {
         return count;
     }
 
-    size_t Scheduler::runPendingTrxs(std::list<chain::transaction_metadata_ptr> *trxs,
+    size_t Scheduler::runPendingTrxs(chain::pending_transaction_pool& trxs,
                                             fc::time_point hard_cpu_deadline,
                                             fc::time_point block_time) {
         chain::controller &chain = app().get_plugin<chain_plugin>().chain();
         const auto& cfg = chain.get_global_properties().configuration;
         const auto& max_trx_cpu = cfg.max_transaction_cpu_usage;
-        ilog("------- start running pending ${num} trxs", ("num", trxs->size()));
+        ilog("------- start running pending ${num} trxs", ("num", trxs.size()));
         // TODO(yufengshen) : also scheduled trxs.
         size_t count = 0;
-        while (!trxs->empty()) {
-            auto &trx = trxs->front();
-            if (!trx) {
-                chain.drop_unapplied_transaction(trx);
-                trxs->pop_front();
-                ilog("-----------initProposeMsg null trx");
-                // nulled in the loop above, skip it
-                continue;
-            }
-
+        while (!trxs.empty()) {
+            auto trx = trxs.front();
             if (chain.is_known_unexpired_transaction(trx->id)) {
                 //ilog("-------run pending duplicate trx");
                 chain.drop_unapplied_transaction(trx);
-                chain.drop_pending_transaction_from_set(trx);
-                trxs->pop_front();
+                trxs.pop_front();
                 continue;
             }
 
             if (m_blacklistTrx.find(trx->signed_id) != m_blacklistTrx.end()) {
                 chain.drop_unapplied_transaction(trx);
-                chain.drop_pending_transaction_from_set(trx);
-                trxs->pop_front();
+                trxs.drop_front();
                 ilog("-----------blacklisted pending trx");
                 continue;
             }
@@ -1181,14 +1187,14 @@ namespace ultrainio {
             if (fc::time_point(trx->trx.expiration) < block_time) {
                 //ilog("-------run pending expired trx");
                 chain.drop_unapplied_transaction(trx);
-                chain.drop_pending_transaction_from_set(trx);
-                trxs->pop_front();
+                trxs.drop_front();
                 continue;
             }
 
             try {
                 auto deadline = fc::time_point::now() + fc::milliseconds(max_trx_cpu);
                 auto trace = chain.push_transaction(trx, deadline);
+                bool failed = false;
                 if (trace->except) {
                     ilog("-----------initProposeMsg push trx failed ${e}", ("e", (trace->except)->what()));
                     auto code = trace->except->code();
@@ -1203,11 +1209,15 @@ namespace ultrainio {
                     } else {
                         // for othe kind of failure, we should erase the trx
                         chain.drop_unapplied_transaction(trx);
+                        failed = true;
                     }
                 }
                 // Pop the trx after the above exception handling.
-                chain.drop_pending_transaction_from_set(trx);
-                trxs->pop_front();
+                if (failed) {
+                    trxs.drop_front();
+                } else {
+                    trxs.pop_front();
+                }
 
                 m_initTrxCount++;
                 count++;
@@ -1254,7 +1264,7 @@ namespace ultrainio {
 
             // TODO(yufengshen): We have to cap the block size, cpu/net resource when packing a block.
             // Refer to the subjective and exhausted design.
-            std::list<chain::transaction_metadata_ptr> *pending_trxs = chain.get_pending_transactions();
+            chain::pending_transaction_pool& pending_trxs = chain.get_pending_transactions();
             auto unapplied_trxs = chain.get_unapplied_transactions();
 
             m_initTrxCount = 0;
@@ -1286,7 +1296,7 @@ namespace ultrainio {
                  ("count2", count2)
                  ("count3", count3)
                  ("time", fc::time_point::now() - start_timestamp)
-                 ("count4", pending_trxs->size())
+                 ("count4", pending_trxs.size())
                  ("count5", unapplied_trxs.size() - count2));
             // TODO(yufengshen) - Do we finalize here ?
             // If we finalize here, we insert the block summary into the database.
@@ -1338,99 +1348,124 @@ namespace ultrainio {
     }
 
     void Scheduler::processCache(const RoundInfo& info) {
-        auto proposeItor = m_cacheProposeMsgMap.find(info);
-        if (proposeItor != m_cacheProposeMsgMap.end()) {
+        // rounds skipped by the node will never be processed
+        m_cacheProposeMsgMap.expireBefore(RoundInfo(info.blockNum, kPhaseBA0));
+        m_cacheEchoMsgMap.expireBefore(info);
+
+        ProposeCacheSlot* proposeSlot = m_cacheProposeMsgMap.find(info);
+        if (proposeSlot) {
             dlog("cache propose msg size = ${size}. blockNum = ${num}, phase = ${phase}",
-                 ("size", proposeItor->second.size())
+                 ("size", proposeSlot->msgs.size())
                          ("num", info.blockNum)("phase", info.phase));
-            for (auto &propose : proposeItor->second) {
+            // handleMessage may cache a message again, so take them out of the slot first
+            std::vector<ProposeMsg> proposes;
+            proposes.swap(proposeSlot->msgs);
+            m_cacheProposeMsgMap.erase(info);
+            for (auto &propose : proposes) {
                 handleMessage(propose);
             }
-            m_cacheProposeMsgMap.erase(proposeItor);
         }
 
-        auto echoItor = m_cacheEchoMsgMap.find(info);
-        if (echoItor != m_cacheEchoMsgMap.end()) {
-            dlog("cache echo msg num = ${num}. blockNum = ${id}, phase = ${phase}", ("num", echoItor->second.size())
+        EchoCacheSlot* echoSlot = m_cacheEchoMsgMap.find(info);
+        if (echoSlot) {
+            dlog("cache echo msg num = ${num}. blockNum = ${id}, phase = ${phase}", ("num", echoSlot->msgs.size())
                     ("id", info.blockNum)("phase", info.phase));
-            for (auto &echo : echoItor->second) {
+            std::vector<EchoMsg> echoes;
+            echoes.swap(echoSlot->msgs);
+            m_cacheEchoMsgMap.erase(info);
+            for (auto &echo : echoes) {
                 handleMessage(echo);
             }
-            m_cacheEchoMsgMap.erase(echoItor);
         }
     }
 
     void Scheduler::fastProcessCache(const RoundInfo& info) {
         resetTimestamp();
 
-        auto proposeItor = m_cacheProposeMsgMap.find(info);
-        if (proposeItor != m_cacheProposeMsgMap.end()) {
+        ProposeCacheSlot* proposeSlot = m_cacheProposeMsgMap.find(info);
+        if (proposeSlot) {
             dlog("fastProcessCache. cache propose msg size = ${size}. blockNum = ${num}, phase = ${phase}",
-                 ("size", proposeItor->second.size())
+                 ("size", proposeSlot->msgs.size())
                          ("num", info.blockNum)("phase", info.phase));
-            for (auto &propose : proposeItor->second) {
+            std::vector<ProposeMsg> proposes;
+            proposes.swap(proposeSlot->msgs);
+            m_cacheProposeMsgMap.erase(info);
+            for (auto &propose : proposes) {
                 fastHandleMessage(propose);
             }
-            m_cacheProposeMsgMap.erase(proposeItor);
         }
 
-        auto echoItor = m_cacheEchoMsgMap.find(info);
-        if (echoItor != m_cacheEchoMsgMap.end()) {
-            dlog("fastProcessCache. cache echo msg size = ${size}. blockNum = ${num}, phase = ${phase}", ("size", echoItor->second.size())
+        EchoCacheSlot* echoSlot = m_cacheEchoMsgMap.find(info);
+        if (echoSlot) {
+            dlog("fastProcessCache. cache echo msg size = ${size}. blockNum = ${num}, phase = ${phase}", ("size", echoSlot->msgs.size())
                     ("num", info.blockNum)("phase", info.phase));
-            for (auto &echo : echoItor->second) {
+            std::vector<EchoMsg> echoes;
+            echoes.swap(echoSlot->msgs);
+            m_cacheEchoMsgMap.erase(info);
+            for (auto &echo : echoes) {
                 fastHandleMessage(echo);
             }
-            m_cacheEchoMsgMap.erase(echoItor);
         }
     }
 
     bool Scheduler::findEchoCache(const RoundInfo& info) {
-        auto echoItor = m_cacheEchoMsgMap.find(info);
-        if (echoItor != m_cacheEchoMsgMap.end()) {
-            return true;
-        }
-        return false;
+        return m_cacheEchoMsgMap.find(info) != nullptr;
     }
 
     bool Scheduler::isFastba0(const RoundInfo& info) {
         std::shared_ptr<StakeVoteBase> stakeVotePtr
                 = MsgMgr::getInstance()->getStakeVote(Node::getInstance()->getBlockNum());
         ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
-        auto echoItor = m_cacheEchoMsgMap.find(info);
-        if (echoItor != m_cacheEchoMsgMap.end()) {
-            if (echoItor->second.size() > stakeVotePtr->getSendEchoThreshold()) {
-                return true;
-            }
-        }
+        return isFastba0(m_cacheEchoMsgMap.find(info), stakeVotePtr->getSendEchoThreshold());
+    }
 
-        return false;
+    bool Scheduler::isFastba0(const EchoCacheSlot* echoSlot, uint32_t threshold) {
+        return echoSlot && echoSlot->msgs.size() > threshold;
     }
 
     bool Scheduler::findProposeCache(const RoundInfo& info) {
-        auto proposeItor = m_cacheProposeMsgMap.find(info);
-        if (proposeItor != m_cacheProposeMsgMap.end()) {
-            return true;
-        }
-        return false;
+        return m_cacheProposeMsgMap.find(info) != nullptr;
     }
 
     Block Scheduler::produceBaxBlock() {
-        VoterSet voterSet;
         std::shared_ptr<StakeVoteBase> stakeVotePtr
                 = MsgMgr::getInstance()->getStakeVote(Node::getInstance()->getBlockNum());
         ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
-        uint32_t minPriority = stakeVotePtr->getProposerNumber();
         dlog("begin.");
-        for (auto mapItor = m_echoMsgAllPhase.begin(); mapItor != m_echoMsgAllPhase.end(); ++mapItor) {
-            if ((Node::getInstance()->getPhase() + Node::getInstance()->getBaxCount()) >= Config::kMaxBaxCount) {
-                if (mapItor->first.phase < Config::kMaxBaxCount) {
-                    continue;
-                }
+        VoterSet voterSet = findBax2fEcho(m_echoMsgAllPhase, Node::getInstance()->getBlockNum(),
+                                          Node::getInstance()->getPhase() + Node::getInstance()->getBaxCount(),
+                                          emptyBlockId(), m_proposerMsgMap);
+        if (voterSet.empty()) {
+            return Block();
+        }
+
+        dlog("save VoterSet in bax blockId = ${blockId}", ("blockId", short_hash(voterSet.commonEchoMsg.blockId)));
+        m_currentBlsVoterSet = toBlsVoterSetAndFindEvil(voterSet, stakeVotePtr->getCommitteeSet(),
+                stakeVotePtr->isGenesisPeriod(), stakeVotePtr->getNextRoundThreshold() + 1);
+        m_evilDDosDetector.deduceBlockNum(voterSet, stakeVotePtr->getSendEchoThreshold() + 1,
+                Node::getInstance()->getRoundCount(), Node::getInstance()->getPhase());
+        if (isEmpty(voterSet.commonEchoMsg.blockId)) {
+            dlog("produce empty Block.");
+            return emptyBlock();
+        }
+        return m_proposerMsgMap.find(voterSet.commonEchoMsg.blockId)->second.block;
+    }
+
+    VoterSet Scheduler::findBax2fEcho(const std::map<RoundInfo, BlockIdVoterSetMap>& echoMsgAllPhase, uint32_t blockNum,
+                                      uint32_t phaseCount, const BlockIdType& emptyBlockId,
+                                      const std::map<BlockIdType, ProposeMsg>& proposerMsgMap) {
+        VoterSet voterSet;
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(blockNum);
+        ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
+        uint32_t minPriority = stakeVotePtr->getProposerNumber();
+        for (auto mapItor = echoMsgAllPhase.begin(); mapItor != echoMsgAllPhase.end(); ++mapItor) {
+            // only the empty block phases count once the node votes for the empty block
+            if (Node::isEmptyBlockPhase(phaseCount) && !Node::isEmptyBlockPhase(mapItor->first.phase)) {
+                continue;
             }
 
-            for (auto itor : mapItor->second) {
-                if (is2fEcho(itor.second, mapItor->first.phase)) {
+            for (const auto& itor : mapItor->second) {
+                if (is2fEcho(itor.second, blockNum, mapItor->first.phase)) {
                     dlog("found >= 2f + 1 echo. blocknum = ${blocknum} phase = ${phase}",
                          ("blocknum",mapItor->first.blockNum)("phase",mapItor->first.phase));
                     uint32_t priority = stakeVotePtr->proposerPriority(itor.second.commonEchoMsg.proposer, kPhaseBA0, 0);
@@ -1446,33 +1481,24 @@ namespace ultrainio {
                 continue;
             }
 
-            if (isEmpty(voterSet.commonEchoMsg.blockId)) {
-                dlog("produce empty Block. save VoterSet in bax blockId = ${blockId}", ("blockId", short_hash(voterSet.commonEchoMsg.blockId)));
-                m_currentBlsVoterSet = toBlsVoterSetAndFindEvil(voterSet, stakeVotePtr->getCommitteeSet(),
-                        stakeVotePtr->isGenesisPeriod(), stakeVotePtr->getNextRoundThreshold() + 1);
-                m_evilDDosDetector.deduceBlockNum(voterSet, stakeVotePtr->getSendEchoThreshold() + 1,
-                        Node::getInstance()->getRoundCount(), Node::getInstance()->getPhase());
-                return emptyBlock();
+            if (voterSet.commonEchoMsg.blockId == emptyBlockId) {
+                return voterSet;
             }
-            auto proposeItor = m_proposerMsgMap.find(voterSet.commonEchoMsg.blockId);
-            if (proposeItor != m_proposerMsgMap.end()
+            auto proposeItor = proposerMsgMap.find(voterSet.commonEchoMsg.blockId);
+            if (proposeItor != proposerMsgMap.end()
                     && stakeVotePtr->proposerPriority(proposeItor->second.block.proposer, kPhaseBA0, 0) == minPriority) {
-                dlog("find propose msg ok. blocknum = ${blocknum} phase = ${phase} save VoterSet in bax blockId = ${blockId}",
-                     ("blocknum", mapItor->first.blockNum)("phase", mapItor->first.phase)("blockId", short_hash(voterSet.commonEchoMsg.blockId)));
-                m_currentBlsVoterSet = toBlsVoterSetAndFindEvil(voterSet, stakeVotePtr->getCommitteeSet(),
-                        stakeVotePtr->isGenesisPeriod(), stakeVotePtr->getNextRoundThreshold() + 1);
-                m_evilDDosDetector.deduceBlockNum(voterSet, stakeVotePtr->getSendEchoThreshold() + 1,
-                        Node::getInstance()->getRoundCount(), Node::getInstance()->getPhase());
-                return proposeItor->second.block;
+                dlog("find propose msg ok. blocknum = ${blocknum} phase = ${phase}",
+                     ("blocknum", mapItor->first.blockNum)("phase", mapItor->first.phase));
+                return voterSet;
             }
             dlog("can not find 2f + 1 echo's propose. hash = ${hash}",("hash", short_hash(voterSet.commonEchoMsg.blockId)));
         }
 
-        return Block();
+        return VoterSet();
     }
 
     void Scheduler::reportEmptyBlockReason(const BlockIdType& blockId, bool syncing) {
-        if (blockId == emptyBlock().id() && syncing == false) {
+        if (blockId == emptyBlockId() && syncing == false) {
             EmptyBlockReason reason;
             reason.blockNum = Node::getInstance()->getBlockNum();
             if (m_currentBlsVoterSet.valid() && m_currentBlsVoterSet.commonEchoMsg.blockId == blockId) {
@@ -1482,13 +1508,13 @@ namespace ultrainio {
             reason.currentPhase = Node::getInstance()->getPhase();
             reason.currentBaxCount = Node::getInstance()->getBaxCount();
             reason.proposeCount = m_proposerMsgMap.size();
-            reason.isBa0Empty = m_ba0Block.id() == emptyBlock().id();
+            reason.isBa0Empty = getBa0BlockId() == emptyBlockId();
             NativeTrx::reportEmptyBlockReason(std::string(appbase::app().get_plugin<chain_plugin>().get_chain_name()), reason.blockNum, reason);
         }
     }
 
     void Scheduler::reportMaxBaxCountStatistics(const BlockIdType& blockId, bool syncing) {
-        if (blockId != emptyBlock().id() && syncing == false) {
+        if (blockId != emptyBlockId() && syncing == false) {
             MaxBaxCountStatistics statistics;
             statistics.blockNum = Node::getInstance()->getBlockNum();
             if (m_currentBlsVoterSet.valid() && m_currentBlsVoterSet.commonEchoMsg.blockId == blockId) {
@@ -1506,19 +1532,16 @@ namespace ultrainio {
      * @return
      * empty block or normal block when ba0 while other phase may return blank, empty, normal block.
      */
-    Block Scheduler::produceTentativeBlock() {
+    BlockIdType Scheduler::findMin2fEcho(const BlockIdVoterSetMap& blockIdVoterSetMap, uint32_t blockNum, uint32_t phaseCount) {
         BlockIdType minBlockId = BlockIdType();
-        uint32_t phase = Node::getInstance()->getPhase();
-        phase += Node::getInstance()->getBaxCount();
-
-        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(Node::getInstance()->getBlockNum());
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(blockNum);
         ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
         uint32_t minPriority = stakeVotePtr->getProposerNumber();
-        for (auto itor = m_echoMsgMap.begin(); itor != m_echoMsgMap.end(); itor++) {
+        for (auto itor = blockIdVoterSetMap.begin(); itor != blockIdVoterSetMap.end(); itor++) {
             dlog("finish display_echo. phase = ${phase} size = ${size} totalVoter = ${totalVoter} block_hash : ${block_hash}",
                  ("phase", (uint32_t) itor->second.commonEchoMsg.phase)("size", itor->second.accountPool.size())(
                      "totalVoter", itor->second.getTotalVoterWeight())("block_hash", short_hash(itor->second.commonEchoMsg.blockId)));
-            if (is2fEcho(itor->second, phase)) {
+            if (is2fEcho(itor->second, blockNum, phaseCount)) {
                 uint32_t priority = stakeVotePtr->proposerPriority(itor->second.commonEchoMsg.proposer, kPhaseBA0, 0);
                 if (minPriority >= priority) {
                     minBlockId = itor->second.commonEchoMsg.blockId;
@@ -1526,7 +1549,16 @@ namespace ultrainio {
                 }
             }
         }
+        return minBlockId;
+    }
 
+    Block Scheduler::produceTentativeBlock() {
+        uint32_t phase = Node::getInstance()->getPhase();
+        phase += Node::getInstance()->getBaxCount();
+
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = MsgMgr::getInstance()->getStakeVote(Node::getInstance()->getBlockNum());
+        ULTRAIN_ASSERT(stakeVotePtr, chain::chain_exception, "stakeVotePtr is null");
+        BlockIdType minBlockId = findMin2fEcho(m_echoMsgMap, Node::getInstance()->getBlockNum(), phase);
         if (minBlockId == BlockIdType()) { // not found > 2f + 1 echo
             dlog("can not find >= 2f + 1 = ${num}", ("num", stakeVotePtr->getNextRoundThreshold()));
             if (Node::getInstance()->getPhase() == kPhaseBA0) {
@@ -1537,6 +1569,7 @@ namespace ultrainio {
             }
             return blankBlock();
         }
+        uint32_t minPriority = stakeVotePtr->proposerPriority(m_echoMsgMap[minBlockId].commonEchoMsg.proposer, kPhaseBA0, 0);
         for (auto itor = m_echoMsgMap.begin(); itor != m_echoMsgMap.end(); itor++) {
             uint32_t priority = stakeVotePtr->proposerPriority(itor->second.commonEchoMsg.proposer, kPhaseBA0, 0);
             if (minPriority == priority && phase >= kPhaseBA1) { // check priority only
@@ -1549,7 +1582,7 @@ namespace ultrainio {
                 break;
             }
         }
-        if (minBlockId == emptyBlock().id()) {
+        if (minBlockId == emptyBlockId()) {
             dlog("produce empty Block");
             return emptyBlock();
         }
@@ -1576,7 +1609,7 @@ namespace ultrainio {
         chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
         const auto& cfg = chain.get_global_properties().configuration;
         const chain::signed_block &block = m_ba0Block;
-        auto id = block.id();
+        const BlockIdType& id = getBa0BlockId();
 
         if (isBlank(id)) {
             return false;
@@ -1660,6 +1693,9 @@ namespace ultrainio {
                         auto &pt = receipt.trx.get<chain::packed_transaction>();
                         auto mtrx = std::make_shared<chain::transaction_metadata>(pt);
                         m_blacklistTrx[mtrx->signed_id] = chain.head_block_num();
+                        chain.get_pending_transactions().drop(mtrx->signed_id, [&chain](const chain::transaction_metadata_ptr& trx) {
+                            chain.drop_unapplied_transaction(trx);
+                        });
                     }
                     // So we can terminate early
                     throw *trace->except;
@@ -1694,11 +1730,11 @@ namespace ultrainio {
         chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
         chain.abort_block();
         const chain::signed_block &block = m_ba0Block;
-        if (isBlank(block.id()) || block.transactions.empty()) {
+        const BlockIdType& id = getBa0BlockId();
+        if (isBlank(id) || block.transactions.empty()) {
             return false;
         }
 
-        auto id = block.id();
         auto existing = chain.fetch_block_by_id(id);
         if (existing) {
             ULTRAIN_ASSERT(!existing, chain::chain_exception, "Produced block is already in the chain");
@@ -1789,6 +1825,7 @@ namespace ultrainio {
     }
 
     void Scheduler::produceBlock(const chain::signed_block_ptr &block, bool force_push_whole_block) {
+        ScopedLatency latency(ConsensusMetrics::getInstance()->produceBlock(force_push_whole_block));
         chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
         uint32_t last_num = getLastBlocknum();
 
@@ -1822,7 +1859,7 @@ namespace ultrainio {
                            chain::chain_exception,
                            "Voter wont' have ba0 pre-run");
             // first check if ba1 block is indeed ba0 block.
-            if (theSameOne(m_ba0Block, block)) {
+            if (isBa0Block(block)) {
                 ilog("------ Finish voter pre-running ba0 block");
                 chain.finalize_block();
                 chain.assign_header_to_block();
@@ -1834,7 +1871,7 @@ namespace ultrainio {
 
         // We are already pre-running ba0_block
         if (pbs && m_currentPreRunBa0TrxIndex >= 0 && !force_push_whole_block) {
-            if (theSameOne(m_ba0Block, block)) {
+            if (isBa0Block(block)) {
                 ilog("------ Finish pre-running ba0 block from ${count}", ("count", m_currentPreRunBa0TrxIndex));
                 try {
                     for (; m_currentPreRunBa0TrxIndex < m_ba0Block.transactions.size(); m_currentPreRunBa0TrxIndex++) {
@@ -1893,7 +1930,10 @@ namespace ultrainio {
                 chain.start_receive_event();
             }
 
-            chain.push_block(block);
+            {
+                ScopedLatency pushLatency(ConsensusMetrics::getInstance()->pushBlock());
+                chain.push_block(block);
+            }
 
             if (Node::getInstance()->getNonProducingNode()) {
                 chain.clear_emit_signal();
@@ -1905,7 +1945,7 @@ namespace ultrainio {
         m_currentPreRunBa0TrxIndex = -1;
         m_voterPreRunBa0InProgress = false;
 
-        clearTrxQueue();
+        clearTrxQueue(*block);
 
         chain::block_state_ptr new_bs = chain.head_block_state();
         ilog("-----------produceBlock timestamp ${timestamp} block num ${num} id ${id} trx count ${count}",
@@ -1918,7 +1958,7 @@ namespace ultrainio {
         MsgMgr::getInstance()->moveToNewStep(Node::getInstance()->getBlockNum(), kPhaseBA0, 0);
     }
 
-    void Scheduler::clearTrxQueue() {
+    void Scheduler::clearTrxQueue(const chain::signed_block& block) {
         chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
 
         // TODO(yufengshen):
@@ -1931,20 +1971,29 @@ namespace ultrainio {
             chain.clear_unapplied_transaction();
         }
 
-        std::list<chain::transaction_metadata_ptr> *pending_trxs = chain.get_pending_transactions();
+        chain::pending_transaction_pool& pending_trxs = chain.get_pending_transactions();
         auto block_time = chain.head_block_state()->header.timestamp.to_time_point();
-        auto it = pending_trxs->begin();
-        while (it != pending_trxs->end()) {
-            if (chain.is_known_unexpired_transaction((*it)->id) ||
-                fc::time_point((*it)->trx.expiration) < block_time ||
-                m_blacklistTrx.find((*it)->signed_id) != m_blacklistTrx.end()) {
-                chain.drop_unapplied_transaction(*it);
-                chain.drop_pending_transaction_from_set(*it);
-                it = pending_trxs->erase(it);
-            } else {
-                it++;
+        // expired ones come off the expiration index, only the rest are looked up
+        size_t expired = pending_trxs.remove_expired(block_time, [&chain](const chain::transaction_metadata_ptr& trx) {
+            chain.drop_unapplied_transaction(trx);
+        });
+        // the ones applied by this block are looked up by signed id, the pool is not scanned;
+        // blacklisted ones are dropped when blacklisted and when they reach the front of the pool
+        size_t dropped = 0;
+        for (const auto& receipt : block.transactions) {
+            if (receipt.trx.contains<chain::packed_transaction>()) {
+                auto signed_id = chain::digest_type::hash(receipt.trx.get<chain::packed_transaction>());
+                if (pending_trxs.drop(signed_id, [&chain](const chain::transaction_metadata_ptr& trx) {
+                    chain.drop_unapplied_transaction(trx);
+                })) {
+                    dropped++;
+                }
             }
         }
+        if (expired > 0 || dropped > 0) {
+            dlog("clearTrxQueue drop ${e} expired and ${d} applied pending trxs, remaining ${r}",
+                 ("e", expired)("d", dropped)("r", pending_trxs.size()));
+        }
         // Clean up old malicious trx in m_blacklistTrx;
         auto it2 = m_blacklistTrx.begin();
         uint32_t head_num = chain.head_block_num();
@@ -1970,6 +2019,10 @@ namespace ultrainio {
         return &m_ba0Block;
     }
 
+    const BlockIdType& Scheduler::getBa0BlockId() {
+        return m_ba0BlockHashes.id(m_ba0Block);
+    }
+
     BlockIdType Scheduler::getPreviousBlockhash() const {
         const chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
         return chain.head_block_id();
@@ -2012,6 +2065,22 @@ namespace ultrainio {
         uint32_t max_count = m_maxPacketsOnce / m_syncTaskQueue.size() + 1;
         uint32_t send_count = 0;
         for (std::list<SyncTask>::iterator it = m_syncTaskQueue.begin(); it != m_syncTaskQueue.end();) {
+            if (it->streaming) { // resume the stream blocked by full socket buffers or by the last block
+                uint32_t start = it->startBlock;
+                if (pumpSyncTask(*it)) {
+                    it = m_syncTaskQueue.erase(it);
+                    continue;
+                }
+                it->idlePeriods = (it->startBlock == start) ? it->idlePeriods + 1 : 0;
+                if (it->idlePeriods > m_maxSyncIdlePeriods) {
+                    ilog("streaming sync task to ${node} stalled at ${n}, drop it", ("node", it->nodeId)("n", it->startBlock));
+                    it = m_syncTaskQueue.erase(it);
+                } else {
+                    ++it;
+                }
+                continue;
+            }
+
             sync_block.seqNum = it->seqNum;
             send_count = 0;
             while (send_count < max_count && it->startBlock <= it->endBlock && it->startBlock <= last_num) {
@@ -2043,16 +2112,46 @@ namespace ultrainio {
 
     }
 
-    //NOTE: The template T must be type of map because the erase operation is not generalized.
-    template<class T>
-    void Scheduler::clearMsgCache(T &cache, uint32_t blockNum) {
-        for (auto msg_it = cache.begin(); msg_it != cache.end();) {
-            if (msg_it->first.blockNum <= blockNum) {
-                cache.erase(msg_it++);
-            } else {
-                ++msg_it;
+    bool Scheduler::pumpSyncTask(SyncTask& task) {
+        chain::controller &chain = appbase::app().get_plugin<chain_plugin>().chain();
+        uint32_t last_num = getLastBlocknum();
+        std::vector<std::vector<char>> blocks;
+        while (task.credits > 0 && task.startBlock <= task.endBlock && task.startBlock <= last_num) {
+            uint32_t count = std::min(std::min(task.credits, m_syncBatchBlocks), std::min(task.endBlock, last_num) - task.startBlock + 1);
+            blocks.clear();
+            uint32_t n = chain.fetch_serialized_blocks(task.startBlock, count, blocks);
+            if (n == 0) {
+                if (task.startBlock == last_num) { // try to send last block next time
+                    break;
+                }
+                wlog("block ${n} does not exist", ("n", task.startBlock)); // skip the block if not exist
+                task.startBlock++;
+                continue;
+            }
+
+            for (uint32_t i = 0; i < n; i++) {
+                std::string proof;
+                if (task.startBlock == task.checkBlock) {
+                    proof = task.bvs.toString();
+                    ilog("send checked block in task: ${s}", ("s", proof));
+                } else if (task.startBlock == last_num) {
+                    proof = m_currentBlsVoterSet.toString();
+                    ilog("send last block in task: ${s}", ("s", proof));
+                }
+                if (!Node::getInstance()->sendPackedBlock(task.nodeId, task.seqNum, blocks[i], proof)) {
+                    return false;
+                }
+                task.startBlock++;
+                task.credits--;
             }
         }
+        return task.startBlock > task.endBlock;
+    }
+
+    //NOTE: The template T must be a map ordered by RoundInfo.
+    template<class T>
+    void Scheduler::clearMsgCache(T &cache, uint32_t blockNum) {
+        cache.erase(cache.begin(), cache.lower_bound(RoundInfo(blockNum + 1, 0)));
     }
 
     uint32_t Scheduler::getFastTimestamp() {
@@ -2063,50 +2162,13 @@ namespace ultrainio {
         m_fastTimestamp = 0;
     }
 
-    void Scheduler::clearOldCachedProposeMsg() {
-        uint32_t old_block_num = std::numeric_limits<uint32_t>::max();
-        for (auto &it : m_cacheProposeMsgMap) {
-            if (it.first.blockNum < old_block_num) {
-                old_block_num = it.first.blockNum;
-            }
-        }
-
-        wlog("m_cacheProposeMsgMap exceeds ${max}, echo msgs with block num ${num} will be cleared",
-             ("max", m_maxCachePropose)("num", old_block_num));
-        for (auto it = m_cacheProposeMsgMap.begin(); it != m_cacheProposeMsgMap.end();) {
-            if (it->first.blockNum == old_block_num) {
-                m_cacheProposeMsgMap.erase(it++);
-            } else {
-                ++it;
-            }
-        }
-    }
-
-    void Scheduler::clearOldCachedEchoMsg() {
-        uint32_t old_block_num = std::numeric_limits<uint32_t>::max();
-        for (auto &it : m_cacheEchoMsgMap) {
-            if (it.first.blockNum < old_block_num) {
-                old_block_num = it.first.blockNum;
-            }
-        }
-
-        wlog("m_cacheEchoMsgMap exceeds ${max}, echo msgs with block num ${num} will be cleared",
-             ("max", m_maxCacheEcho)("num", old_block_num));
-        for (auto it = m_cacheEchoMsgMap.begin(); it != m_cacheEchoMsgMap.end();) {
-            if (it->first.blockNum == old_block_num) {
-                m_cacheEchoMsgMap.erase(it++);
-            } else {
-                ++it;
-            }
-        }
-    }
-
     bool Scheduler::isEmpty(const BlockIdType& blockId) {
-        return emptyBlock().id() == blockId;
+        return emptyBlockId() == blockId;
     }
 
     bool Scheduler::isBlank(const BlockIdType& blockId) {
-        return Block().id() == blockId;
+        static const BlockIdType blankBlockId = Block().id();
+        return blankBlockId == blockId;
     }
 
     std::shared_ptr<Block> Scheduler::generateEmptyBlock() {
@@ -2145,14 +2207,24 @@ namespace ultrainio {
 
     void Scheduler::setBa0Block(const Block& block) {
         m_ba0Block = block;
+        m_ba0BlockHashes.reset();
     }
 
-    Block Scheduler::emptyBlock() {
-        static std::shared_ptr<Block> emptyBlock = nullptr; // static variant for cache
-        if (!emptyBlock || emptyBlock->block_num() != Node::getInstance()->getBlockNum()) {
-            emptyBlock = generateEmptyBlock();
+    const Block& Scheduler::currentEmptyBlock() {
+        if (!m_emptyBlock || m_emptyBlock->block_num() != Node::getInstance()->getBlockNum()) {
+            m_emptyBlock = generateEmptyBlock();
+            m_emptyBlockHashes.reset();
         }
-        return *emptyBlock;
+        return *m_emptyBlock;
+    }
+
+    Block Scheduler::emptyBlock() {
+        return currentEmptyBlock();
+    }
+
+    const BlockIdType& Scheduler::emptyBlockId() {
+        const Block& block = currentEmptyBlock();
+        return m_emptyBlockHashes.id(block);
     }
 
     void Scheduler::insertAccount(VoterSet& voterSet, const EchoMsg &echo) {
@@ -2223,11 +2295,11 @@ namespace ultrainio {
                 Node::getInstance()->getRoundCount(), blockNum, Node::getInstance()->getPhase());
     }
 
-    bool Scheduler::theSameOne(const ultrainio::chain::signed_block& lhs, const ultrainio::chain::signed_block_ptr& rhs) {
-        if (&lhs == rhs.get()) {
+    bool Scheduler::isBa0Block(const ultrainio::chain::signed_block_ptr& block) {
+        if (&m_ba0Block == block.get()) {
             return true;
         }
-        return lhs.id() == rhs->id();
+        return getBa0BlockId() == block->id();
     }
 
 }  // namespace ultrainio
@@ -40,11 +40,12 @@ namespace ultrainio {
             : m_committeeStatePtr(committeeStatePtr), m_blockNum(blockNum) {
         if (!m_committeeStatePtr) {
             m_committeeStatePtr = getCommitteeState(chain::self_chain_name);
+            const auto &ro_api = appbase::app().get_plugin<chain_plugin>().get_read_only_api();
+            chain_apis::read_only::get_confirm_point_interval_result result = ro_api.get_confirm_point_interval(chain_apis::read_only::get_confirm_point_interval_params());
+            LightClientProducer::setConfirmPointInterval(result.confirm_point_interval);
         }
         ULTRAIN_ASSERT(getCommitteeMemberNumber() != 0, chain::chain_exception, "totalStake is 0");
-        const auto &ro_api = appbase::app().get_plugin<chain_plugin>().get_read_only_api();
-        chain_apis::read_only::get_confirm_point_interval_result result = ro_api.get_confirm_point_interval(chain_apis::read_only::get_confirm_point_interval_params());
-        LightClientProducer::setConfirmPointInterval(result.confirm_point_interval);
+        buildCommitteeIndex();
     }
 
     StakeVoteBase::~StakeVoteBase() {
@@ -54,6 +55,10 @@ namespace ultrainio {
         return s_nodeInfo;
     }
 
+    void StakeVoteBase::setNodeInfo(std::shared_ptr<NodeInfo> nodeInfo) {
+        s_nodeInfo = nodeInfo;
+    }
+
     AccountName StakeVoteBase::getMyAccount() {
         return s_nodeInfo->getMyAccount();
     }
@@ -206,14 +211,41 @@ namespace ultrainio {
         return realGetEmptyBlock2Threshold();
     }
 
+    void StakeVoteBase::buildCommitteeIndex() {
+        if (!m_committeeStatePtr) {
+            return;
+        }
+        const std::vector<CommitteeInfo>& cinfo = m_committeeStatePtr->cinfo;
+        m_committeeIndex.reserve(cinfo.size());
+        m_committeePublicKeys.reserve(cinfo.size());
+        for (size_t i = 0; i < cinfo.size(); i++) {
+            ULTRAIN_ASSERT(!cinfo[i].accountName.empty(), chain::chain_exception, "account name is empty");
+            // keep the first one as the linear search did
+            m_committeeIndex.emplace(AccountName(cinfo[i].accountName).value, i);
+            m_committeePublicKeys.push_back(PublicKey(cinfo[i].pk));
+        }
+    }
+
+    const CommitteeInfo* StakeVoteBase::findCommitteeMember(const AccountName& account) const {
+        auto itor = m_committeeIndex.find(account.value);
+        if (itor == m_committeeIndex.end()) {
+            return nullptr;
+        }
+        return &m_committeeStatePtr->cinfo[itor->second];
+    }
+
+    int StakeVoteBase::committeeIndexOf(const AccountName& account) const {
+        auto itor = m_committeeIndex.find(account.value);
+        if (itor == m_committeeIndex.end()) {
+            return -1;
+        }
+        return itor->second;
+    }
+
     CommitteeInfo StakeVoteBase::findInCommitteeMemberList(const AccountName& account) const {
-        if (m_committeeStatePtr) {
-            for (auto& v : m_committeeStatePtr->cinfo) {
-                ULTRAIN_ASSERT(!v.accountName.empty(), chain::chain_exception, "account name is empty");
-                if (account == AccountName(v.accountName)) {
-                    return v;
-                }
-            }
+        const CommitteeInfo* c = findCommitteeMember(account);
+        if (c) {
+            return *c;
         }
         return CommitteeInfo();
     }
@@ -224,8 +256,8 @@ namespace ultrainio {
         } else if (account == AccountName(Genesis::kGenesisAccount)) {
             return PublicKey(Genesis::s_genesisPk);
         } else {
-            CommitteeInfo c = findInCommitteeMemberList(account);
-            return PublicKey(c.pk);
+            int index = committeeIndexOf(account);
+            return index >= 0 ? m_committeePublicKeys[index] : PublicKey();
         }
     }
 
@@ -234,11 +266,11 @@ namespace ultrainio {
             Hex::fromHex<unsigned char>(Genesis::s_genesisBlsPk, blsPublicKey, Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
             return true;
         } else {
-            CommitteeInfo c = findInCommitteeMemberList(account);
-            if (c.isEmpty()) {
+            const CommitteeInfo* c = findCommitteeMember(account);
+            if (!c) {
                 return false;
             }
-            Hex::fromHex<unsigned char>(c.blsPk, blsPublicKey, pkSize);
+            Hex::fromHex<unsigned char>(c->blsPk, blsPublicKey, pkSize);
             return true;
         }
         return false;
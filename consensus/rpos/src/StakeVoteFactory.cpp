@@ -6,8 +6,8 @@
 
 namespace ultrainio {
     std::shared_ptr<StakeVoteBase> StakeVoteFactory::createRandom(uint32_t blockNum,
-            std::shared_ptr<CommitteeState> committeeStatePtr) {
-        return std::make_shared<StakeVoteRandom>(blockNum, committeeStatePtr);
+            std::shared_ptr<CommitteeState> committeeStatePtr, const std::string& random) {
+        return std::make_shared<StakeVoteRandom>(blockNum, committeeStatePtr, random);
     }
 
     std::shared_ptr<StakeVoteBase> StakeVoteFactory::createVrf(uint32_t blockNum,
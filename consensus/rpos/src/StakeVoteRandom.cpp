@@ -10,12 +10,13 @@
 using namespace appbase;
 
 namespace ultrainio {
-    StakeVoteRandom::StakeVoteRandom(uint32_t blockNum, std::shared_ptr<CommitteeState> committeeStatePtr)
+    StakeVoteRandom::StakeVoteRandom(uint32_t blockNum, std::shared_ptr<CommitteeState> committeeStatePtr,
+                                     const std::string& random)
             : StakeVoteBase(blockNum, committeeStatePtr) {
         if (!isGenesisPeriod()) {
             // double check committee is work. And m_committeeStatePtr may be null when new node join network
             if (committeeHasWorked2()) {
-                m_random = getSysRandom();
+                m_random = random.empty() ? getSysRandom() : random;
                 RoleRandom rand(m_random, m_blockNum);
                 initRoleSelection(m_committeeStatePtr, rand);
             }
@@ -25,7 +26,7 @@ namespace ultrainio {
     void StakeVoteRandom::initRoleSelection(std::shared_ptr<CommitteeState> committeeStatePtr, const RoleRandom& rand) {
         for (auto committeeInfo : committeeStatePtr->cinfo) {
             m_committeeV.push_back(committeeInfo.accountName);
-            if (committeeInfo.accountName == StakeVoteBase::getMyAccount()) {
+            if (committeeInfo.accountName == StakeVoteBase::getMyAccount() && Node::getInstance()) {
                 ULTRAIN_ASSERT(!Node::getInstance()->getNonProducingNode(), chain::chain_exception, "Committee Member is set as non-producer");
             }
         }
@@ -55,7 +56,7 @@ namespace ultrainio {
             ULTRAIN_ASSERT(false, chain::chain_exception, "handle no proposer message at genesis period. account : ${account}", ("account", std::string(account)));
         }
         std::shared_ptr<RoleSelection> roleSelectionPtr = getRoleSelectionInitIfNull(phase, baxCount);
-        return roleSelectionPtr->proposerPriority(std::string(account));
+        return roleSelectionPtr->proposerPriority(committeeIndexOf(account));
     }
 
     std::shared_ptr<RoleSelection> StakeVoteRandom::getRoleSelection(ConsensusPhase phase, int baxCount) const {
@@ -89,7 +90,7 @@ namespace ultrainio {
         }
         std::shared_ptr<RoleSelection> roleSelectionPtr = getRoleSelectionInitIfNull(kPhaseBA0, 0);
         ULTRAIN_ASSERT(roleSelectionPtr, chain::chain_exception, "RoleSelection is nullptr");
-        return roleSelectionPtr->isProposer(std::string(account));
+        return roleSelectionPtr->isProposer(committeeIndexOf(account));
     }
 
     bool StakeVoteRandom::realIsVoter(const AccountName& account, ConsensusPhase phase, int baxCount) {
@@ -98,7 +99,7 @@ namespace ultrainio {
         }
         std::shared_ptr<RoleSelection> roleSelectionPtr = getRoleSelectionInitIfNull(phase, baxCount);
         ULTRAIN_ASSERT(roleSelectionPtr, chain::chain_exception, "RoleSelection is nullptr");
-        return roleSelectionPtr->isVoter(std::string(account));
+        return roleSelectionPtr->isVoter(committeeIndexOf(account));
     }
 
     int StakeVoteRandom::realGetSendEchoThreshold() const {
@@ -1,6 +1,5 @@
 #include <rpos/StakeVoteVrf.h>
 
-#include <boost/math/distributions/binomial.hpp>
 #include <rpos/Config.h>
 #include <rpos/Node.h>
 #include <rpos/Proof.h>
@@ -19,6 +18,8 @@ namespace ultrainio {
         ULTRAIN_ASSERT(totalStake != 0, chain::chain_exception, "totalStake is 0");
         m_proposerRatio = Config::kProposerStakeNumber / totalStake;
         m_voterRatio = Config::kVoterStakeNumber / totalStake;
+        m_proposerTable = BinomialCdfTable(THRESHOLD_STAKE, m_proposerRatio);
+        m_voterTable = BinomialCdfTable(THRESHOLD_STAKE, m_voterRatio);
     }
 
     long StakeVoteVrf::getTotalStakes() const {
@@ -30,7 +31,7 @@ namespace ultrainio {
             return false;
         }
 
-        if (commonCalSelectedStake(proof, THRESHOLD_STAKE, m_proposerRatio) > 0) {
+        if (commonCalSelectedStake(proof, m_proposerTable) > 0) {
             return true;
         }
         return false;
@@ -48,27 +49,15 @@ namespace ultrainio {
     }
 
     bool StakeVoteVrf::isCommitteeMember(const AccountName& account) const {
-        CommitteeInfo c = findInCommitteeMemberList(account);
-        return !c.isEmpty();
+        return findCommitteeMember(account) != nullptr;
     }
 
     int StakeVoteVrf::calSelectedStake(const Proof& proof) {
-        return commonCalSelectedStake(proof, THRESHOLD_STAKE, m_voterRatio);
+        return commonCalSelectedStake(proof, m_voterTable);
     }
 
-    int StakeVoteVrf::commonCalSelectedStake(const Proof& proof, int stakes, double p) {
-        double rand = proof.getRand();
-        return reverseBinoCdf(rand, stakes, p);
-    }
-
-    int StakeVoteVrf::reverseBinoCdf(double rand, int stake, double p) {
-        int k = 0;
-        boost::math::binomial b(stake, p);
-
-        while (rand > boost::math::cdf(b, k)) {
-            k++;
-        }
-        return k;
+    int StakeVoteVrf::commonCalSelectedStake(const Proof& proof, const BinomialCdfTable& table) {
+        return table.reverse(proof.getRand());
     }
 
     int StakeVoteVrf::realGetSendEchoThreshold() const {
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/types.h"
+
+namespace ultrainio {
+    // Memoizes the digest and the id of a block header. Both come from one sha256 of the BlockHeader:
+    // the digest is what the proposer signs (Signer::sign<BlockHeader>) and the id is the digest with
+    // the block num in its first 4 bytes, as block_header::id(). The first call hashes the header, so
+    // the header must not change after it unless reset() is called.
+    class BlockHashCache {
+    public:
+        const BlockIdType& id(const BlockHeader& header) const;
+
+        const SHA256& digest(const BlockHeader& header) const;
+
+        void reset();
+
+    private:
+        void compute(const BlockHeader& header) const;
+
+        mutable BlockIdType m_id;
+        mutable SHA256 m_digest;
+        mutable bool m_valid = false;
+    };
+}
@@ -19,6 +19,12 @@ namespace ultrainio {
 
         bool verifyBls(std::vector<std::string> blsPkVector) const;
 
+        // pks are decoded compressed public keys in the same order as accountPool
+        bool verifyBls(unsigned char** pks, int size) const;
+
+        // verify several voter sets with one multi pairing, pks[i] are the decoded keys of sets[i]
+        static bool verifyBlsBatch(const std::vector<const BlsVoterSet*>& sets, std::vector<std::vector<unsigned char*>>& pks);
+
         std::string toString() const;
 
         std::vector<char> toVectorChar() const;
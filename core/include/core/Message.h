@@ -5,6 +5,7 @@
 #include <ultrainio/chain/block.hpp>
 #include <crypto/Signature.h>
 
+#include "core/BlockHashCache.h"
 #include "core/ExtType.h"
 #include "core/types.h"
 
@@ -19,6 +20,12 @@ namespace ultrainio {
 
     typedef std::vector<ExtType> MsgExtension;
 
+    // keys of ReqSyncMsg::ext and SyncBlockMsg::ext
+    enum SyncExtKey {
+        kSyncCredit = 1, // ReqSyncMsg: open a stream of this many blocks. SyncBlockMsg: the block is streamed
+        kSyncCreditGrant = 2, // ReqSyncMsg: add this many blocks to the stream with the same seqNum
+    };
+
     struct ReqSyncMsg {
         uint32_t seqNum;
         uint32_t startBlockNum;
@@ -45,6 +52,12 @@ namespace ultrainio {
         Block block;
         std::string proof;
         MsgExtension ext;
+
+        // id of block, hashed on the first call
+        const BlockIdType& blockId() const;
+
+    private:
+        BlockHashCache m_blockHashes;
     };
 
     struct SyncStopMsg {
@@ -60,6 +73,14 @@ namespace ultrainio {
 
     struct ProposeMsg : public UnsignedProposeMsg {
         std::string signature;
+
+        // id and signed digest of block, hashed on the first call
+        const BlockIdType& blockId() const;
+
+        const SHA256& blockDigest() const;
+
+    private:
+        BlockHashCache m_blockHashes;
     };
 
     // echo message
@@ -0,0 +1,31 @@
+#include "core/BlockHashCache.h"
+
+#include <fc/bitutil.hpp>
+
+namespace ultrainio {
+    const BlockIdType& BlockHashCache::id(const BlockHeader& header) const {
+        if (!m_valid) {
+            compute(header);
+        }
+        return m_id;
+    }
+
+    const SHA256& BlockHashCache::digest(const BlockHeader& header) const {
+        if (!m_valid) {
+            compute(header);
+        }
+        return m_digest;
+    }
+
+    void BlockHashCache::reset() {
+        m_valid = false;
+    }
+
+    void BlockHashCache::compute(const BlockHeader& header) const {
+        m_digest = header.digest();
+        m_id = m_digest;
+        m_id._hash[0] &= 0xffffffff00000000;
+        m_id._hash[0] += fc::endian_reverse_u32(header.block_num());
+        m_valid = true;
+    }
+}
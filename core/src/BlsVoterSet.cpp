@@ -3,15 +3,15 @@
 #include <base/Hex.h>
 #include <base/Memory.h>
 #include <crypto/Bls.h>
+#include <crypto/HexDigest.h>
 
 namespace ultrainio {
     template <class T>
     static bool verify(const std::string& sig, const T& v, unsigned char** pks, int size) {
-        fc::sha256 h = fc::sha256::hash(v);
-        std::shared_ptr<Bls> blsPtr = Bls::getDefault();
+        HexDigest h = HexDigest::of(v);
         unsigned char sigX[Bls::BLS_SIGNATURE_COMPRESSED_LENGTH];
         Hex::fromHex<unsigned char>(sig, sigX, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
-        return blsPtr->verifyAggregate(pks, size, sigX, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH, (void*)h.str().c_str(), h.str().length());
+        return Bls::getDefault()->verifyAggregate(pks, size, sigX, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH, (void*)h.data(), h.size());
     }
 
     // BlsVoterSet
@@ -66,6 +66,46 @@ namespace ultrainio {
         return res;
     }
 
+    bool BlsVoterSet::verifyBls(unsigned char** pks, int size) const {
+        if (size != accountPool.size()) {
+            ilog("size not equal");
+            return false;
+        }
+        return verify(sigX, commonEchoMsg, pks, size);
+    }
+
+    bool BlsVoterSet::verifyBlsBatch(const std::vector<const BlsVoterSet*>& sets, std::vector<std::vector<unsigned char*>>& pks) {
+        if (sets.empty() || sets.size() != pks.size()) {
+            return false;
+        }
+        if (sets.size() == 1) {
+            return sets[0]->verifyBls(pks[0].data(), pks[0].size());
+        }
+        int count = sets.size();
+        std::vector<unsigned char**> pkV(count);
+        std::vector<int> pkSizeV(count);
+        std::vector<HexDigest> hV;
+        hV.reserve(count);
+        std::vector<void*> hmsgV(count);
+        std::vector<int> hSizeV(count);
+        std::vector<unsigned char> sigBytes(count * Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+        std::vector<unsigned char*> sigV(count);
+        for (int i = 0; i < count; i++) {
+            if (pks[i].size() != sets[i]->accountPool.size()) {
+                ilog("size not equal");
+                return false;
+            }
+            pkV[i] = pks[i].data();
+            pkSizeV[i] = pks[i].size();
+            hV.push_back(HexDigest::of(sets[i]->commonEchoMsg));
+            hmsgV[i] = (void*)hV[i].data();
+            hSizeV[i] = hV[i].size();
+            sigV[i] = sigBytes.data() + i * Bls::BLS_SIGNATURE_COMPRESSED_LENGTH;
+            Hex::fromHex<unsigned char>(sets[i]->sigX, sigV[i], Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+        }
+        return Bls::getDefault()->verifyAggregateBatch(pkV.data(), pkSizeV.data(), sigV.data(), hmsgV.data(), hSizeV.data(), count);
+    }
+
     void BlsVoterSet::toStringStream(std::stringstream& ss) const {
         if (!valid()) {
             ss << std::string();
@@ -1,6 +1,20 @@
 #include "core/Message.h"
 
 namespace ultrainio {
+    // SyncBlockMsg
+    const BlockIdType& SyncBlockMsg::blockId() const {
+        return m_blockHashes.id(block);
+    }
+
+    // ProposeMsg
+    const BlockIdType& ProposeMsg::blockId() const {
+        return m_blockHashes.id(block);
+    }
+
+    const SHA256& ProposeMsg::blockDigest() const {
+        return m_blockHashes.digest(block);
+    }
+
     // CommonEchoMsg
     void CommonEchoMsg::toStringStream(std::stringstream& ss) const {
         ss << std::string(blockId) << " ";
@@ -27,6 +27,10 @@ namespace ultrainio {
         bool verify(unsigned char* pk, unsigned char* sig, void* hmsg, int hSize);
         bool aggregate(unsigned char* sig[], int size, unsigned char* sigX, int sigXSize);
         bool verifyAggregate(unsigned char* pk[], int size, unsigned char* sigX, int sigXSize, void* hmsg, int hSize);
+        // verify count aggregated signatures with one product of pairings, sigX[i] is signed on hmsg[i]
+        // by the pkSize[i] keys in pk[i]. Every signature is weighted by a random exponent, so an
+        // invalid one can not be cancelled out by another one in the same batch.
+        bool verifyAggregateBatch(unsigned char** pk[], int pkSize[], unsigned char* sigX[], void* hmsg[], int hSize[], int count);
 
     private:
         static std::shared_ptr<Bls> s_blsPtr;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fc/crypto/sha256.hpp>
+
+#include <base/Hex.h>
+
+namespace ultrainio {
+    // The ed25519 and bls signatures are made over the hex form of the sha256 of a message.
+    // HexDigest computes it by packing the message straight into the sha256 context and
+    // keeps the 64 chars on the stack instead of going through fc::sha256::str().
+    class HexDigest {
+    public:
+        static const size_t kLength = 64;
+
+        template <class T>
+        static HexDigest of(const T& v) {
+            return HexDigest(fc::sha256::hash(v));
+        }
+
+        // from a sha256 computed before, e.g. a memoized block digest
+        static HexDigest ofHash(const fc::sha256& h) {
+            return HexDigest(h);
+        }
+
+        const uint8_t* data() const {
+            return reinterpret_cast<const uint8_t*>(m_hex);
+        }
+
+        size_t size() const {
+            return kLength;
+        }
+
+    private:
+        explicit HexDigest(const fc::sha256& h) {
+            Hex::toHex<unsigned char>(reinterpret_cast<const unsigned char*>(h.data()), h.data_size(), m_hex);
+        }
+
+        char m_hex[kLength];
+    };
+}
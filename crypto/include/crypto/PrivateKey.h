@@ -28,6 +28,8 @@ namespace ultrainio {
 
         Signature sign(const Digest& digest) const;
 
+        Signature sign(const uint8_t* message, size_t len) const;
+
         PublicKey getPublicKey() const;
 
         bool isValid() const;
@@ -1,13 +1,19 @@
 #pragma once
 
+#include <array>
 #include <string>
 
 #include <crypto/Digest.h>
 #include <crypto/Signature.h>
 
 namespace ultrainio {
+    // ed25519 public key, the hex form is decoded once when the key is built and kept as given
     class PublicKey {
     public:
+        static const size_t kRawLength = 32;
+
+        typedef std::array<uint8_t, kRawLength> RawType;
+
         PublicKey() = default;
 
         explicit PublicKey(const std::string& key);
@@ -26,10 +32,13 @@ namespace ultrainio {
 
         bool verify(const Signature& signature, const Digest& digest) const;
 
+        bool verify(const Signature& signature, const uint8_t* message, size_t len) const;
+
         bool isValid() const;
 
     private:
-        bool getRaw(uint8_t* rawKey, size_t len) const;
         std::string m_key;
+        RawType m_raw;
+        bool m_valid = false;
     };
-}
\ No newline at end of file
+}
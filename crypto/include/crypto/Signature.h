@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
 
 namespace ultrainio {
+    // ed25519 signature, the hex form is decoded once when the signature is built and kept as given
     class Signature {
     public:
+        static const size_t kRawLength = 64;
+
+        typedef std::array<uint8_t, kRawLength> RawType;
+
         Signature();
         explicit Signature(const std::string& s);
         Signature(const uint8_t* s, size_t len);
@@ -14,7 +22,12 @@ namespace ultrainio {
         bool isValid() const;
         bool getRaw(uint8_t* rawKey, size_t len) const;
 
+        // kRawLength bytes, only meaningful when isValid()
+        const uint8_t* raw() const;
+
     private:
         std::string m_sig;
+        RawType m_raw;
+        bool m_valid = false;
     };
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include <base/Hex.h>
 #include <crypto/Bls.h>
 #include <crypto/Digest.h>
+#include <crypto/HexDigest.h>
 #include <crypto/PrivateKey.h>
 #include <crypto/Signature.h>
 
@@ -13,17 +14,15 @@ namespace ultrainio {
     public:
         template <class T>
         static Signature sign(const T& v, const PrivateKey& privateKey) {
-            fc::sha256 h = fc::sha256::hash(v);
-            Digest digest(h.str());
-            return privateKey.sign(digest);
+            HexDigest digest = HexDigest::of(v);
+            return privateKey.sign(digest.data(), digest.size());
         }
 
         template <class T>
         static std::string sign(const T& v, unsigned char* sk) {
-            fc::sha256 h = fc::sha256::hash(v);
-            std::shared_ptr<Bls> blsPtr = Bls::getDefault();
+            HexDigest digest = HexDigest::of(v);
             unsigned char signature[Bls::BLS_SIGNATURE_COMPRESSED_LENGTH];
-            if (blsPtr->sign(sk, (void*)h.str().c_str(), h.str().length(), signature, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH)) {
+            if (Bls::getDefault()->sign(sk, (void*)digest.data(), digest.size(), signature, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH)) {
                 return Hex::toHex<unsigned char>(signature, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
             }
             return std::string();
@@ -5,6 +5,7 @@
 #include <base/Hex.h>
 #include <crypto/Bls.h>
 #include <crypto/Digest.h>
+#include <crypto/HexDigest.h>
 #include <crypto/PublicKey.h>
 #include <crypto/Signature.h>
 
@@ -13,18 +14,22 @@ namespace ultrainio {
     public:
         template <class T>
         static bool verify(const Signature& signature, const T& v, const PublicKey& publicKey) {
-            fc::sha256 h = fc::sha256::hash(v);
-            Digest digest(h.str());
-            return publicKey.verify(signature, digest);
+            HexDigest digest = HexDigest::of(v);
+            return publicKey.verify(signature, digest.data(), digest.size());
+        }
+
+        // same as verify<T>(signature, v, publicKey) with digest = sha256 of v computed by the caller
+        static bool verifyDigest(const Signature& signature, const fc::sha256& digest, const PublicKey& publicKey) {
+            HexDigest hex = HexDigest::ofHash(digest);
+            return publicKey.verify(signature, hex.data(), hex.size());
         }
 
         template <class T>
         static bool verify(const std::string& signature, const T& v, unsigned char* pk) {
-            fc::sha256 h = fc::sha256::hash(v);
-            std::shared_ptr<Bls> blsPtr = Bls::getDefault();
+            HexDigest digest = HexDigest::of(v);
             unsigned char sign[Bls::BLS_SIGNATURE_COMPRESSED_LENGTH];
             Hex::fromHex<unsigned char>(signature, sign, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
-            return blsPtr->verify(pk, sign, (void*)h.str().c_str(), h.str().length());
+            return Bls::getDefault()->verify(pk, sign, (void*)digest.data(), digest.size());
         }
     };
 }
\ No newline at end of file
@@ -225,4 +225,74 @@ namespace ultrainio {
         element_clear(pkElement);
         return res;
     }
+
+    bool Bls::verifyAggregateBatch(unsigned char** pk[], int pkSize[], unsigned char* sigX[], void* hmsg[], int hSize[], int count) {
+        if (count <= 0 || !pk || !pkSize || !sigX || !hmsg || !hSize) {
+            return false;
+        }
+        element_t* hElements = new element_t[count];
+        element_t* pkXElements = new element_t[count];
+        element_t sigSumElement;
+        element_t sigElement;
+        element_t pkElement;
+        element_t rElement;
+        element_t temp1;
+        element_t temp2;
+        element_init_G1(sigSumElement, m_pairing);
+        element_init_G1(sigElement, m_pairing);
+        element_init_G2(pkElement, m_pairing);
+        element_init_Zr(rElement, m_pairing);
+        element_init_GT(temp1, m_pairing);
+        element_init_GT(temp2, m_pairing);
+
+        bool res = true;
+        for (int i = 0; i < count; i++) {
+            element_init_G1(hElements[i], m_pairing);
+            element_init_G2(pkXElements[i], m_pairing);
+            if (!res) {
+                continue;
+            }
+            if (!pk[i] || !sigX[i] || !hmsg[i]) {
+                elog("batch has nullptr at ${i}", ("i", i));
+                res = false;
+                continue;
+            }
+            element_random(rElement);
+            element_from_bytes_compressed(sigElement, sigX[i]);
+            element_pow_zn(sigElement, sigElement, rElement);
+            element_add(sigSumElement, sigSumElement, sigElement);
+
+            element_from_hash(hElements[i], hmsg[i], hSize[i]);
+            element_pow_zn(hElements[i], hElements[i], rElement);
+            for (int j = 0; j < pkSize[i]; j++) {
+                if (!pk[i][j]) {
+                    elog("pk vector has nullptr");
+                    res = false;
+                    break;
+                }
+                element_from_bytes_compressed(pkElement, pk[i][j]);
+                element_add(pkXElements[i], pkXElements[i], pkElement);
+            }
+        }
+
+        if (res) {
+            element_pairing(temp1, sigSumElement, m_g);
+            element_prod_pairing(temp2, hElements, pkXElements, count);
+            res = !element_cmp(temp1, temp2);
+        }
+
+        for (int i = 0; i < count; i++) {
+            element_clear(hElements[i]);
+            element_clear(pkXElements[i]);
+        }
+        delete[] hElements;
+        delete[] pkXElements;
+        element_clear(sigSumElement);
+        element_clear(sigElement);
+        element_clear(pkElement);
+        element_clear(rElement);
+        element_clear(temp1);
+        element_clear(temp2);
+        return res;
+    }
 }
@@ -33,12 +33,16 @@ namespace ultrainio {
 
     Signature PrivateKey::sign(const Digest& digest) const {
         std::string digestStr = std::string(digest);
+        return sign((const uint8_t*)digestStr.c_str(), digestStr.length());
+    }
+
+    Signature PrivateKey::sign(const uint8_t* message, size_t len) const {
         uint8_t rawKey[Ed25519::PRIVATE_KEY_LEN];
         if (!getRaw(rawKey, Ed25519::SIGNATURE_LEN)) {
             return Signature();
         }
         uint8_t sig[Ed25519::SIGNATURE_LEN];
-        if (!Ed25519::sign(sig, (const uint8_t*)digestStr.c_str(), digestStr.length(), rawKey)) {
+        if (!Ed25519::sign(sig, message, len, rawKey)) {
             return Signature();
         }
         return Signature(sig, Ed25519::SIGNATURE_LEN);
@@ -1,19 +1,35 @@
 #include "crypto/PublicKey.h"
 
+#include <algorithm>
+
+#include <boringssl/curve25519.h>
 #include <base/Hex.h>
 #include <crypto/Ed25519.h>
 
 namespace ultrainio {
-    PublicKey::PublicKey(const std::string& key) : m_key(key) {}
+    const size_t PublicKey::kRawLength;
 
-    PublicKey::PublicKey(uint8_t* rawKey, size_t len) : m_key(Hex::toHex<uint8_t>(rawKey, len)) {}
+    static_assert(PublicKey::kRawLength == ED25519_PUBLIC_KEY_LEN, "ed25519 public key length");
+
+    PublicKey::PublicKey(const std::string& key) : m_key(key) {
+        if (key.length() == 2 * kRawLength) {
+            m_valid = Hex::fromHex<uint8_t>(key, m_raw.data(), kRawLength) == kRawLength;
+        }
+    }
+
+    PublicKey::PublicKey(uint8_t* rawKey, size_t len) : m_key(Hex::toHex<uint8_t>(rawKey, len)) {
+        if (rawKey != nullptr && len == kRawLength) {
+            std::copy(rawKey, rawKey + kRawLength, m_raw.begin());
+            m_valid = true;
+        }
+    }
 
     bool operator == (const PublicKey& lhs, const PublicKey& rhs) {
         return lhs.m_key == rhs.m_key;
     }
 
     bool operator != (const PublicKey& lhs, const PublicKey& rhs) {
-        return lhs.m_key != rhs.m_key;
+        return !(lhs == rhs);
     }
 
     PublicKey::operator std::string() const {
@@ -21,32 +37,18 @@ namespace ultrainio {
     }
 
     bool PublicKey::verify(const Signature& signature, const Digest& digest) const {
-        if (!isValid()) {
-            return false;
-        }
-        uint8_t pk[Ed25519::PUBLIC_KEY_LEN];
-        if (!getRaw(pk, Ed25519::PUBLIC_KEY_LEN)) {
-            return false;
-        }
-        uint8_t sigUint8[Ed25519::SIGNATURE_LEN];
-        if (!signature.getRaw(sigUint8, Ed25519::SIGNATURE_LEN)) {
-            return false;
-        }
         std::string h = std::string(digest);
-        if (Ed25519::verify((const uint8_t*)h.c_str(), h.length(), sigUint8, pk)) {
-            return true;
-        }
-        return false;
+        return verify(signature, (const uint8_t*)h.c_str(), h.length());
     }
 
-    bool PublicKey::getRaw(uint8_t* rawKey, size_t len) const {
-        return Hex::fromHex<uint8_t>(m_key, rawKey, len) == Ed25519::PUBLIC_KEY_LEN;
+    bool PublicKey::verify(const Signature& signature, const uint8_t* message, size_t len) const {
+        if (!m_valid || !signature.isValid()) {
+            return false;
+        }
+        return Ed25519::verify(message, len, signature.raw(), m_raw.data());
     }
 
     bool PublicKey::isValid() const {
-        if (m_key.length() == Ed25519::PUBLIC_KEY_HEX_LEN) {
-            return true;
-        }
-        return false;
+        return m_valid;
     }
-}
\ No newline at end of file
+}
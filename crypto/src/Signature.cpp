@@ -1,28 +1,47 @@
 #include "crypto/Signature.h"
 
+#include <algorithm>
+
+#include <boringssl/curve25519.h>
 #include <base/Hex.h>
 
 namespace ultrainio {
+    const size_t Signature::kRawLength;
+
+    static_assert(Signature::kRawLength == ED25519_SIGNATURE_LEN, "ed25519 signature length");
+
     Signature::Signature() {}
 
-    Signature::Signature(const std::string& sig) : m_sig(sig) {}
+    Signature::Signature(const std::string& sig) : m_sig(sig) {
+        if (sig.length() == 2 * kRawLength) {
+            m_valid = Hex::fromHex<uint8_t>(sig, m_raw.data(), kRawLength) == kRawLength;
+        }
+    }
 
-    Signature::Signature(const uint8_t* sig, size_t len) : m_sig(Hex::toHex(sig, len)) {}
+    Signature::Signature(const uint8_t* sig, size_t len) : m_sig(Hex::toHex(sig, len)) {
+        if (sig != nullptr && len == kRawLength) {
+            std::copy(sig, sig + kRawLength, m_raw.begin());
+            m_valid = true;
+        }
+    }
 
     Signature::operator std::string() const {
         return m_sig;
     }
 
     bool Signature::isValid() const {
-        // loose check
-        return m_sig.length() != 0;
+        return m_valid;
     }
 
     bool Signature::getRaw(uint8_t* rawKey, size_t len) const {
-        if (rawKey == nullptr || len <= 0) {
+        if (rawKey == nullptr || len <= 0 || !m_valid) {
             return false;
         }
-        Hex::fromHex<uint8_t>(m_sig, rawKey, len);
+        std::copy(m_raw.begin(), m_raw.begin() + std::min(len, kRawLength), rawKey);
         return true;
     }
-}
\ No newline at end of file
+
+    const uint8_t* Signature::raw() const {
+        return m_raw.data();
+    }
+}
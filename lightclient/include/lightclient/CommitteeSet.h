@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <core/BlsVoterSet.h>
 #include <core/types.h>
@@ -18,6 +20,8 @@ namespace ultrainio {
         CommitteeSet(const std::vector<CommitteeInfo>& committeeInfoV);
         CommitteeSet(const std::vector<chain::role_base>& roleBaseVector);
         bool verify(const BlsVoterSet& blsVoterSet) const;
+        // all or nothing, the sets are checked together with one multi pairing
+        bool verify(const std::vector<BlsVoterSet>& blsVoterSetV) const;
         SHA256 committeeMroot() const;
         std::vector<char> toVectorChar() const;
         std::string toString() const;
@@ -25,11 +29,27 @@ namespace ultrainio {
         bool operator != (const CommitteeSet& rhs) const;
         CommitteeDelta diff(const CommitteeSet& pre) const;
         std::vector<std::string> getBlsPk(const std::vector<AccountName>& accountV) const;
+        // empty if the account is not in the committee
+        std::string getPk(const AccountName& account) const;
         bool empty() const;
+        bool contains(const CommitteeInfo& info) const;
 
     private:
         std::vector<CommitteeInfo> m_committeeInfoV;
+        // accountName -> position in m_committeeInfoV
+        std::unordered_map<std::string, size_t> m_accountIndex;
+        // lazily decoded bls public keys, parallel to m_committeeInfoV
+        mutable std::vector<std::vector<unsigned char>> m_blsPkBytes;
+        // the committee string layout is part of consensus (block header mroot),
+        // so the root can not be merkleized, it is computed once and kept instead
+        mutable std::string m_cachedString;
+        mutable SHA256 m_cachedMroot;
+        mutable bool m_mrootCached = false;
+
         void init(const std::string& s);
+        void buildIndex();
+        const std::vector<unsigned char>& blsPkBytes(size_t index) const;
+        bool collectBlsPk(const BlsVoterSet& blsVoterSet, std::vector<unsigned char*>& pks) const;
         int nextRoundThreshold() const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <fc/filesystem.hpp>
+
+#include <core/types.h>
+#include <lightclient/StartPoint.h>
+
+namespace ultrainio {
+    // Confirmed block headers of one chain kept on disk, so that a light client is able to
+    // resume from its last confirmed point instead of verifying the header chain again.
+    //
+    // headers : | size | packed header | size | packed header | ...
+    // index   : | first block num | record of first block num | record of first block num + 1 | ...
+    //           every record has the fixed size of kIndexRecordSize, | block id | position in headers |
+    // state   : StartPoint at the last confirmed block, replaced atomically on every save
+    class HeaderStore {
+    public:
+        static const size_t kIndexRecordSize;
+
+        explicit HeaderStore(const fc::path& dir);
+
+        ~HeaderStore();
+
+        // headers MUST be appended in block number order, a gap starts the store again
+        void append(const BlockHeader& blockHeader);
+
+        bool read(uint32_t blockNum, BlockHeader& blockHeader) const;
+
+        bool empty() const;
+
+        uint32_t firstBlockNum() const;
+
+        uint32_t lastBlockNum() const;
+
+        BlockIdType lastBlockId() const;
+
+        void saveStartPoint(const StartPoint& startPoint);
+
+        bool loadStartPoint(StartPoint& startPoint) const;
+
+        void reset();
+
+    private:
+        // drops a partial record left at the end of the files by a crash
+        void open();
+
+        // reads the header record at pos, false if it does not fit in headerSize or does not unpack
+        static bool readRecord(std::istream& headers, uint64_t pos, uint64_t headerSize,
+                               BlockHeader& blockHeader, uint64_t& end);
+
+        void truncate(uint32_t blockNum);
+
+        fc::path m_dir;
+
+        std::fstream m_headerStream;
+
+        std::fstream m_indexStream;
+
+        uint32_t m_firstBlockNum = 0;
+
+        uint32_t m_lastBlockNum = 0;
+
+        BlockIdType m_lastBlockId;
+
+        uint64_t m_headerSize = 0;
+    };
+}
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <list>
+#include <map>
 #include <memory>
 
+#include <fc/filesystem.hpp>
+
 namespace ultrainio {
+    class HeaderStore;
     class LightClient;
 
     class LightClientMgr {
@@ -12,9 +16,18 @@ namespace ultrainio {
 
         std::shared_ptr<LightClient> getLightClient(uint64_t chainName);
 
+        // the header store of a chain in storeDir/<chain name>, nullptr if no store dir is set
+        std::shared_ptr<HeaderStore> getHeaderStore(uint64_t chainName);
+
+        void setStoreDir(const fc::path& storeDir);
+
     private:
         static std::shared_ptr<LightClientMgr> s_self;
 
         std::list<std::shared_ptr<LightClient>> m_lightClientList;
+
+        std::map<uint64_t, std::shared_ptr<HeaderStore>> m_headerStoreMap;
+
+        fc::path m_storeDir;
     };
 }
\ No newline at end of file
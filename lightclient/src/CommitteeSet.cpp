@@ -1,14 +1,19 @@
 #include <lightclient/CommitteeSet.h>
 
+#include <base/Hex.h>
+#include <crypto/Bls.h>
+
 namespace ultrainio {
     CommitteeSet::CommitteeSet() {}
 
     CommitteeSet::CommitteeSet(const std::string& s) {
         init(s);
+        buildIndex();
     }
 
     CommitteeSet::CommitteeSet(const std::vector<char>& vc) {
         init(std::string(vc.begin(), vc.end()));
+        buildIndex();
     }
 
     void CommitteeSet::init(const std::string& s) {
@@ -25,7 +30,9 @@ namespace ultrainio {
     }
 
     CommitteeSet::CommitteeSet(const std::vector<CommitteeInfo>& committeeInfoV)
-            : m_committeeInfoV(committeeInfoV) {}
+            : m_committeeInfoV(committeeInfoV) {
+        buildIndex();
+    }
 
     CommitteeSet::CommitteeSet(const std::vector<chain::role_base>& roleBaseVector) {
         for (auto e : roleBaseVector) {
@@ -35,6 +42,26 @@ namespace ultrainio {
             info.pk = e.producer_key;
             m_committeeInfoV.push_back(info);
         }
+        buildIndex();
+    }
+
+    void CommitteeSet::buildIndex() {
+        m_accountIndex.clear();
+        m_accountIndex.reserve(m_committeeInfoV.size());
+        for (size_t i = 0; i < m_committeeInfoV.size(); i++) {
+            m_accountIndex.emplace(m_committeeInfoV[i].accountName, i);
+        }
+        m_blsPkBytes.clear();
+        m_blsPkBytes.resize(m_committeeInfoV.size());
+    }
+
+    const std::vector<unsigned char>& CommitteeSet::blsPkBytes(size_t index) const {
+        std::vector<unsigned char>& bytes = m_blsPkBytes[index];
+        if (bytes.empty()) {
+            bytes.resize(Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+            Hex::fromHex<unsigned char>(m_committeeInfoV[index].blsPk, bytes.data(), Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+        }
+        return bytes;
     }
 
     bool CommitteeSet::verify(const BlsVoterSet& blsVoterSet) const {
@@ -42,26 +69,72 @@ namespace ultrainio {
             ilog("bls account pool less next round thresh : ${thresh}", ("thresh", nextRoundThreshold()));
             return false;
         }
-        std::vector<std::string> blsPkV = getBlsPk(blsVoterSet.accountPool);
-        return blsVoterSet.verifyBls(blsPkV);
+        std::vector<unsigned char*> pks;
+        if (!collectBlsPk(blsVoterSet, pks)) {
+            return false;
+        }
+        return blsVoterSet.verifyBls(pks.data(), pks.size());
+    }
+
+    bool CommitteeSet::verify(const std::vector<BlsVoterSet>& blsVoterSetV) const {
+        if (blsVoterSetV.empty()) {
+            return true;
+        }
+        std::vector<const BlsVoterSet*> sets;
+        std::vector<std::vector<unsigned char*>> pks(blsVoterSetV.size());
+        for (size_t i = 0; i < blsVoterSetV.size(); i++) {
+            if (blsVoterSetV[i].accountPool.size() < nextRoundThreshold()) {
+                ilog("bls account pool less next round thresh : ${thresh}", ("thresh", nextRoundThreshold()));
+                return false;
+            }
+            if (!collectBlsPk(blsVoterSetV[i], pks[i])) {
+                return false;
+            }
+            sets.push_back(&blsVoterSetV[i]);
+        }
+        return BlsVoterSet::verifyBlsBatch(sets, pks);
+    }
+
+    bool CommitteeSet::collectBlsPk(const BlsVoterSet& blsVoterSet, std::vector<unsigned char*>& pks) const {
+        pks.reserve(blsVoterSet.accountPool.size());
+        for (const auto& account : blsVoterSet.accountPool) {
+            auto itor = m_accountIndex.find(std::string(account));
+            if (itor == m_accountIndex.end()) {
+                ilog("account ${account} not in committee", ("account", std::string(account)));
+                return false;
+            }
+            pks.push_back(const_cast<unsigned char*>(blsPkBytes(itor->second).data()));
+        }
+        return true;
     }
 
     std::vector<std::string> CommitteeSet::getBlsPk(const std::vector<AccountName>& accountV) const {
         std::vector<std::string> pkV;
-        for (auto v : accountV) {
-            for (auto info : m_committeeInfoV) {
-                if (std::string(v) == info.accountName) {
-                    pkV.push_back(info.blsPk);
-                    break;
-                }
+        pkV.reserve(accountV.size());
+        for (const auto& v : accountV) {
+            auto itor = m_accountIndex.find(std::string(v));
+            if (itor != m_accountIndex.end()) {
+                pkV.push_back(m_committeeInfoV[itor->second].blsPk);
             }
         }
         return pkV;
     }
 
+    std::string CommitteeSet::getPk(const AccountName& account) const {
+        auto itor = m_accountIndex.find(std::string(account));
+        if (itor == m_accountIndex.end()) {
+            return std::string();
+        }
+        return m_committeeInfoV[itor->second].pk;
+    }
+
     SHA256 CommitteeSet::committeeMroot() const {
         // MUST BE the same with StakeOverBase
-        return SHA256::hash(toString());
+        if (!m_mrootCached) {
+            m_cachedMroot = SHA256::hash(toString());
+            m_mrootCached = true;
+        }
+        return m_cachedMroot;
     }
 
     std::vector<char> CommitteeSet::toVectorChar() const {
@@ -72,14 +145,17 @@ namespace ultrainio {
     }
 
     std::string CommitteeSet::toString() const {
-        std::string s;
-        for (int i = 0; i < m_committeeInfoV.size(); i++) {
-            m_committeeInfoV[i].toStrStream(s);
-            if (i != m_committeeInfoV.size() -1) {
-                s.append(CommitteeInfo::kDelimiters);
+        if (m_cachedString.empty() && !m_committeeInfoV.empty()) {
+            std::string s;
+            for (int i = 0; i < m_committeeInfoV.size(); i++) {
+                m_committeeInfoV[i].toStrStream(s);
+                if (i != m_committeeInfoV.size() -1) {
+                    s.append(CommitteeInfo::kDelimiters);
+                }
             }
+            m_cachedString.swap(s);
         }
-        return s;
+        return m_cachedString;
     }
 
     bool CommitteeSet::operator == (const CommitteeSet& rhs) const {
@@ -94,23 +170,27 @@ namespace ultrainio {
     }
 
     CommitteeDelta CommitteeSet::diff(const CommitteeSet& pre) const {
+        // both lists are in reverse order of their source set
         std::list<CommitteeInfo> addCommitteeInfo;
         std::list<CommitteeInfo> removedCommitteeInfo;
-        for (auto itor = m_committeeInfoV.begin(); itor != m_committeeInfoV.end(); itor++) {
-            addCommitteeInfo.push_front(*itor);
-        }
-        for (auto itor = pre.m_committeeInfoV.begin(); itor != pre.m_committeeInfoV.end(); itor++) {
-            addCommitteeInfo.remove(*itor);
-            removedCommitteeInfo.push_front(*itor);
+        for (auto itor = m_committeeInfoV.rbegin(); itor != m_committeeInfoV.rend(); itor++) {
+            if (!pre.contains(*itor)) {
+                addCommitteeInfo.push_back(*itor);
+            }
         }
-
-        for (auto itor = m_committeeInfoV.begin(); itor != m_committeeInfoV.end(); itor++) {
-            removedCommitteeInfo.remove(*itor);
+        for (auto itor = pre.m_committeeInfoV.rbegin(); itor != pre.m_committeeInfoV.rend(); itor++) {
+            if (!contains(*itor)) {
+                removedCommitteeInfo.push_back(*itor);
+            }
         }
-
         return CommitteeDelta(addCommitteeInfo, removedCommitteeInfo);
     }
 
+    bool CommitteeSet::contains(const CommitteeInfo& info) const {
+        auto itor = m_accountIndex.find(info.accountName);
+        return itor != m_accountIndex.end() && m_committeeInfoV[itor->second] == info;
+    }
+
     int CommitteeSet::nextRoundThreshold() const {
         // detail see StakeVoteRandom.cpp realGetNextRoundThreshold
         int kDesiredVoterNumber = 100; // sync with consensus config.h
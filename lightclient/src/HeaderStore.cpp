@@ -0,0 +1,261 @@
+#include <lightclient/HeaderStore.h>
+
+#include <fc/io/raw.hpp>
+
+#define LOG_READ  (std::ios::in | std::ios::binary)
+#define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
+
+namespace ultrainio {
+    // block id + position of the header
+    const size_t HeaderStore::kIndexRecordSize = sizeof(BlockIdType) + sizeof(uint64_t);
+
+    namespace detail {
+        const char* const kHeaderFile = "headers.log";
+        const char* const kIndexFile = "headers.index";
+        const char* const kStateFile = "state.bin";
+
+        struct StoredStartPoint {
+            std::string committeeSet;
+            BlockIdType lastConfirmedBlockId;
+            std::string nextCommitteeMroot;
+            std::string genesisPk;
+        };
+    }
+}
+
+FC_REFLECT(ultrainio::detail::StoredStartPoint, (committeeSet)(lastConfirmedBlockId)(nextCommitteeMroot)(genesisPk))
+
+namespace ultrainio {
+    using namespace detail;
+
+    HeaderStore::HeaderStore(const fc::path& dir) : m_dir(dir) {
+        if (!fc::is_directory(m_dir)) {
+            fc::create_directories(m_dir);
+        }
+        open();
+    }
+
+    HeaderStore::~HeaderStore() {
+        m_headerStream.flush();
+        m_indexStream.flush();
+    }
+
+    void HeaderStore::open() {
+        m_headerStream.close();
+        m_indexStream.close();
+
+        fc::path headerFile = m_dir / kHeaderFile;
+        fc::path indexFile = m_dir / kIndexFile;
+        uint64_t headerSize = fc::exists(headerFile) ? fc::file_size(headerFile) : 0;
+        uint64_t indexSize = fc::exists(indexFile) ? fc::file_size(indexFile) : 0;
+        m_firstBlockNum = 0;
+        m_lastBlockNum = 0;
+        m_lastBlockId = BlockIdType();
+        m_headerSize = 0;
+
+        uint64_t count = 0;
+        if (indexSize >= sizeof(uint32_t)) {
+            std::ifstream index(indexFile.generic_string().c_str(), LOG_READ);
+            std::ifstream headers(headerFile.generic_string().c_str(), LOG_READ);
+            index.read((char*)&m_firstBlockNum, sizeof(m_firstBlockNum));
+            count = (indexSize - sizeof(uint32_t)) / kIndexRecordSize;
+            // a crash may leave a partial record at the end of either file, keep the records up to
+            // the last one whose header is complete and unpacks to the indexed block
+            while (count > 0) {
+                BlockIdType blockId;
+                uint64_t pos = 0;
+                index.seekg(sizeof(uint32_t) + (count - 1) * kIndexRecordSize);
+                index.read(blockId.data(), sizeof(BlockIdType));
+                index.read((char*)&pos, sizeof(pos));
+                BlockHeader blockHeader;
+                uint64_t end = 0;
+                if (index.good() && readRecord(headers, pos, headerSize, blockHeader, end)
+                    && blockHeader.id() == blockId && blockHeader.block_num() == m_firstBlockNum + count - 1) {
+                    m_lastBlockId = blockId;
+                    m_headerSize = end;
+                    break;
+                }
+                index.clear();
+                headers.clear();
+                count--;
+            }
+        }
+        if (count == 0) {
+            m_firstBlockNum = 0;
+        } else {
+            m_lastBlockNum = m_firstBlockNum + count - 1;
+        }
+
+        uint64_t validIndexSize = count == 0 ? 0 : sizeof(uint32_t) + count * kIndexRecordSize;
+        if (headerSize != m_headerSize || indexSize != validIndexSize) {
+            wlog("header store ${dir} recovers to block ${num}, headers ${h} -> ${vh}, index ${i} -> ${vi}",
+                 ("dir", m_dir.generic_string())("num", m_lastBlockNum)("h", headerSize)("vh", m_headerSize)
+                 ("i", indexSize)("vi", validIndexSize));
+            if (headerSize != m_headerSize) {
+                fc::resize_file(headerFile, m_headerSize);
+            }
+            if (indexSize != validIndexSize) {
+                fc::resize_file(indexFile, validIndexSize);
+            }
+        }
+        m_headerStream.open(headerFile.generic_string().c_str(), LOG_WRITE);
+        m_indexStream.open(indexFile.generic_string().c_str(), LOG_WRITE);
+    }
+
+    bool HeaderStore::readRecord(std::istream& headers, uint64_t pos, uint64_t headerSize,
+                                 BlockHeader& blockHeader, uint64_t& end) {
+        uint32_t size = 0;
+        if (pos + sizeof(size) > headerSize) {
+            return false;
+        }
+        headers.seekg(pos);
+        headers.read((char*)&size, sizeof(size));
+        if (!headers.good() || pos + sizeof(size) + size > headerSize) {
+            return false;
+        }
+        std::vector<char> data(size);
+        headers.read(data.data(), size);
+        if (!headers.good()) {
+            return false;
+        }
+        try {
+            blockHeader = fc::raw::unpack<BlockHeader>(data);
+        } catch (const fc::exception& e) {
+            elog("header store unpack error at ${pos} : ${e}", ("pos", pos)("e", e.to_string()));
+            return false;
+        }
+        end = pos + sizeof(size) + size;
+        return true;
+    }
+
+    void HeaderStore::append(const BlockHeader& blockHeader) {
+        uint32_t blockNum = blockHeader.block_num();
+        if (!empty()) {
+            if (blockNum <= m_lastBlockNum) {
+                BlockHeader stored;
+                if (read(blockNum, stored) && stored.id() == blockHeader.id()) {
+                    return;
+                }
+                wlog("header store rewinds to ${num}", ("num", blockNum));
+                truncate(blockNum);
+            } else if (blockNum != m_lastBlockNum + 1) {
+                wlog("header store gap from ${last} to ${num}, reset", ("last", m_lastBlockNum)("num", blockNum));
+                reset();
+            }
+        }
+        if (empty()) {
+            m_firstBlockNum = blockNum;
+            m_indexStream.write((const char*)&m_firstBlockNum, sizeof(m_firstBlockNum));
+        }
+
+        std::vector<char> data = fc::raw::pack(blockHeader);
+        uint32_t size = data.size();
+        uint64_t pos = m_headerSize;
+        m_headerStream.write((const char*)&size, sizeof(size));
+        m_headerStream.write(data.data(), data.size());
+        m_lastBlockId = blockHeader.id();
+        m_indexStream.write(m_lastBlockId.data(), sizeof(BlockIdType));
+        m_indexStream.write((const char*)&pos, sizeof(pos));
+        m_headerStream.flush();
+        m_indexStream.flush();
+
+        m_headerSize += sizeof(size) + size;
+        m_lastBlockNum = blockNum;
+    }
+
+    bool HeaderStore::read(uint32_t blockNum, BlockHeader& blockHeader) const {
+        if (empty() || blockNum < m_firstBlockNum || blockNum > m_lastBlockNum) {
+            return false;
+        }
+        uint64_t pos = 0;
+        std::ifstream index((m_dir / kIndexFile).generic_string().c_str(), LOG_READ);
+        index.seekg(sizeof(uint32_t) + uint64_t(blockNum - m_firstBlockNum) * kIndexRecordSize + sizeof(BlockIdType));
+        index.read((char*)&pos, sizeof(pos));
+
+        uint64_t end = 0;
+        std::ifstream headers((m_dir / kHeaderFile).generic_string().c_str(), LOG_READ);
+        if (!index.good() || !readRecord(headers, pos, m_headerSize, blockHeader, end)) {
+            elog("header store read error at ${num}", ("num", blockNum));
+            return false;
+        }
+        return true;
+    }
+
+    bool HeaderStore::empty() const {
+        return m_lastBlockNum == 0;
+    }
+
+    uint32_t HeaderStore::firstBlockNum() const {
+        return m_firstBlockNum;
+    }
+
+    uint32_t HeaderStore::lastBlockNum() const {
+        return m_lastBlockNum;
+    }
+
+    BlockIdType HeaderStore::lastBlockId() const {
+        return m_lastBlockId;
+    }
+
+    void HeaderStore::saveStartPoint(const StartPoint& startPoint) {
+        StoredStartPoint stored{startPoint.committeeSet.toString(), startPoint.lastConfirmedBlockId,
+                                startPoint.nextCommitteeMroot, startPoint.genesisPk};
+        std::vector<char> data = fc::raw::pack(stored);
+        fc::path tmp = m_dir / (std::string(kStateFile) + ".tmp");
+        {
+            std::ofstream out(tmp.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            out.write(data.data(), data.size());
+        }
+        fc::rename(tmp, m_dir / kStateFile);
+    }
+
+    bool HeaderStore::loadStartPoint(StartPoint& startPoint) const {
+        fc::path file = m_dir / kStateFile;
+        if (!fc::exists(file)) {
+            return false;
+        }
+        try {
+            std::vector<char> data(fc::file_size(file));
+            std::ifstream in(file.generic_string().c_str(), LOG_READ);
+            in.read(data.data(), data.size());
+            StoredStartPoint stored = fc::raw::unpack<StoredStartPoint>(data);
+            startPoint.committeeSet = CommitteeSet(stored.committeeSet);
+            startPoint.lastConfirmedBlockId = stored.lastConfirmedBlockId;
+            startPoint.nextCommitteeMroot = stored.nextCommitteeMroot;
+            startPoint.genesisPk = stored.genesisPk;
+            return true;
+        } catch (const fc::exception& e) {
+            elog("load light client state error : ${e}", ("e", e.to_string()));
+        }
+        return false;
+    }
+
+    void HeaderStore::reset() {
+        m_headerStream.close();
+        m_indexStream.close();
+        fc::resize_file(m_dir / kHeaderFile, 0);
+        fc::resize_file(m_dir / kIndexFile, 0);
+        open();
+    }
+
+    void HeaderStore::truncate(uint32_t blockNum) {
+        if (blockNum <= m_firstBlockNum) {
+            reset();
+            return;
+        }
+        uint64_t pos = 0;
+        {
+            std::ifstream in((m_dir / kIndexFile).generic_string().c_str(), LOG_READ);
+            in.seekg(sizeof(uint32_t) + uint64_t(blockNum - m_firstBlockNum) * kIndexRecordSize + sizeof(BlockIdType));
+            in.read((char*)&pos, sizeof(pos));
+            if (!in.good()) {
+                pos = m_headerSize;
+            }
+        }
+        m_headerStream.close();
+        m_indexStream.close();
+        fc::resize_file(m_dir / kHeaderFile, pos);
+        fc::resize_file(m_dir / kIndexFile, sizeof(uint32_t) + uint64_t(blockNum - m_firstBlockNum) * kIndexRecordSize);
+        open();
+    }
+}
@@ -140,37 +140,53 @@ namespace ultrainio {
                 confirmPointList.push_back(ConfirmPoint(v));
             }
         }
+        // confirm points signed by the current working committee, verified together
+        // right before the committee changes or when the list is done
+        std::vector<BlsVoterSet> pendingBlsVoterSet;
+        auto verifyPending = [&]() -> bool {
+            bool res = m_workingCommitteeSet.verify(pendingBlsVoterSet);
+            if (!res) {
+                elog("verify bls error, ${n} confirm points up to num : ${num} committee : ${c}",
+                        ("n", pendingBlsVoterSet.size())("num", BlockHeader::num_from_id(pendingBlsVoterSet.back().commonEchoMsg.blockId))("c", m_workingCommitteeSet.toString()));
+            }
+            pendingBlsVoterSet.clear();
+            return res;
+        };
+        auto updateCommitteeSet = [&](const BlockHeader& blockHeader) -> bool {
+            if (!pendingBlsVoterSet.empty() && !verifyPending()) {
+                return false;
+            }
+            return checkAndUpdateCommitteeSet(blockHeader, m_nextCommitteeMroot, m_workingCommitteeSet);
+        };
+
         auto itor = blockHeaderList.begin();
         for (; itor != blockHeaderList.end(); itor++) {
             bool isConfirmed = false;
             for (auto v : confirmPointList) {
                 if (itor->id() == v.confirmedBlockId()) {
                     if (CheckPoint::isCheckPoint(*itor)) { // update Committee Set if CheckPoint is confirmed
-                        if (!checkAndUpdateCommitteeSet(*itor, m_nextCommitteeMroot, m_workingCommitteeSet)) {
+                        if (!updateCommitteeSet(*itor)) {
                             return false;
                         }
                     }
-                    if (!m_workingCommitteeSet.verify(v.blsVoterSet())) {
-                        elog("verify bls error, id : ${id} num : ${num} set : ${set} committee : ${c}",
-                                ("id", itor->id())("num", BlockHeader::num_from_id(itor->id()))("set", v.blsVoterSet().toString())("c", m_workingCommitteeSet.toString()));
-                        return false;
-                    }
+                    pendingBlsVoterSet.push_back(v.blsVoterSet());
                     isConfirmed = true;
                 }
             }
             if (itor->id() == blsVoterSet.commonEchoMsg.blockId) {
                 // update Committee Set if CheckPoint is confirmed
                 if (CheckPoint::isCheckPoint(*itor)) {
-                    if (!checkAndUpdateCommitteeSet(*itor, m_nextCommitteeMroot, m_workingCommitteeSet)) {
+                    if (!updateCommitteeSet(*itor)) {
                         return false;
                     }
                 }
-                return m_workingCommitteeSet.verify(blsVoterSet);
+                pendingBlsVoterSet.push_back(blsVoterSet);
+                return verifyPending();
             }
 
             // MUST before EpochEndPoint::isEpochEndPoint check, because a block header may be EpochEndPoint and CheckPoint at the same time
             if (CheckPoint::isCheckPoint(*itor)) {
-                if (!checkAndUpdateCommitteeSet(*itor, m_nextCommitteeMroot, m_workingCommitteeSet)) {
+                if (!updateCommitteeSet(*itor)) {
                     return false;
                 }
             }
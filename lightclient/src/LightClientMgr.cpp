@@ -1,5 +1,6 @@
 #include <lightclient/LightClientMgr.h>
 
+#include <lightclient/HeaderStore.h>
 #include <lightclient/LightClient.h>
 #include <lightclient/LightClientProducer.h>
 
@@ -23,4 +24,21 @@ namespace ultrainio {
         m_lightClientList.push_back(lightClient);
         return lightClient;
     }
+
+    std::shared_ptr<HeaderStore> LightClientMgr::getHeaderStore(uint64_t chainName) {
+        if (m_storeDir == fc::path()) {
+            return nullptr;
+        }
+        auto itor = m_headerStoreMap.find(chainName);
+        if (itor != m_headerStoreMap.end()) {
+            return itor->second;
+        }
+        std::shared_ptr<HeaderStore> headerStore = std::make_shared<HeaderStore>(m_storeDir / chain::name(chainName).to_string());
+        m_headerStoreMap[chainName] = headerStore;
+        return headerStore;
+    }
+
+    void LightClientMgr::setStoreDir(const fc::path& storeDir) {
+        m_storeDir = storeDir;
+    }
 }
\ No newline at end of file
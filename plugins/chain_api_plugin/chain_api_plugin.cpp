@@ -82,6 +82,8 @@ void chain_api_plugin::plugin_startup() {
       CHAIN_RO_CALL(get_block_info, 200),
       CHAIN_RO_CALL(get_merkle_proof, 200),
       CHAIN_RO_CALL(verify_merkle_proof, 200),
+      CHAIN_RO_CALL(get_merkle_proofs, 200),
+      CHAIN_RO_CALL(verify_merkle_multi_proof, 200),
       CHAIN_RO_CALL(get_block_header_state, 200),
       CHAIN_RO_CALL(get_account_info, 200),
       CHAIN_RO_CALL(get_account_exist, 200),
@@ -108,6 +110,7 @@ void chain_api_plugin::plugin_startup() {
       CHAIN_RO_CALL(abi_bin2json, 200),
       CHAIN_RO_CALL(get_required_keys, 200),
       CHAIN_RO_CALL(get_whiteblacklist, 200),
+      CHAIN_RO_CALL(get_signature_cache_stats, 200),
       //      CHAIN_RW_CALL_ASYNC(push_block, chain_apis::read_write::push_block_results, 202),
       CHAIN_RW_CALL_ASYNC(push_tx, chain_apis::read_write::push_tx_results, 202),
       //      CHAIN_RW_CALL_ASYNC(push_txs, chain_apis::read_write::push_txs_results, 202),
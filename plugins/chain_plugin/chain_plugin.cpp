@@ -41,6 +41,7 @@
 #include <core/types.h>
 #include <lightclient/CommitteeSet.h>
 #include <lightclient/EpochEndPoint.h>
+#include <lightclient/HeaderStore.h>
 #include <lightclient/LightClient.h>
 #include <lightclient/LightClientMgr.h>
 #include <lightclient/LightClientProducer.h>
@@ -118,7 +119,9 @@ using boost::signals2::scoped_connection;
       NEXT(e.dynamic_copy_exception());\
    }
 
+using ultrainio::HeaderStore;
 using ultrainio::LightClient;
+using ultrainio::LightClientCallback;
 using ultrainio::CommitteeSet;
 using ultrainio::LightClientMgr;
 using ultrainio::Evidence;
@@ -130,32 +133,93 @@ public:
     light_client_callback() {
     }
 
+    // A light client is built from the start point of the db on every call, so the result only depends on the db:
+    // headers of failed, speculative or forked out calls can not change it, and nothing is written to disk here.
     bool on_accept_block_header(uint64_t chainName, const chain::signed_block_header &blockHeader, BlockIdType &id) {
         ilog("on_accept_block_header chain : ${chainName}, blockNum : ${blockNum}",
              ("chainName", name(chainName))("blockNum", blockHeader.block_num()));
-        std::shared_ptr<LightClient> lightClient = LightClientMgr::getInstance()->getLightClient(chainName);
+        LightClient lightClient(chainName);
+        std::shared_ptr<confirmed_header_collector> collector = std::make_shared<confirmed_header_collector>();
+        lightClient.addCallback(collector);
         std::vector<signed_block_header> unconfirmedheaders;
         StartPoint startPoint;
-        if (std::string(blockHeader.proposer) == std::string("genesis")) {
-            if (getUnconfirmedHeaderFromDb(name(chainName), unconfirmedheaders, startPoint)) {
-                lightClient->setStartPoint(startPoint);
-                lightClient->accept(blockHeader, blockHeader.signature);
-                id = lightClient->getLatestConfirmedBlockId();
-                return lightClient->getStatus();
-            }
-        } else {
-            if (getUnconfirmedHeaderFromDb(name(chainName), unconfirmedheaders, startPoint)) {
-                lightClient->setStartPoint(startPoint);
+        if (getUnconfirmedHeaderFromDb(name(chainName), unconfirmedheaders, startPoint)) {
+            lightClient.setStartPoint(startPoint);
+            if (std::string(blockHeader.proposer) != std::string("genesis")) {
                 for (auto e : unconfirmedheaders) {
-                    lightClient->accept(e, e.signature);
+                    lightClient.accept(e, e.signature);
+                }
+            }
+            lightClient.accept(blockHeader, blockHeader.signature);
+            addConfirmedHeaders(chainName, collector->headers);
+        }
+        id = lightClient.getLatestConfirmedBlockId();
+        return lightClient.getStatus();
+    }
+
+    // Called for an irreversible block while the db holds its state. The headers the db confirms by then are
+    // irreversible, they are written to the header store by a task run after the block is applied.
+    void on_irreversible_block(const chain::block_state_ptr& blk) {
+        struct store_task {
+            uint64_t chainName;
+            std::list<BlockHeader> headers;
+            StartPoint startPoint;
+        };
+        std::vector<store_task> tasks;
+        {
+            std::lock_guard<std::mutex> g(m_confirmedMutex);
+            if (m_confirmedHeaders.empty()) {
+                return;
+            }
+            chain::controller& chain = appbase::app().get_plugin<chain_plugin>().chain();
+            const auto& pbs = chain.pending_block_state();
+            if (pbs ? pbs->id != blk->id : chain.head_block_id() != blk->id) {
+                return;
+            }
+            for (auto chainItor = m_confirmedHeaders.begin(); chainItor != m_confirmedHeaders.end();) {
+                auto& headerMap = chainItor->second;
+                std::vector<signed_block_header> unconfirmedheaders;
+                store_task task;
+                task.chainName = chainItor->first;
+                if (!getUnconfirmedHeaderFromDb(name(task.chainName), unconfirmedheaders, task.startPoint)) {
+                    ++chainItor;
+                    continue;
                 }
-                lightClient->accept(blockHeader, blockHeader.signature);
-                id = lightClient->getLatestConfirmedBlockId();
-                return lightClient->getStatus();
+                // the headers the db confirms, walked back from its confirmed block
+                BlockIdType blockId = task.startPoint.lastConfirmedBlockId;
+                for (auto itor = headerMap.find(blockId); itor != headerMap.end(); itor = headerMap.find(blockId)) {
+                    task.headers.push_front(itor->second);
+                    blockId = itor->second.previous;
+                }
+                uint32_t confirmedNum = BlockHeader::num_from_id(task.startPoint.lastConfirmedBlockId);
+                for (auto itor = headerMap.begin(); itor != headerMap.end();) {
+                    if (itor->second.block_num() <= confirmedNum) {
+                        itor = headerMap.erase(itor);
+                    } else {
+                        ++itor;
+                    }
+                }
+                if (!task.headers.empty()) {
+                    tasks.push_back(std::move(task));
+                }
+                chainItor = headerMap.empty() ? m_confirmedHeaders.erase(chainItor) : std::next(chainItor);
             }
         }
-        id = lightClient->getLatestConfirmedBlockId();
-        return lightClient->getStatus();
+        if (tasks.empty()) {
+            return;
+        }
+        appbase::app().get_io_service().post([tasks]() {
+            for (const auto& task : tasks) {
+                std::shared_ptr<HeaderStore> headerStore = LightClientMgr::getInstance()->getHeaderStore(task.chainName);
+                if (!headerStore) {
+                    continue;
+                }
+                for (const auto& header : task.headers) {
+                    headerStore->append(header);
+                }
+                headerStore->saveStartPoint(task.startPoint);
+            }
+        });
     }
 
     bool on_replay_block(const chain::block_header& header) {
@@ -176,6 +240,27 @@ public:
     }
 
 private:
+    class confirmed_header_collector : public LightClientCallback {
+    public:
+        void onConfirmed(const std::list<BlockHeader>& blockHeaderList) override {
+            headers.insert(headers.end(), blockHeaderList.begin(), blockHeaderList.end());
+        }
+
+        std::list<BlockHeader> headers;
+    };
+
+    // kept until the db confirms them or a header at the same height, transactions may run on several threads
+    void addConfirmedHeaders(uint64_t chainName, const std::list<BlockHeader>& headers) {
+        if (headers.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> g(m_confirmedMutex);
+        auto& headerMap = m_confirmedHeaders[chainName];
+        for (const auto& header : headers) {
+            headerMap[header.id()] = header;
+        }
+    }
+
     bool getUnconfirmedHeaderFromDb(const chain::name &chainName, std::vector<signed_block_header> &unconfirmedBlockHeader, StartPoint& startPoint) {
         try {
             const auto &ro_api = appbase::app().get_plugin<chain_plugin>().get_read_only_api();
@@ -199,6 +284,11 @@ private:
     };
 
     std::shared_ptr<LightClientProducer> m_lightClientProducer;
+
+    std::mutex m_confirmedMutex;
+
+    // chain name -> headers confirmed by on_accept_block_header, by block id
+    std::map<uint64_t, std::map<BlockIdType, BlockHeader>> m_confirmedHeaders;
 };
 
 class chain_plugin_impl {
@@ -227,6 +317,7 @@ public:
    //txn_msg_rate_limits              rate_limits;
    fc::microseconds                 abi_serializer_max_time_ms;
    fc::optional<bfs::path>          worldstate_path;
+   std::shared_ptr<light_client_callback> light_client_cb;
    std::string _genesis_time = std::string();
    std::string _chain_name   = std::string();
 
@@ -272,15 +363,31 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
    cfg.add_options()
          ("blocks-dir", bpo::value<bfs::path>()->default_value("blocks"),
           "the location of the blocks directory (absolute path or relative to application data dir)")
+         ("lightclient-dir", bpo::value<bfs::path>()->default_value("lightclient"),
+          "the location of the light client header store directory (absolute path or relative to application data dir)")
          ("worldstate", bpo::value<bfs::path>(), "File to read Worldstate State from")
          ("worldstate-control", bpo::bool_switch()->default_value(false), "Enable worldstate generation")
+         ("worldstate-restore-threads", bpo::value<uint16_t>()->default_value(config::default_worldstate_restore_threads),
+          "Number of threads restoring the sections of a worldstate, 1 restores them one after another")
          ("checkpoint", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_ms),
           "Override default maximum ABI serialization time allowed in ms")
+         ("signature-cache-size", bpo::value<uint32_t>()->default_value(config::default_signature_cache_size),
+          "Number of public keys recovered from transaction signatures to keep, 0 to disable the cache")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
          ("chain-state-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the chain state database drops below this size (in MiB).")
+         ("chain-state-db-huge-pages", bpo::value<string>()->default_value("none"),
+          "Pages backing the chain state database: none, transparent (madvise huge pages) or hugetlbfs (the state directory must be on a hugetlbfs mount)")
+         ("chain-state-db-prefault", bpo::bool_switch()->default_value(false),
+          "Fault the whole chain state database into memory at startup")
+         ("chain-state-db-mlock", bpo::bool_switch()->default_value(false),
+          "Lock the chain state database in memory, RLIMIT_MEMLOCK must allow its size")
+         ("chain-state-db-numa", bpo::value<string>()->default_value("default"),
+          "NUMA policy of the chain state database: default, interleave, interleave:<nodes> or bind:<nodes>, where nodes is a comma separated list")
          ("contracts-console", bpo::bool_switch()->default_value(false),
           "print contract's output to console")
+         ("wasm-checktime-watchdog", bpo::value<bool>()->default_value(true),
+          "use a watchdog thread to flag transaction deadlines instead of reading the clock on every checktime")
          ("masterchain", bpo::bool_switch()->default_value(false),
           "if the chain is running as main chain")
          ("read-mode", boost::program_options::value<ultrainio::chain::db_read_mode>()->default_value(ultrainio::chain::db_read_mode::SPECULATIVE),
@@ -362,7 +469,8 @@ fc::time_point calculate_genesis_timestamp( string tstr ) {
 void chain_plugin::plugin_initialize(const variables_map& options) {
    ilog("initializing chain plugin");
 
-   ultrainio::chain::callback_manager::get_self()->register_callback(std::make_shared<light_client_callback>());
+   my->light_client_cb = std::make_shared<light_client_callback>();
+   ultrainio::chain::callback_manager::get_self()->register_callback(my->light_client_cb);
    try {
       try {
          genesis_state gs; // Check if ULTRAINIO_ROOT_KEY is bad
@@ -409,6 +517,11 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
             my->blocks_dir = bld;
       }
 
+      if( options.count( "lightclient-dir" )) {
+         auto lcd = options.at( "lightclient-dir" ).as<bfs::path>();
+         LightClientMgr::getInstance()->setStoreDir( lcd.is_relative() ? app().data_dir() / lcd : lcd );
+      }
+
       if( options.count("checkpoint") ) {
          auto cps = options.at("checkpoint").as<vector<string>>();
          my->loaded_checkpoints.reserve(cps.size());
@@ -430,6 +543,9 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       if(options.count("abi-serializer-max-time-ms"))
          my->abi_serializer_max_time_ms = fc::microseconds(options.at("abi-serializer-max-time-ms").as<uint32_t>() * 1000);
 
+      if(options.count("signature-cache-size"))
+         signature_recovery_cache::instance().set_capacity(options.at("signature-cache-size").as<uint32_t>());
+
       my->chain_config->blocks_dir = my->blocks_dir;
       my->chain_config->state_dir = app().data_dir() / config::default_state_dir_name;
       my->chain_config->read_only = my->readonly;
@@ -440,9 +556,52 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       if( options.count( "chain-state-db-guard-size-mb" ))
          my->chain_config->state_guard_size = options.at( "chain-state-db-guard-size-mb" ).as<uint64_t>() * 1024 * 1024;
 
+      {
+         auto& mapping = my->chain_config->state_mapping;
+         const auto pages = options.at( "chain-state-db-huge-pages" ).as<string>();
+         if( pages == "transparent" ) {
+            mapping.pages = chainbase::mapping_options::transparent_huge_pages;
+         } else if( pages == "hugetlbfs" ) {
+            mapping.pages = chainbase::mapping_options::hugetlbfs_pages;
+         } else {
+            ULTRAIN_ASSERT( pages == "none", plugin_config_exception, "unknown chain-state-db-huge-pages: ${p}", ("p", pages) );
+         }
+         mapping.prefault = options.at( "chain-state-db-prefault" ).as<bool>();
+         mapping.lock = options.at( "chain-state-db-mlock" ).as<bool>();
+
+         const auto numa = options.at( "chain-state-db-numa" ).as<string>();
+         auto colon = numa.find( ':' );
+         const auto policy = numa.substr( 0, colon );
+         if( policy == "interleave" ) {
+            mapping.numa = chainbase::mapping_options::numa_interleave;
+         } else if( policy == "bind" ) {
+            mapping.numa = chainbase::mapping_options::numa_bind;
+         } else {
+            ULTRAIN_ASSERT( numa == "default", plugin_config_exception, "unknown chain-state-db-numa: ${p}", ("p", numa) );
+         }
+         if( colon != string::npos ) {
+            const auto node_list = numa.substr( colon + 1 );
+            vector<string> nodes;
+            boost::split( nodes, node_list, boost::is_any_of( "," ) );
+            for( const auto& node : nodes ) {
+               try {
+                  mapping.numa_nodes.push_back( boost::lexical_cast<uint32_t>( node ) );
+               } catch( const boost::bad_lexical_cast& ) {
+                  ULTRAIN_THROW( plugin_config_exception, "invalid numa node in chain-state-db-numa: ${n}", ("n", node) );
+               }
+            }
+         }
+         ULTRAIN_ASSERT( mapping.numa != chainbase::mapping_options::numa_bind || !mapping.numa_nodes.empty(),
+                         plugin_config_exception, "chain-state-db-numa bind requires a node list, e.g. bind:0" );
+      }
+
       my->chain_config->worldstate_control = options.at( "worldstate-control" ).as<bool>();
+      my->chain_config->worldstate_restore_threads = options.at( "worldstate-restore-threads" ).as<uint16_t>();
+      ULTRAIN_ASSERT( my->chain_config->worldstate_restore_threads > 0, plugin_config_exception,
+                      "worldstate-restore-threads must be positive" );
       my->chain_config->force_all_checks = options.at( "force-all-checks" ).as<bool>();
       my->chain_config->contracts_console = options.at( "contracts-console" ).as<bool>();
+      my->chain_config->checktime_watchdog = options.at( "wasm-checktime-watchdog" ).as<bool>();
 
       if( options.count( "extract-genesis-json" ) || options.at( "print-genesis-json" ).as<bool>()) {
          genesis_state gs;
@@ -633,6 +792,7 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
 
       my->irreversible_block_connection = my->chain->irreversible_block.connect( [this]( const block_state_ptr& blk ) {
          my->irreversible_block_channel.publish( blk );
+         my->light_client_cb->on_irreversible_block( blk );
       } );
 
       my->accepted_transaction_connection = my->chain->accepted_transaction.connect(
@@ -1649,6 +1809,51 @@ read_only::verify_merkle_proof_result read_only::verify_merkle_proof(const read_
    return result;
 }
 
+read_only::get_merkle_proofs_result read_only::get_merkle_proofs(const read_only::get_merkle_proofs_params& params) {
+   read_only::get_merkle_proofs_result result;
+   ULTRAIN_ASSERT( params.trx_ids.size() <= config::max_merkle_proofs_trx_ids, invalid_http_request,
+                   "Too many trx ids: ${n}, at most ${max} per request",
+                   ("n", params.trx_ids.size())("max", config::max_merkle_proofs_trx_ids) );
+   // the tree is built once per block and cached, every proof is then a walk up the tree
+   auto tree = db.receipt_merkle_tree_of(params.block_number);
+   ULTRAIN_ASSERT( tree, unknown_block_exception, "Could not find block: ${block}", ("block", params.block_number));
+
+   result.transaction_mroot = tree->block()->transaction_mroot;
+   result.proofs.reserve(params.trx_ids.size());
+   vector<uint32_t> positions;
+   for (const auto& trx_id : params.trx_ids) {
+      merkle_proof_entry entry;
+      entry.trx_id = trx_id;
+      auto pos = tree->position_of(trx_id);
+      if (pos >= 0) {
+         entry.merkle_proof = tree->proof_of(pos);
+         entry.trx_receipt_bytes = fc::raw::pack(tree->block()->transactions[pos]);
+         positions.push_back(pos);
+      }
+      result.proofs.emplace_back(std::move(entry));
+   }
+   if (params.multi_proof && !positions.empty()) {
+      result.multi_proof = tree->multi_proof_of(positions);
+   }
+   return result;
+}
+
+read_only::verify_merkle_proof_result read_only::verify_merkle_multi_proof(const read_only::verify_merkle_multi_proof_params& params) {
+   read_only::verify_merkle_proof_result result;
+   result.is_matched = false;
+   if (params.transaction_mroot == digest_type() ||
+       params.trx_receipt_bytes.size() != params.multi_proof.positions.size()) {
+      return result;
+   }
+   vector<digest_type> leaves;
+   leaves.reserve(params.trx_receipt_bytes.size());
+   for (const auto& bytes : params.trx_receipt_bytes) {
+      leaves.emplace_back(fc::raw::unpack<transaction_receipt>(bytes).digest());
+   }
+   result.is_matched = chain::merkle_multi_proof_root(params.multi_proof, leaves) == params.transaction_mroot;
+   return result;
+}
+
 fc::variant read_only::get_block_header_state(const get_block_header_state_params& params) const {
    block_state_ptr b;
    optional<uint64_t> block_num;
@@ -2107,5 +2312,9 @@ read_only::get_whiteblacklist_result read_only::get_whiteblacklist( const get_wh
     return result;
 }
 
+read_only::get_signature_cache_stats_result read_only::get_signature_cache_stats( const get_signature_cache_stats_params& )const {
+    return signature_recovery_cache::instance().get_stats();
+}
+
 } // namespace chain_apis
 } // namespace ultrainio
@@ -11,6 +11,7 @@
 #include <ultrainio/chain/controller.hpp>
 #include <ultrainio/chain/contract_table_objects.hpp>
 #include <ultrainio/chain/resource_limits.hpp>
+#include <ultrainio/chain/signature_recovery_cache.hpp>
 #include <ultrainio/chain/transaction.hpp>
 #include <ultrainio/chain/abi_serializer.hpp>
 #include <ultrainio/chain/plugin_interface.hpp>
@@ -245,6 +246,11 @@ public:
 
    get_whiteblacklist_result get_whiteblacklist( const get_whiteblacklist_params& )const;
 
+   using get_signature_cache_stats_params = empty;
+   using get_signature_cache_stats_result = chain::signature_recovery_cache::stats;
+
+   get_signature_cache_stats_result get_signature_cache_stats( const get_signature_cache_stats_params& )const;
+
    struct get_block_info_params {
       string block_num_or_id;
    };
@@ -509,6 +515,38 @@ public:
 
    verify_merkle_proof_result verify_merkle_proof(const verify_merkle_proof_params& params);
 
+   struct get_merkle_proofs_params {
+      uint32_t                   block_number;
+      /// at most config::max_merkle_proofs_trx_ids
+      vector<chain::digest_type> trx_ids;
+      /// also return one merkle_multi_proof of all the found trxs
+      bool                       multi_proof = false;
+   };
+
+   struct merkle_proof_entry {
+      chain::digest_type         trx_id;
+      /// empty if the trx is not in the block
+      vector<chain::digest_type> merkle_proof;
+      vector<char>               trx_receipt_bytes;
+   };
+
+   struct get_merkle_proofs_result {
+      chain::digest_type                        transaction_mroot;
+      vector<merkle_proof_entry>                proofs;
+      fc::optional<chain::merkle_multi_proof>   multi_proof;
+   };
+
+   get_merkle_proofs_result get_merkle_proofs(const get_merkle_proofs_params& params);
+
+   struct verify_merkle_multi_proof_params {
+      chain::merkle_multi_proof  multi_proof;
+      chain::digest_type         transaction_mroot;
+      /// receipts at multi_proof.positions, in the same order
+      vector<vector<char>>       trx_receipt_bytes;
+   };
+
+   verify_merkle_proof_result verify_merkle_multi_proof(const verify_merkle_multi_proof_params& params);
+
    static void copy_inline_row(const chain::key_value_object& obj, vector<char>& data) {
       data.resize( obj.value.size() );
       memcpy( data.data(), obj.value.data(), obj.value.size() );
@@ -859,3 +897,7 @@ FC_REFLECT( ultrainio::chain_apis::read_only::get_merkle_proof_params, (block_nu
 FC_REFLECT( ultrainio::chain_apis::read_only::get_merkle_proof_result, (merkle_proof)(trx_receipt_bytes));
 FC_REFLECT( ultrainio::chain_apis::read_only::verify_merkle_proof_params, (merkle_proof)(transaction_mroot)(trx_receipt_bytes));
 FC_REFLECT( ultrainio::chain_apis::read_only::verify_merkle_proof_result, (is_matched));
+FC_REFLECT( ultrainio::chain_apis::read_only::get_merkle_proofs_params, (block_number)(trx_ids)(multi_proof));
+FC_REFLECT( ultrainio::chain_apis::read_only::merkle_proof_entry, (trx_id)(merkle_proof)(trx_receipt_bytes));
+FC_REFLECT( ultrainio::chain_apis::read_only::get_merkle_proofs_result, (transaction_mroot)(proofs)(multi_proof));
+FC_REFLECT( ultrainio::chain_apis::read_only::verify_merkle_multi_proof_params, (multi_proof)(transaction_mroot)(trx_receipt_bytes));
@@ -0,0 +1,421 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#include <ultrainio/history_export_plugin/columnar_segment.hpp>
+#include <ultrainio/chain/exceptions.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+namespace ultrainio { namespace history_export {
+
+using namespace ultrainio::chain;
+namespace bio = boost::iostreams;
+
+namespace {
+   const uint64_t segment_magic = 0x31474553524c4f43; // "COLRSEG1"
+
+   std::vector<char> zlib_compress(const std::vector<char>& in) {
+      std::vector<char> out;
+      bio::filtering_ostream comp;
+      comp.push(bio::zlib_compressor(bio::zlib::best_speed));
+      comp.push(bio::back_inserter(out));
+      bio::write(comp, in.data(), in.size());
+      bio::close(comp);
+      return out;
+   }
+
+   std::vector<char> zlib_decompress(const std::vector<char>& in, uint64_t raw_size) {
+      std::vector<char> out;
+      out.reserve(raw_size);
+      bio::filtering_ostream decomp;
+      decomp.push(bio::zlib_decompressor());
+      decomp.push(bio::back_inserter(out));
+      bio::write(decomp, in.data(), in.size());
+      bio::close(decomp);
+      ULTRAIN_ASSERT(out.size() == raw_size, chain::plugin_exception, "history segment column size mismatch");
+      return out;
+   }
+
+   /// append only buffer of one column
+   struct column_buffer {
+      std::vector<char> data;
+
+      void put_varint(uint64_t v) {
+         while (v >= 0x80) {
+            data.push_back(char(v | 0x80));
+            v >>= 7;
+         }
+         data.push_back(char(v));
+      }
+
+      void put_zigzag(int64_t v) {
+         put_varint((uint64_t(v) << 1) ^ uint64_t(v >> 63));
+      }
+
+      void put_bytes(const char* p, size_t n) {
+         data.insert(data.end(), p, p + n);
+      }
+
+      template<typename T>
+      void put(const T& v) {
+         auto packed = fc::raw::pack(v);
+         put_bytes(packed.data(), packed.size());
+      }
+   };
+
+   struct column_cursor {
+      const std::vector<char>& data;
+      size_t pos = 0;
+
+      explicit column_cursor(const std::vector<char>& d) : data(d) {}
+
+      uint64_t get_varint() {
+         uint64_t v = 0;
+         for (int shift = 0; ; shift += 7) {
+            ULTRAIN_ASSERT(pos < data.size() && shift < 64, chain::plugin_exception, "corrupted history segment column");
+            uint8_t b = data[pos++];
+            v |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80))
+               return v;
+         }
+      }
+
+      int64_t get_zigzag() {
+         uint64_t v = get_varint();
+         return int64_t(v >> 1) ^ -int64_t(v & 1);
+      }
+
+      const char* get_bytes(size_t n) {
+         ULTRAIN_ASSERT(pos + n <= data.size(), chain::plugin_exception, "corrupted history segment column");
+         const char* p = data.data() + pos;
+         pos += n;
+         return p;
+      }
+
+      template<typename T>
+      T get() {
+         fc::datastream<const char*> ds(data.data() + pos, data.size() - pos);
+         T v;
+         fc::raw::unpack(ds, v);
+         pos += ds.tellp();
+         return v;
+      }
+   };
+
+   const char* const trx_columns[] = {
+      "trx.id", "trx.block_num", "trx.block_time", "trx.status", "trx.cpu_usage_us", "trx.net_usage_words", "trx.action_count"
+   };
+   const char* const action_columns[] = {
+      "act.trx_row", "act.global_sequence", "act.receiver", "act.account", "act.name", "act.auth", "act.data",
+      "act.elapsed_us", "act.cpu_usage", "act.console"
+   };
+}
+
+const char* const segment_writer::extension = ".seg";
+
+class segment_writer::columns {
+   public:
+      fc::path                                 dir;
+      uint32_t                                 first_block = 0;
+      uint32_t                                 last_block = 0;
+      uint32_t                                 trx_rows = 0;
+      uint32_t                                 action_rows = 0;
+      std::vector<uint64_t>                    dictionary;
+      std::unordered_map<uint64_t, uint32_t>   dictionary_index;
+      std::vector<action_name>                 action_names;
+      std::unordered_map<action_name, uint32_t> action_name_index;
+      std::map<std::string, column_buffer>     buffers;
+
+      uint32_t prev_block_num = 0;
+      uint64_t prev_global_sequence = 0;
+      uint32_t prev_trx_row = 0;
+
+      void reset() {
+         first_block = last_block = 0;
+         trx_rows = action_rows = 0;
+         dictionary.clear();
+         dictionary_index.clear();
+         action_names.clear();
+         action_name_index.clear();
+         buffers.clear();
+         prev_block_num = 0;
+         prev_global_sequence = 0;
+         prev_trx_row = 0;
+      }
+
+      uint32_t name_index(name n) {
+         auto itr = dictionary_index.find(n.value);
+         if (itr != dictionary_index.end())
+            return itr->second;
+         uint32_t index = dictionary.size();
+         dictionary.push_back(n.value);
+         dictionary_index.emplace(n.value, index);
+         return index;
+      }
+
+      uint32_t action_name_index_of(const action_name& n) {
+         auto itr = action_name_index.find(n);
+         if (itr != action_name_index.end())
+            return itr->second;
+         uint32_t index = action_names.size();
+         action_names.push_back(n);
+         action_name_index.emplace(n, index);
+         return index;
+      }
+
+      void add_action(const action_trace& trace) {
+         buffers["act.trx_row"].put_varint(trx_rows - prev_trx_row);
+         prev_trx_row = trx_rows;
+         buffers["act.global_sequence"].put_zigzag(int64_t(trace.receipt.global_sequence - prev_global_sequence));
+         prev_global_sequence = trace.receipt.global_sequence;
+         buffers["act.receiver"].put_varint(name_index(trace.receipt.receiver));
+         buffers["act.account"].put_varint(name_index(trace.act.account));
+         buffers["act.name"].put_varint(action_name_index_of(trace.act.name));
+         auto& auth = buffers["act.auth"];
+         auth.put_varint(trace.act.authorization.size());
+         for (const auto& p : trace.act.authorization) {
+            auth.put_varint(name_index(p.actor));
+            auth.put_varint(name_index(p.permission));
+         }
+         auto& data = buffers["act.data"];
+         data.put_varint(trace.act.data.size());
+         data.put_bytes(trace.act.data.data(), trace.act.data.size());
+         buffers["act.elapsed_us"].put_zigzag(trace.elapsed.count());
+         buffers["act.cpu_usage"].put_varint(trace.cpu_usage);
+         auto& console = buffers["act.console"];
+         console.put_varint(trace.console.size());
+         console.put_bytes(trace.console.data(), trace.console.size());
+         ++action_rows;
+         for (const auto& inline_trace : trace.inline_traces)
+            add_action(inline_trace);
+      }
+};
+
+segment_writer::segment_writer(const fc::path& dir) : my(new columns()) {
+   my->dir = dir;
+   if (!fc::is_directory(dir))
+      fc::create_directories(dir);
+}
+
+segment_writer::~segment_writer() {}
+
+void segment_writer::add_block(uint32_t block_num) {
+   if (my->first_block == 0)
+      my->first_block = block_num;
+   my->last_block = std::max(my->last_block, block_num);
+}
+
+void segment_writer::add_transaction(const transaction_trace& trace, const block_state& bs) {
+   add_block(bs.block_num);
+   uint32_t first_action_row = my->action_rows;
+   for (const auto& at : trace.action_traces)
+      my->add_action(at);
+
+   my->buffers["trx.id"].put_bytes(trace.id.data(), trace.id.data_size());
+   my->buffers["trx.block_num"].put_varint(bs.block_num - std::min(bs.block_num, my->prev_block_num));
+   my->prev_block_num = bs.block_num;
+   my->buffers["trx.block_time"].put(bs.header.timestamp);
+   my->buffers["trx.status"].put(uint8_t(trace.receipt->status));
+   my->buffers["trx.cpu_usage_us"].put_varint(trace.receipt->cpu_usage_us);
+   my->buffers["trx.net_usage_words"].put_varint(trace.receipt->net_usage_words.value);
+   my->buffers["trx.action_count"].put_varint(my->action_rows - first_action_row);
+   ++my->trx_rows;
+}
+
+bool segment_writer::empty()const {
+   return my->first_block == 0;
+}
+
+uint32_t segment_writer::first_block()const {
+   return my->first_block;
+}
+
+uint32_t segment_writer::last_block()const {
+   return my->last_block;
+}
+
+size_t segment_writer::buffered_bytes()const {
+   size_t n = my->dictionary.size() * sizeof(uint64_t) + my->action_names.size() * sizeof(action_name);
+   for (const auto& b : my->buffers)
+      n += b.second.data.size();
+   return n;
+}
+
+fc::path segment_writer::seal() {
+   ULTRAIN_ASSERT(!empty(), chain::plugin_exception, "seal an empty history segment");
+   std::string base = fc::to_string(my->first_block) + "-" + fc::to_string(my->last_block);
+   fc::path file = my->dir / (base + extension);
+   fc::path tmp = my->dir / (base + ".tmp");
+
+   segment_footer footer;
+   footer.first_block = my->first_block;
+   footer.last_block = my->last_block;
+   footer.trx_rows = my->trx_rows;
+   footer.action_rows = my->action_rows;
+   footer.dictionary = my->dictionary;
+   footer.action_names = my->action_names;
+   {
+      std::ofstream out(tmp.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      out.write((const char*)&segment_magic, sizeof(segment_magic));
+      uint64_t offset = sizeof(segment_magic);
+      for (const auto& b : my->buffers) {
+         auto compressed = zlib_compress(b.second.data);
+         out.write(compressed.data(), compressed.size());
+         footer.columns.push_back(column_info{b.first, offset, compressed.size(), b.second.data.size()});
+         offset += compressed.size();
+      }
+      auto packed = fc::raw::pack(footer);
+      uint64_t footer_size = packed.size();
+      out.write(packed.data(), packed.size());
+      out.write((const char*)&footer_size, sizeof(footer_size));
+      out.write((const char*)&segment_magic, sizeof(segment_magic));
+      out.flush();
+      ULTRAIN_ASSERT(out.good(), chain::plugin_exception, "failed to write history segment ${f}", ("f", tmp.generic_string()));
+   }
+   fc::rename(tmp, file);
+   my->reset();
+   return file;
+}
+
+segment_reader::segment_reader(const fc::path& f) : file(f) {
+   std::ifstream in(file.generic_string().c_str(), std::ios::in | std::ios::binary);
+   uint64_t size = fc::file_size(file);
+   uint64_t tail[2] = {0, 0};
+   ULTRAIN_ASSERT(size >= 3 * sizeof(uint64_t), chain::plugin_exception, "history segment ${f} is too short", ("f", file.generic_string()));
+   in.seekg(size - sizeof(tail));
+   in.read((char*)tail, sizeof(tail));
+   ULTRAIN_ASSERT(in.good() && tail[1] == segment_magic && tail[0] <= size - 3 * sizeof(uint64_t), chain::plugin_exception,
+                  "${f} is not a history segment", ("f", file.generic_string()));
+   std::vector<char> packed(tail[0]);
+   in.seekg(size - sizeof(tail) - tail[0]);
+   in.read(packed.data(), packed.size());
+   meta = fc::raw::unpack<segment_footer>(packed);
+}
+
+const segment_footer& segment_reader::footer()const {
+   return meta;
+}
+
+std::vector<char> segment_reader::read_column(const std::string& name)const {
+   auto itr = std::find_if(meta.columns.begin(), meta.columns.end(), [&](const column_info& c) { return c.name == name; });
+   if (itr == meta.columns.end())
+      return std::vector<char>();
+   std::ifstream in(file.generic_string().c_str(), std::ios::in | std::ios::binary);
+   std::vector<char> compressed(itr->size);
+   in.seekg(itr->offset);
+   in.read(compressed.data(), compressed.size());
+   ULTRAIN_ASSERT(in.good(), chain::plugin_exception, "failed to read column ${c} of ${f}", ("c", name)("f", file.generic_string()));
+   return zlib_decompress(compressed, itr->raw_size);
+}
+
+std::vector<account_name> segment_reader::read_names(const std::string& column)const {
+   ULTRAIN_ASSERT(column == "act.receiver" || column == "act.account", chain::plugin_exception,
+                  "${c} is not a name column", ("c", column));
+   auto data = read_column(column);
+   column_cursor c(data);
+   std::vector<account_name> names;
+   names.reserve(meta.action_rows);
+   for (uint32_t i = 0; i < meta.action_rows; ++i)
+      names.emplace_back(meta.dictionary.at(c.get_varint()));
+   return names;
+}
+
+std::vector<action_name> segment_reader::read_action_names()const {
+   auto data = read_column("act.name");
+   column_cursor c(data);
+   std::vector<action_name> names;
+   names.reserve(meta.action_rows);
+   for (uint32_t i = 0; i < meta.action_rows; ++i)
+      names.push_back(meta.action_names.at(c.get_varint()));
+   return names;
+}
+
+std::vector<exported_transaction> segment_reader::read_transactions()const {
+   std::map<std::string, std::vector<char>> data;
+   for (auto col : trx_columns)
+      data[col] = read_column(col);
+   column_cursor id(data["trx.id"]), block_num(data["trx.block_num"]), block_time(data["trx.block_time"]),
+                 status(data["trx.status"]), cpu(data["trx.cpu_usage_us"]), net(data["trx.net_usage_words"]),
+                 count(data["trx.action_count"]);
+
+   std::vector<exported_transaction> rows(meta.trx_rows);
+   uint32_t prev_block_num = 0;
+   for (auto& r : rows) {
+      memcpy(r.id.data(), id.get_bytes(r.id.data_size()), r.id.data_size());
+      r.block_num = prev_block_num + block_num.get_varint();
+      prev_block_num = r.block_num;
+      r.block_time = block_time.get<block_timestamp_type>();
+      r.status = status.get<uint8_t>();
+      r.cpu_usage_us = cpu.get_varint();
+      r.net_usage_words = net.get_varint();
+      r.action_count = count.get_varint();
+   }
+   return rows;
+}
+
+std::vector<exported_action> segment_reader::read_actions()const {
+   std::map<std::string, std::vector<char>> data;
+   for (auto col : action_columns)
+      data[col] = read_column(col);
+   column_cursor trx_row(data["act.trx_row"]), global_sequence(data["act.global_sequence"]),
+                 receiver(data["act.receiver"]), account(data["act.account"]), act_name(data["act.name"]),
+                 auth(data["act.auth"]), act_data(data["act.data"]), elapsed(data["act.elapsed_us"]),
+                 cpu(data["act.cpu_usage"]), console(data["act.console"]);
+   const auto& dict = meta.dictionary;
+
+   std::vector<exported_action> rows(meta.action_rows);
+   uint32_t prev_trx_row = 0;
+   uint64_t prev_global_sequence = 0;
+   for (auto& r : rows) {
+      r.trx_row = prev_trx_row + trx_row.get_varint();
+      prev_trx_row = r.trx_row;
+      r.global_sequence = prev_global_sequence + global_sequence.get_zigzag();
+      prev_global_sequence = r.global_sequence;
+      r.receiver = name(dict.at(receiver.get_varint()));
+      r.account = name(dict.at(account.get_varint()));
+      r.name = meta.action_names.at(act_name.get_varint());
+      r.authorization.resize(auth.get_varint());
+      for (auto& p : r.authorization) {
+         p.actor = name(dict.at(auth.get_varint()));
+         p.permission = name(dict.at(auth.get_varint()));
+      }
+      size_t n = act_data.get_varint();
+      const char* p = act_data.get_bytes(n);
+      r.data.assign(p, p + n);
+      r.elapsed_us = elapsed.get_zigzag();
+      r.cpu_usage = cpu.get_varint();
+      n = console.get_varint();
+      p = console.get_bytes(n);
+      r.console.assign(p, n);
+   }
+   return rows;
+}
+
+std::vector<fc::path> segment_reader::list_segments(const fc::path& dir) {
+   std::vector<std::pair<uint32_t, fc::path>> found;
+   if (fc::is_directory(dir)) {
+      for (fc::directory_iterator itr(dir); itr != fc::directory_iterator(); ++itr) {
+         fc::path p = *itr;
+         if (p.extension().generic_string() != segment_writer::extension)
+            continue;
+         found.emplace_back(std::stoul(p.stem().generic_string()), p);
+      }
+   }
+   std::sort(found.begin(), found.end(),
+             [](const std::pair<uint32_t, fc::path>& a, const std::pair<uint32_t, fc::path>& b) { return a.first < b.first; });
+   std::vector<fc::path> files;
+   for (auto& f : found)
+      files.push_back(f.second);
+   return files;
+}
+
+} } /// ultrainio::history_export
@@ -0,0 +1,248 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#include <ultrainio/history_export_plugin/history_export_plugin.hpp>
+#include <ultrainio/history_export_plugin/columnar_segment.hpp>
+#include <ultrainio/chain/exceptions.hpp>
+
+#include <boost/signals2/connection.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace ultrainio {
+
+static appbase::abstract_plugin& _history_export_plugin = app().register_plugin<history_export_plugin>();
+
+using namespace ultrainio::chain;
+using namespace ultrainio::history_export;
+
+class history_export_plugin_impl {
+   public:
+      struct export_event {
+         transaction_trace_ptr   trace;
+         uint32_t                block_num = 0; ///< block the trace was applied in
+         block_state_ptr         block;
+      };
+
+      fc::path                                                 export_dir;
+      uint32_t                                                 blocks_per_segment = 0;
+      size_t                                                   max_buffer_bytes = 0;
+      size_t                                                   max_queue_size = 0;
+
+      std::mutex                                               mtx;
+      std::condition_variable                                  condition;
+      std::condition_variable                                  space_condition;
+      std::deque<export_event>                                 events;
+      bool                                                     done = false;
+      std::thread                                              consume_thread;
+
+      // only touched by the consume thread
+      std::unique_ptr<segment_writer>                          writer;
+      std::map<transaction_id_type, std::pair<transaction_trace_ptr, uint32_t>> pending_traces;
+      uint32_t                                                 last_exported_block = 0;
+
+      fc::optional<boost::signals2::scoped_connection>         applied_transaction_connection;
+      fc::optional<boost::signals2::scoped_connection>         irreversible_block_connection;
+
+      void open();
+      void queue(export_event&& e);
+      void applied_transaction(const transaction_trace_ptr& trace);
+      void irreversible_block(const block_state_ptr& bs);
+      void consume_events();
+      void process_block(const block_state& bs);
+      void seal();
+};
+
+void history_export_plugin_impl::open() {
+   writer.reset(new segment_writer(export_dir));
+   for (fc::directory_iterator itr(export_dir); itr != fc::directory_iterator(); ++itr) {
+      fc::path p = *itr;
+      if (p.extension().generic_string() == ".tmp") {
+         wlog("removing incomplete history segment ${f}", ("f", p.generic_string()));
+         fc::remove(p);
+      }
+   }
+   auto segments = segment_reader::list_segments(export_dir);
+   if (!segments.empty()) {
+      last_exported_block = segment_reader(segments.back()).footer().last_block;
+   }
+   ilog("history export to ${d} with ${n} segments, last block ${b}",
+        ("d", export_dir.generic_string())("n", segments.size())("b", last_exported_block));
+}
+
+void history_export_plugin_impl::queue(export_event&& e) {
+   std::unique_lock<std::mutex> lock(mtx);
+   if (events.size() >= max_queue_size) {
+      // the chain thread waits rather than letting the backlog grow without bound
+      wlog("history export queue is full, size: ${q}", ("q", events.size()));
+      space_condition.wait(lock, [this]() { return events.size() < max_queue_size || done; });
+   }
+   events.emplace_back(std::move(e));
+   lock.unlock();
+   condition.notify_one();
+}
+
+void history_export_plugin_impl::applied_transaction(const transaction_trace_ptr& trace) {
+   if (!trace->receipt)
+      return;
+   const auto& chain = app().get_plugin<chain_plugin>().chain();
+   export_event e;
+   e.trace = trace;
+   e.block_num = chain.head_block_num() + 1;
+   queue(std::move(e));
+}
+
+void history_export_plugin_impl::irreversible_block(const block_state_ptr& bs) {
+   export_event e;
+   e.block = bs;
+   queue(std::move(e));
+}
+
+void history_export_plugin_impl::consume_events() {
+   try {
+      std::deque<export_event> process;
+      while (true) {
+         std::unique_lock<std::mutex> lock(mtx);
+         condition.wait(lock, [this]() { return !events.empty() || done; });
+         process = std::move(events);
+         events.clear();
+         bool finished = done;
+         lock.unlock();
+         space_condition.notify_all();
+
+         for (auto& e : process) {
+            if (e.trace) {
+               pending_traces[e.trace->id] = std::make_pair(e.trace, e.block_num);
+            } else {
+               process_block(*e.block);
+            }
+         }
+         process.clear();
+         if (finished)
+            break;
+      }
+      if (!writer->empty())
+         seal();
+      ilog("history export thread shutdown gracefully");
+   } catch (fc::exception& e) {
+      elog("FC Exception while exporting history ${e}", ("e", e.to_detail_string()));
+   } catch (std::exception& e) {
+      elog("STD Exception while exporting history ${e}", ("e", e.what()));
+   } catch (...) {
+      elog("Unknown exception while exporting history");
+   }
+}
+
+void history_export_plugin_impl::process_block(const block_state& bs) {
+   // only irreversible blocks are exported, a sealed segment is never rewritten for a fork
+   if (bs.block_num > last_exported_block) {
+      writer->add_block(bs.block_num);
+      for (const auto& receipt : bs.block->transactions) {
+         transaction_id_type id;
+         if (receipt.trx.contains<transaction_id_type>()) {
+            id = receipt.trx.get<transaction_id_type>();
+         } else if (receipt.trx.contains<packed_generated_transaction>()) {
+            id = receipt.trx.get<packed_generated_transaction>().id();
+         } else {
+            id = receipt.trx.get<packed_transaction>().id();
+         }
+
+         auto itr = pending_traces.find(id);
+         if (itr == pending_traces.end()) {
+            wlog("no trace for exported transaction ${id} in block ${n}", ("id", id)("n", bs.block_num));
+            continue;
+         }
+         writer->add_transaction(*itr->second.first, bs);
+         pending_traces.erase(itr);
+      }
+      last_exported_block = bs.block_num;
+      if (bs.block_num % blocks_per_segment == 0 || writer->buffered_bytes() >= max_buffer_bytes)
+         seal();
+   }
+
+   // anything left for this height or below belongs to a dropped fork or a speculative block
+   for (auto itr = pending_traces.begin(); itr != pending_traces.end(); ) {
+      if (itr->second.second <= bs.block_num)
+         itr = pending_traces.erase(itr);
+      else
+         ++itr;
+   }
+}
+
+void history_export_plugin_impl::seal() {
+   auto start = fc::time_point::now();
+   uint32_t first = writer->first_block();
+   size_t bytes = writer->buffered_bytes();
+   auto file = writer->seal();
+   ilog("history segment ${f} of blocks ${a} - ${b} sealed, ${s} bytes packed in ${t} us",
+        ("f", file.filename().generic_string())("a", first)("b", last_exported_block)("s", bytes)
+        ("t", (fc::time_point::now() - start).count()));
+}
+
+history_export_plugin::history_export_plugin():my(new history_export_plugin_impl()){}
+history_export_plugin::~history_export_plugin(){}
+
+void history_export_plugin::set_program_options(options_description&, options_description& cfg) {
+   cfg.add_options()
+         ("history-export-dir", bpo::value<bfs::path>()->default_value("history-export"),
+          "the location of the exported history segments (absolute path or relative to application data dir)")
+         ("history-export-blocks-per-segment", bpo::value<uint32_t>()->default_value(10000),
+          "Segments are closed at block numbers which are a multiple of this value")
+         ("history-export-max-buffer-mb", bpo::value<uint32_t>()->default_value(64),
+          "A segment is closed early once its uncompressed columns reach this size in MiB")
+         ("history-export-queue-size", bpo::value<uint32_t>()->default_value(4096),
+          "The queue size between nodultrain and the history export thread")
+         ;
+}
+
+void history_export_plugin::plugin_initialize(const variables_map& options) {
+   try {
+      auto dir = options.at("history-export-dir").as<bfs::path>();
+      my->export_dir = dir.is_relative() ? app().data_dir() / dir : dir;
+      my->blocks_per_segment = options.at("history-export-blocks-per-segment").as<uint32_t>();
+      my->max_buffer_bytes = size_t(options.at("history-export-max-buffer-mb").as<uint32_t>()) * 1024 * 1024;
+      my->max_queue_size = options.at("history-export-queue-size").as<uint32_t>();
+      ULTRAIN_ASSERT(my->blocks_per_segment > 0, chain::plugin_config_exception, "history-export-blocks-per-segment > 0 required");
+      ULTRAIN_ASSERT(my->max_buffer_bytes > 0, chain::plugin_config_exception, "history-export-max-buffer-mb > 0 required");
+      ULTRAIN_ASSERT(my->max_queue_size > 0, chain::plugin_config_exception, "history-export-queue-size > 0 required");
+
+      my->open();
+      // running before the signals are connected, replay in chain_plugin startup already queues events
+      my->consume_thread = std::thread([this] { my->consume_events(); });
+
+      auto& chain = app().get_plugin<chain_plugin>().chain();
+      my->applied_transaction_connection.emplace(
+            chain.applied_transaction.connect( [&]( const transaction_trace_ptr& t ) {
+               my->applied_transaction( t );
+            } ));
+      my->irreversible_block_connection.emplace(
+            chain.irreversible_block.connect( [&]( const block_state_ptr& bs ) {
+               my->irreversible_block( bs );
+            } ));
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+void history_export_plugin::plugin_startup() {
+   ilog("starting history_export_plugin");
+}
+
+void history_export_plugin::plugin_shutdown() {
+   my->applied_transaction_connection.reset();
+   my->irreversible_block_connection.reset();
+   {
+      std::lock_guard<std::mutex> g(my->mtx);
+      my->done = true;
+   }
+   my->condition.notify_one();
+   my->space_condition.notify_all();
+   if (my->consume_thread.joinable())
+      my->consume_thread.join();
+}
+
+}
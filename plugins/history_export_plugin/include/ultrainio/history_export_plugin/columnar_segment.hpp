@@ -0,0 +1,133 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#pragma once
+#include <ultrainio/chain/block_state.hpp>
+#include <ultrainio/chain/trace.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ultrainio { namespace history_export {
+
+   using chain::account_name;
+   using chain::action_name;
+   using chain::permission_level;
+   using chain::transaction_id_type;
+
+   struct exported_transaction {
+      transaction_id_type                 id;
+      uint32_t                            block_num = 0;
+      chain::block_timestamp_type         block_time;
+      uint8_t                             status = 0;
+      uint32_t                            cpu_usage_us = 0;
+      uint32_t                            net_usage_words = 0;
+      uint32_t                            action_count = 0; ///< flattened, inline actions included
+   };
+
+   struct exported_action {
+      uint32_t                            trx_row = 0; ///< row of the transaction in the same segment
+      uint64_t                            global_sequence = 0;
+      account_name                        receiver;
+      account_name                        account;
+      action_name                         name;
+      std::vector<permission_level>       authorization;
+      chain::bytes                        data;
+      int64_t                             elapsed_us = 0;
+      uint64_t                            cpu_usage = 0;
+      std::string                         console;
+   };
+
+   struct column_info {
+      std::string                         name;
+      uint64_t                            offset = 0;
+      uint64_t                            size = 0;     ///< compressed
+      uint64_t                            raw_size = 0;
+   };
+
+   struct segment_footer {
+      uint32_t                            version = 1;
+      uint32_t                            first_block = 0;
+      uint32_t                            last_block = 0;
+      uint32_t                            trx_rows = 0;
+      uint32_t                            action_rows = 0;
+      std::vector<uint64_t>               dictionary; ///< account and permission names referenced by index
+      std::vector<action_name>            action_names; ///< action names referenced by index
+      std::vector<column_info>            columns;
+   };
+
+   /* A segment holds the transactions and the flattened action traces of a block range,
+    * stored column by column, each column zlib compressed on its own. Names are dictionary
+    * encoded, integers are varints and mostly deltas against the previous row.
+    *
+    * <first block>-<last block>.seg
+    * +-------+----------+----------+-----+--------+-------------+-------+
+    * | magic | column 0 | column 1 | ... | footer | footer size | magic |
+    * +-------+----------+----------+-----+--------+-------------+-------+
+    *
+    * Files are written to a temporary name and renamed once complete, so a segment with a
+    * .seg extension is always readable.
+    */
+   class segment_writer {
+      public:
+         explicit segment_writer(const fc::path& dir);
+         ~segment_writer();
+
+         void add_block(uint32_t block_num);
+         void add_transaction(const chain::transaction_trace& trace, const chain::block_state& bs);
+
+         bool empty()const;
+         uint32_t first_block()const;
+         uint32_t last_block()const;
+         /// memory held by the uncompressed columns
+         size_t buffered_bytes()const;
+
+         /// writes the buffered rows to a new segment file and resets the writer
+         fc::path seal();
+
+         static const char* const extension;
+
+      private:
+         class columns;
+         std::unique_ptr<columns> my;
+   };
+
+   class segment_reader {
+      public:
+         explicit segment_reader(const fc::path& file);
+
+         const segment_footer& footer()const;
+
+         /// uncompressed bytes of one column, empty if the segment has no such column
+         std::vector<char> read_column(const std::string& name)const;
+
+         /// decodes only one of the dictionary encoded account columns: act.receiver or act.account
+         std::vector<account_name> read_names(const std::string& column)const;
+
+         /// decodes only the act.name column
+         std::vector<action_name> read_action_names()const;
+
+         std::vector<exported_transaction> read_transactions()const;
+         std::vector<exported_action> read_actions()const;
+
+         /// every segment in the directory, ordered by block range
+         static std::vector<fc::path> list_segments(const fc::path& dir);
+
+      private:
+         fc::path         file;
+         segment_footer   meta;
+   };
+
+} } /// ultrainio::history_export
+
+FC_REFLECT( ultrainio::history_export::exported_transaction,
+            (id)(block_num)(block_time)(status)(cpu_usage_us)(net_usage_words)(action_count) )
+FC_REFLECT( ultrainio::history_export::exported_action,
+            (trx_row)(global_sequence)(receiver)(account)(name)(authorization)(data)(elapsed_us)(cpu_usage)(console) )
+FC_REFLECT( ultrainio::history_export::column_info, (name)(offset)(size)(raw_size) )
+FC_REFLECT( ultrainio::history_export::segment_footer,
+            (version)(first_block)(last_block)(trx_rows)(action_rows)(dictionary)(action_names)(columns) )
@@ -0,0 +1,37 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#pragma once
+#include <appbase/application.hpp>
+#include <ultrainio/chain_plugin/chain_plugin.hpp>
+
+namespace ultrainio {
+
+using namespace appbase;
+
+class history_export_plugin_impl;
+
+/**
+ *  Exports transactions and action traces of irreversible blocks into columnar segment files,
+ *  see history_export::segment_writer for the format and history_export::segment_reader
+ *  for reading them back. Traces are packed straight from the chain types on a background
+ *  thread, without the JSON/BSON conversion of mongo_db_plugin.
+ */
+class history_export_plugin : public appbase::plugin<history_export_plugin> {
+public:
+   history_export_plugin();
+   virtual ~history_export_plugin();
+
+   APPBASE_PLUGIN_REQUIRES((chain_plugin))
+   virtual void set_program_options(options_description&, options_description& cfg) override;
+
+   void plugin_initialize(const variables_map& options);
+   void plugin_startup();
+   void plugin_shutdown();
+
+private:
+   std::unique_ptr<history_export_plugin_impl> my;
+};
+
+}
@@ -0,0 +1,128 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#pragma once
+#include <appbase/application.hpp>
+#include <ultrainio/http_plugin/http_plugin.hpp>
+#include <ultrainio/chain_plugin/chain_plugin.hpp>
+#include <ultrainio/chain/trace.hpp>
+
+namespace ultrainio {
+
+using namespace appbase;
+
+class local_history_plugin_impl;
+
+namespace history {
+
+   /// one flattened (inline traces are stored as separate entries) action trace
+   struct action_history_object {
+      uint64_t                          action_seq = 0;
+      uint32_t                          block_num = 0;
+      chain::block_timestamp_type       block_time;
+      chain::base_action_trace          trace;
+   };
+
+   struct transaction_history_object {
+      chain::transaction_id_type                id;
+      uint32_t                                  block_num = 0;
+      chain::block_timestamp_type               block_time;
+      chain::transaction_receipt_header         receipt;
+      uint64_t                                  first_action_seq = 0;
+      uint32_t                                  action_count = 0;
+   };
+
+   /// one irreversible block, its transactions are the trx log entries [first_trx_seq, first_trx_seq + trx_count)
+   struct block_history_object {
+      uint32_t                                  block_num = 0;
+      chain::block_id_type                      id;
+      chain::block_timestamp_type               block_time;
+      chain::account_name                       proposer;
+      uint64_t                                  first_trx_seq = 0;
+      uint32_t                                  trx_count = 0;
+   };
+
+   class read_only {
+      public:
+         read_only(const local_history_plugin_impl& h):history(h){}
+
+         struct get_actions_params {
+            chain::account_name        account_name;
+            fc::optional<int64_t>      pos; ///< index into the account's actions, -1 or unset for the last one
+            fc::optional<int64_t>      offset; ///< number of actions to return relative to pos, negative walks backwards
+         };
+
+         struct get_actions_result {
+            vector<action_history_object>    actions;
+            uint32_t                         last_irreversible_block = 0;
+         };
+
+         get_actions_result get_actions(const get_actions_params& params)const;
+
+         struct get_transaction_params {
+            chain::transaction_id_type       id;
+         };
+
+         struct get_transaction_result {
+            transaction_history_object       trx;
+            vector<action_history_object>    traces;
+            uint32_t                         last_irreversible_block = 0;
+         };
+
+         get_transaction_result get_transaction(const get_transaction_params& params)const;
+
+         struct get_block_params {
+            uint32_t                         block_num = 0;
+         };
+
+         struct get_block_result {
+            block_history_object                  block;
+            vector<transaction_history_object>    trxs;
+            uint32_t                              last_irreversible_block = 0;
+         };
+
+         get_block_result get_block(const get_block_params& params)const;
+
+      private:
+         const local_history_plugin_impl& history;
+   };
+
+} /// namespace history
+
+/**
+ *  Embedded alternative to mongo_db_plugin: keeps action traces and transaction receipts of
+ *  irreversible blocks in local append only segment files together with on disk account and
+ *  transaction id indexes, and serves them under /v1/history.
+ */
+class local_history_plugin : public appbase::plugin<local_history_plugin> {
+public:
+   local_history_plugin();
+   virtual ~local_history_plugin();
+
+   APPBASE_PLUGIN_REQUIRES((http_plugin)(chain_plugin))
+   virtual void set_program_options(options_description&, options_description& cfg) override;
+
+   void plugin_initialize(const variables_map& options);
+   void plugin_startup();
+   void plugin_shutdown();
+
+   history::read_only get_read_only_api()const;
+
+private:
+   std::unique_ptr<local_history_plugin_impl> my;
+};
+
+}
+
+FC_REFLECT( ultrainio::history::action_history_object, (action_seq)(block_num)(block_time)(trace) )
+FC_REFLECT( ultrainio::history::transaction_history_object,
+            (id)(block_num)(block_time)(receipt)(first_action_seq)(action_count) )
+FC_REFLECT( ultrainio::history::block_history_object,
+            (block_num)(id)(block_time)(proposer)(first_trx_seq)(trx_count) )
+FC_REFLECT( ultrainio::history::read_only::get_actions_params, (account_name)(pos)(offset) )
+FC_REFLECT( ultrainio::history::read_only::get_actions_result, (actions)(last_irreversible_block) )
+FC_REFLECT( ultrainio::history::read_only::get_transaction_params, (id) )
+FC_REFLECT( ultrainio::history::read_only::get_transaction_result, (trx)(traces)(last_irreversible_block) )
+FC_REFLECT( ultrainio::history::read_only::get_block_params, (block_num) )
+FC_REFLECT( ultrainio::history::read_only::get_block_result, (block)(trxs)(last_irreversible_block) )
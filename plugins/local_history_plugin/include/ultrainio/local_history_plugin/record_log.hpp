@@ -0,0 +1,57 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#pragma once
+#include <fc/filesystem.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace ultrainio { namespace history {
+
+   namespace detail { class record_log_impl; }
+
+   /* The record log is an append only log of variable sized entries split into segment files
+    * of bounded size. Every entry is addressed by a dense sequence number starting at 0. The
+    * index file stores one 8 byte locator per sequence number, which enables O(1) random
+    * access lookup.
+    *
+    * <prefix>.<segment>.log
+    * +--------+---------+--------+---------+-----+
+    * | Size 0 | Entry 0 | Size 1 | Entry 1 | ... |
+    * +--------+---------+--------+---------+-----+
+    *
+    * <prefix>.index
+    * +-------------------+-------------------+-----+
+    * | Locator of seq 0  | Locator of seq 1  | ... |
+    * +-------------------+-------------------+-----+
+    *
+    * A locator is (segment << 40) | offset of the size prefix inside the segment. Reads go
+    * through read only memory mappings of the segment files; sealed segments are mapped once,
+    * the active segment is remapped only when a read goes past the mapped length.
+    */
+   class record_log {
+      public:
+         record_log(const fc::path& dir, const std::string& prefix, uint64_t max_segment_size);
+         ~record_log();
+
+         /// @return the sequence number assigned to the entry
+         uint64_t append(const std::vector<char>& entry);
+         std::vector<char> read(uint64_t seq)const;
+
+         /// number of entries in the log, also the next sequence number
+         uint64_t size()const;
+         void flush();
+
+         /// drop every entry with sequence number >= seq
+         void truncate(uint64_t seq);
+
+         static const uint64_t max_segment_offset = (uint64_t(1) << 40) - 1;
+
+      private:
+         std::unique_ptr<detail::record_log_impl> my;
+   };
+
+} } /// ultrainio::history
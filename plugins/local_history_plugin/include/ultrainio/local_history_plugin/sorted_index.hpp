@@ -0,0 +1,58 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#pragma once
+#include <fc/filesystem.hpp>
+
+#include <memory>
+
+namespace ultrainio { namespace history {
+
+   namespace detail { class sorted_index_impl; }
+
+   /* The sorted index maps fixed size keys to the sequence numbers of a record log, a key may
+    * map to many sequence numbers. It lives on disk so that its memory use does not grow with
+    * the history, only the entries added since the last run are held in memory.
+    *
+    * <prefix>.wal
+    * +---------+-------+---------+-------+-----+
+    * | Key     | Seq   | Key     | Seq   | ... |   entries not in a run yet, in the order added
+    * +---------+-------+---------+-------+-----+
+    *
+    * <prefix>.<start>-<end>.run
+    * +---------+-------+---------+-------+-----+
+    * | Key     | Seq   | Key     | Seq   | ... |   every entry with start <= seq < end, sorted by key then seq
+    * +---------+-------+---------+-------+-----+
+    *
+    * Sequence numbers must be added in non decreasing order. Once the memory table holds
+    * run_entries entries, flush() writes it as a new run and empties the wal. Runs are merged
+    * when fanout runs of the same size class follow each other, so a key is looked up with one
+    * binary search per run over a read only mapping and there are O(fanout * log n) runs.
+    */
+   class sorted_index {
+      public:
+         sorted_index(const fc::path& dir, const std::string& prefix, uint32_t key_size, uint64_t run_entries);
+         ~sorted_index();
+
+         void add(const char* key, uint64_t seq);
+
+         /// number of sequence numbers of key
+         uint64_t count(const char* key)const;
+         /// the i-th smallest sequence number of key, i < count(key)
+         uint64_t at(const char* key, uint64_t i)const;
+
+         /// one past the highest sequence number indexed, every lower one is complete
+         uint64_t end()const;
+         void flush();
+
+         /// drop every entry with sequence number >= seq
+         void truncate(uint64_t seq);
+
+         static const uint32_t fanout = 8;
+
+      private:
+         std::unique_ptr<detail::sorted_index_impl> my;
+   };
+
+} } /// ultrainio::history
@@ -0,0 +1,378 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#include <ultrainio/local_history_plugin/local_history_plugin.hpp>
+#include <ultrainio/local_history_plugin/record_log.hpp>
+#include <ultrainio/local_history_plugin/sorted_index.hpp>
+#include <ultrainio/chain/exceptions.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/variant.hpp>
+
+#include <boost/signals2/connection.hpp>
+
+namespace ultrainio {
+
+static appbase::abstract_plugin& _local_history_plugin = app().register_plugin<local_history_plugin>();
+
+using namespace ultrainio::chain;
+using namespace ultrainio::history;
+
+class local_history_plugin_impl {
+   public:
+      /// entries an index keeps in memory before they are written as a sorted run
+      static const uint64_t index_run_entries = 256 * 1024;
+
+      fc::path                                                 history_dir;
+      uint64_t                                                 segment_size = 0;
+      uint32_t                                                 max_actions_per_query = 0;
+
+      std::unique_ptr<record_log>                              action_log;
+      std::unique_ptr<record_log>                              trx_log;
+      std::unique_ptr<record_log>                              block_log;
+      /// account name -> action_seq of the actions it received or authorized
+      std::unique_ptr<sorted_index>                            account_index;
+      /// transaction id -> trx_seq
+      std::unique_ptr<sorted_index>                            trx_index;
+
+      /// traces of applied transactions which are not irreversible yet, with the block they were applied in
+      std::map<transaction_id_type, std::pair<transaction_trace_ptr, uint32_t>> pending_traces;
+      uint32_t                                                 last_written_block = 0;
+      uint32_t                                                 last_irreversible_block = 0;
+
+      fc::optional<boost::signals2::scoped_connection>         applied_transaction_connection;
+      fc::optional<boost::signals2::scoped_connection>         irreversible_block_connection;
+
+      void open();
+      void applied_transaction(const transaction_trace_ptr& trace);
+      void irreversible_block(const block_state_ptr& bs);
+
+      void write_transaction(const transaction_trace& trace, const block_state& bs);
+      void write_action(const base_action_trace& trace, const block_state& bs);
+      void index_action(const base_action_trace& trace, uint64_t action_seq);
+      void flatten(const action_trace& trace, std::vector<const action_trace*>& out)const;
+      void flush();
+
+      /// trx_seq of the transaction, false if it is not in the history
+      bool find_transaction(const transaction_id_type& id, uint64_t& trx_seq)const;
+      /// block_seq of the block, false if it is not in the history
+      bool find_block(uint32_t block_num, uint64_t& block_seq)const;
+
+      template<typename T>
+      T read(const record_log& log, uint64_t seq)const {
+         auto bytes = log.read(seq);
+         return fc::raw::unpack<T>(bytes);
+      }
+};
+
+void local_history_plugin_impl::open() {
+   action_log.reset(new record_log(history_dir, "actions", segment_size));
+   trx_log.reset(new record_log(history_dir, "trxs", segment_size));
+   block_log.reset(new record_log(history_dir, "blocks", segment_size));
+   account_index.reset(new sorted_index(history_dir, "account", sizeof(uint64_t), index_run_entries));
+   trx_index.reset(new sorted_index(history_dir, "trx_id", sizeof(transaction_id_type), index_run_entries));
+
+   // a block is written after its transactions and a transaction after its actions, so the block
+   // log bounds what is complete on disk
+   if (block_log->size() > 0) {
+      auto last = read<block_history_object>(*block_log, block_log->size() - 1);
+      trx_log->truncate(last.first_trx_seq + last.trx_count);
+      last_written_block = last.block_num;
+   } else {
+      trx_log->truncate(0);
+   }
+   if (trx_log->size() > 0) {
+      auto last = read<transaction_history_object>(*trx_log, trx_log->size() - 1);
+      action_log->truncate(last.first_action_seq + last.action_count);
+   } else {
+      action_log->truncate(0);
+   }
+
+   // the indexes are flushed after the logs, cut them back to what the logs hold and index
+   // again whatever the logs hold beyond them, so no stale entry survives a restart
+   account_index->truncate(action_log->size());
+   trx_index->truncate(trx_log->size());
+   uint64_t next_action = account_index->end();
+   uint64_t next_trx = trx_index->end();
+   for (uint64_t seq = next_action; seq < action_log->size(); ++seq)
+      index_action(read<action_history_object>(*action_log, seq).trace, seq);
+   for (uint64_t seq = next_trx; seq < trx_log->size(); ++seq)
+      trx_index->add(read<transaction_history_object>(*trx_log, seq).id.data(), seq);
+   if (next_action < action_log->size() || next_trx < trx_log->size()) {
+      wlog("local history indexed ${a} actions and ${t} transactions missing from the indexes",
+           ("a", action_log->size() - next_action)("t", trx_log->size() - next_trx));
+      account_index->flush();
+      trx_index->flush();
+   }
+
+   ilog("local history opened with ${a} actions of ${t} transactions in ${n} blocks, last block ${b}",
+        ("a", action_log->size())("t", trx_log->size())("n", block_log->size())("b", last_written_block));
+}
+
+void local_history_plugin_impl::applied_transaction(const transaction_trace_ptr& trace) {
+   if (!trace->receipt)
+      return;
+   const auto& chain = app().get_plugin<chain_plugin>().chain();
+   pending_traces[trace->id] = std::make_pair(trace, chain.head_block_num() + 1);
+}
+
+void local_history_plugin_impl::irreversible_block(const block_state_ptr& bs) {
+   last_irreversible_block = bs->block_num;
+   if (bs->block_num > last_written_block) {
+      block_history_object block;
+      block.block_num = bs->block_num;
+      block.id = bs->id;
+      block.block_time = bs->header.timestamp;
+      block.proposer = bs->header.proposer;
+      block.first_trx_seq = trx_log->size();
+
+      for (const auto& receipt : bs->block->transactions) {
+         transaction_id_type id;
+         if (receipt.trx.contains<transaction_id_type>()) {
+            id = receipt.trx.get<transaction_id_type>();
+         } else if (receipt.trx.contains<packed_generated_transaction>()) {
+            id = receipt.trx.get<packed_generated_transaction>().id();
+         } else {
+            id = receipt.trx.get<packed_transaction>().id();
+         }
+
+         auto itr = pending_traces.find(id);
+         if (itr == pending_traces.end()) {
+            wlog("no trace for irreversible transaction ${id} in block ${n}", ("id", id)("n", bs->block_num));
+            continue;
+         }
+         write_transaction(*itr->second.first, *bs);
+         pending_traces.erase(itr);
+      }
+      block.trx_count = trx_log->size() - block.first_trx_seq;
+      block_log->append(fc::raw::pack(block));
+      last_written_block = bs->block_num;
+      flush();
+   }
+
+   // anything left for this height or below belongs to a dropped fork or a speculative block
+   for (auto itr = pending_traces.begin(); itr != pending_traces.end(); ) {
+      if (itr->second.second <= bs->block_num)
+         itr = pending_traces.erase(itr);
+      else
+         ++itr;
+   }
+}
+
+void local_history_plugin_impl::flush() {
+   action_log->flush();
+   trx_log->flush();
+   block_log->flush();
+   account_index->flush();
+   trx_index->flush();
+}
+
+void local_history_plugin_impl::flatten(const action_trace& trace, std::vector<const action_trace*>& out)const {
+   out.push_back(&trace);
+   for (const auto& inline_trace : trace.inline_traces)
+      flatten(inline_trace, out);
+}
+
+void local_history_plugin_impl::write_transaction(const transaction_trace& trace, const block_state& bs) {
+   transaction_history_object trx;
+   trx.id = trace.id;
+   trx.block_num = bs.block_num;
+   trx.block_time = bs.header.timestamp;
+   trx.receipt = *trace.receipt;
+   trx.first_action_seq = action_log->size();
+
+   std::vector<const action_trace*> actions;
+   for (const auto& at : trace.action_traces)
+      flatten(at, actions);
+   for (const auto* at : actions)
+      write_action(*at, bs);
+   trx.action_count = actions.size();
+
+   trx_index->add(trx.id.data(), trx_log->append(fc::raw::pack(trx)));
+}
+
+void local_history_plugin_impl::write_action(const base_action_trace& trace, const block_state& bs) {
+   action_history_object obj;
+   obj.action_seq = action_log->size();
+   obj.block_num = bs.block_num;
+   obj.block_time = bs.header.timestamp;
+   obj.trace = trace;
+   ULTRAIN_ASSERT(action_log->append(fc::raw::pack(obj)) == obj.action_seq, chain::plugin_exception,
+                  "local history action log out of sequence");
+   index_action(trace, obj.action_seq);
+}
+
+void local_history_plugin_impl::index_action(const base_action_trace& trace, uint64_t action_seq) {
+   std::set<uint64_t> accounts;
+   accounts.insert(trace.receipt.receiver.value);
+   for (const auto& auth : trace.act.authorization)
+      accounts.insert(auth.actor.value);
+   for (auto account : accounts)
+      account_index->add((const char*)&account, action_seq);
+}
+
+bool local_history_plugin_impl::find_transaction(const transaction_id_type& id, uint64_t& trx_seq)const {
+   uint64_t n = trx_index->count(id.data());
+   if (n == 0)
+      return false;
+   trx_seq = trx_index->at(id.data(), n - 1);
+   return true;
+}
+
+bool local_history_plugin_impl::find_block(uint32_t block_num, uint64_t& block_seq)const {
+   // block numbers increase along the log but may skip, e.g. across a restart with a newer state
+   uint64_t lo = 0, hi = block_log->size();
+   while (lo < hi) {
+      uint64_t mid = lo + (hi - lo) / 2;
+      if (read<block_history_object>(*block_log, mid).block_num < block_num)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   if (lo == block_log->size() || read<block_history_object>(*block_log, lo).block_num != block_num)
+      return false;
+   block_seq = lo;
+   return true;
+}
+
+namespace history {
+
+   read_only::get_actions_result read_only::get_actions(const read_only::get_actions_params& params)const {
+      get_actions_result result;
+      result.last_irreversible_block = history.last_irreversible_block;
+
+      const char* key = (const char*)&params.account_name.value;
+      int64_t last = int64_t(history.account_index->count(key)) - 1;
+      if (last < 0)
+         return result;
+
+      int64_t pos = params.pos.valid() ? *params.pos : -1;
+      int64_t offset = params.offset.valid() ? *params.offset : -20;
+      if (pos < 0 || pos > last)
+         pos = last;
+
+      int64_t start = offset < 0 ? pos + offset : pos;
+      int64_t end = offset < 0 ? pos : pos + offset;
+      start = std::max<int64_t>(start, 0);
+      end = std::min<int64_t>(end, last);
+      start = std::max<int64_t>(start, end - int64_t(history.max_actions_per_query) + 1);
+
+      for (int64_t i = start; i <= end; ++i)
+         result.actions.emplace_back(history.read<action_history_object>(*history.action_log,
+                                                                           history.account_index->at(key, i)));
+      return result;
+   }
+
+   read_only::get_transaction_result read_only::get_transaction(const read_only::get_transaction_params& params)const {
+      uint64_t trx_seq = 0;
+      ULTRAIN_ASSERT(history.find_transaction(params.id, trx_seq), chain::unknown_transaction_exception,
+                     "transaction ${id} not found in local history", ("id", params.id));
+
+      get_transaction_result result;
+      result.last_irreversible_block = history.last_irreversible_block;
+      result.trx = history.read<transaction_history_object>(*history.trx_log, trx_seq);
+      for (uint32_t i = 0; i < result.trx.action_count; ++i)
+         result.traces.emplace_back(history.read<action_history_object>(*history.action_log,
+                                                                         result.trx.first_action_seq + i));
+      return result;
+   }
+
+   read_only::get_block_result read_only::get_block(const read_only::get_block_params& params)const {
+      uint64_t block_seq = 0;
+      ULTRAIN_ASSERT(history.find_block(params.block_num, block_seq), chain::unknown_block_exception,
+                     "block ${n} not found in local history", ("n", params.block_num));
+
+      get_block_result result;
+      result.last_irreversible_block = history.last_irreversible_block;
+      result.block = history.read<block_history_object>(*history.block_log, block_seq);
+      for (uint32_t i = 0; i < result.block.trx_count; ++i)
+         result.trxs.emplace_back(history.read<transaction_history_object>(*history.trx_log,
+                                                                           result.block.first_trx_seq + i));
+      return result;
+   }
+
+} /// namespace history
+
+#define CALL(api_name, api_handle, call_name, INVOKE, http_response_code) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle](string, string body, url_response_callback cb) mutable { \
+          try { \
+             if (body.empty()) body = "{}"; \
+             INVOKE \
+             cb(http_response_code, fc::json::to_string(result)); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+#define INVOKE_R_R(api_handle, call_name, in_param) \
+     auto result = api_handle.call_name(fc::json::from_string(body).as<in_param>());
+
+local_history_plugin::local_history_plugin():my(new local_history_plugin_impl()){}
+local_history_plugin::~local_history_plugin(){}
+
+void local_history_plugin::set_program_options(options_description&, options_description& cfg) {
+   cfg.add_options()
+         ("local-history-dir", bpo::value<bfs::path>()->default_value("history"),
+          "the location of the local history directory (absolute path or relative to application data dir)")
+         ("local-history-segment-size-mb", bpo::value<uint32_t>()->default_value(256),
+          "Maximum size in MiB of one local history segment file")
+         ("local-history-max-query-actions", bpo::value<uint32_t>()->default_value(1000),
+          "Maximum number of actions returned by one /v1/history/get_actions call")
+         ;
+}
+
+void local_history_plugin::plugin_initialize(const variables_map& options) {
+   try {
+      auto dir = options.at("local-history-dir").as<bfs::path>();
+      my->history_dir = dir.is_relative() ? app().data_dir() / dir : dir;
+      my->segment_size = uint64_t(options.at("local-history-segment-size-mb").as<uint32_t>()) * 1024 * 1024;
+      my->max_actions_per_query = options.at("local-history-max-query-actions").as<uint32_t>();
+      ULTRAIN_ASSERT(my->segment_size > 0, chain::plugin_config_exception, "local-history-segment-size-mb > 0 required");
+      ULTRAIN_ASSERT(my->max_actions_per_query > 0, chain::plugin_config_exception, "local-history-max-query-actions > 0 required");
+
+      my->open();
+
+      auto& chain = app().get_plugin<chain_plugin>().chain();
+      my->applied_transaction_connection.emplace(
+            chain.applied_transaction.connect( [&]( const transaction_trace_ptr& t ) {
+               my->applied_transaction( t );
+            } ));
+      my->irreversible_block_connection.emplace(
+            chain.irreversible_block.connect( [&]( const block_state_ptr& bs ) {
+               my->irreversible_block( bs );
+            } ));
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+void local_history_plugin::plugin_startup() {
+   ilog("starting local_history_plugin");
+   auto ro_api = get_read_only_api();
+
+   app().get_plugin<http_plugin>().add_api({
+      CALL(history, ro_api, get_actions,
+           INVOKE_R_R(ro_api, get_actions, history::read_only::get_actions_params), 200),
+      CALL(history, ro_api, get_transaction,
+           INVOKE_R_R(ro_api, get_transaction, history::read_only::get_transaction_params), 200),
+      CALL(history, ro_api, get_block,
+           INVOKE_R_R(ro_api, get_block, history::read_only::get_block_params), 200),
+   });
+}
+
+void local_history_plugin::plugin_shutdown() {
+   my->applied_transaction_connection.reset();
+   my->irreversible_block_connection.reset();
+   if (my->block_log) my->flush();
+}
+
+history::read_only local_history_plugin::get_read_only_api()const {
+   return history::read_only(*my);
+}
+
+#undef INVOKE_R_R
+#undef CALL
+
+}
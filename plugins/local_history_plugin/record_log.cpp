@@ -0,0 +1,227 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#include <ultrainio/local_history_plugin/record_log.hpp>
+#include <ultrainio/chain/exceptions.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fstream>
+
+#define LOG_READ  (std::ios::in | std::ios::binary)
+#define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
+
+namespace ultrainio { namespace history {
+
+   namespace bip = boost::interprocess;
+   namespace bfs = boost::filesystem;
+
+   namespace detail {
+      struct mapped_segment {
+         std::unique_ptr<bip::file_mapping>  mapping;
+         std::unique_ptr<bip::mapped_region> region;
+         uint64_t                            length = 0;
+      };
+
+      class record_log_impl {
+         public:
+            fc::path                 dir;
+            std::string              prefix;
+            uint64_t                 max_segment_size = 0;
+
+            mutable std::fstream     segment_stream;
+            mutable std::fstream     index_out;
+            mutable std::fstream     index_in;
+            uint32_t                 segment = 0;
+            uint64_t                 segment_size = 0;
+            uint64_t                 count = 0;
+            mutable bool             dirty = false;
+
+            mutable std::map<uint32_t, mapped_segment> mapped;
+
+            fc::path segment_file(uint32_t s)const {
+               return dir / (prefix + "." + std::to_string(s) + ".log");
+            }
+
+            fc::path index_file()const {
+               return dir / (prefix + ".index");
+            }
+
+            static uint32_t segment_of(uint64_t locator) { return uint32_t(locator >> 40); }
+            static uint64_t offset_of(uint64_t locator) { return locator & record_log::max_segment_offset; }
+
+            void open_segment(uint32_t s) {
+               if (segment_stream.is_open())
+                  segment_stream.close();
+               segment = s;
+               segment_stream.open(segment_file(s).generic_string().c_str(), LOG_WRITE);
+               segment_size = bfs::exists(segment_file(s)) ? bfs::file_size(segment_file(s)) : 0;
+            }
+
+            void open_index() {
+               if (index_out.is_open()) index_out.close();
+               if (index_in.is_open()) index_in.close();
+               index_out.open(index_file().generic_string().c_str(), LOG_WRITE);
+               index_in.open(index_file().generic_string().c_str(), LOG_READ);
+            }
+
+            uint64_t locator_at(uint64_t seq)const {
+               flush_writes();
+               uint64_t locator = 0;
+               index_in.clear();
+               index_in.seekg(seq * sizeof(uint64_t));
+               index_in.read((char*)&locator, sizeof(locator));
+               ULTRAIN_ASSERT(index_in.good(), chain::plugin_exception,
+                              "failed to read history index ${p} at ${s}", ("p", prefix)("s", seq));
+               return locator;
+            }
+
+            void flush_writes()const {
+               if (dirty) {
+                  segment_stream.flush();
+                  index_out.flush();
+                  dirty = false;
+               }
+            }
+
+            const char* map(uint32_t s, uint64_t end)const {
+               auto& m = mapped[s];
+               if (!m.region || m.length < end) {
+                  flush_writes();
+                  auto path = segment_file(s).generic_string();
+                  m.region.reset();
+                  m.mapping.reset(new bip::file_mapping(path.c_str(), bip::read_only));
+                  m.region.reset(new bip::mapped_region(*m.mapping, bip::read_only));
+                  m.length = m.region->get_size();
+                  ULTRAIN_ASSERT(m.length >= end, chain::plugin_exception,
+                                 "history segment ${f} is shorter than expected", ("f", path));
+               }
+               return static_cast<const char*>(m.region->get_address());
+            }
+
+            /// Drop index entries that point past the end of their segment, i.e. writes that were
+            /// interrupted before both files reached the disk.
+            void recover() {
+               uint64_t entries = bfs::file_size(index_file()) / sizeof(uint64_t);
+               while (entries > 0) {
+                  uint64_t locator = locator_at(entries - 1);
+                  auto f = segment_file(segment_of(locator));
+                  if (bfs::exists(f) && bfs::file_size(f) >= offset_of(locator) + sizeof(uint32_t)) {
+                     uint32_t size = 0;
+                     std::ifstream in(f.generic_string().c_str(), LOG_READ);
+                     in.seekg(offset_of(locator));
+                     in.read((char*)&size, sizeof(size));
+                     if (in.good() && bfs::file_size(f) >= offset_of(locator) + sizeof(size) + size)
+                        break;
+                  }
+                  --entries;
+               }
+               if (entries * sizeof(uint64_t) != bfs::file_size(index_file())) {
+                  wlog("history log ${p} truncated to ${n} entries", ("p", prefix)("n", entries));
+                  bfs::resize_file(index_file(), entries * sizeof(uint64_t));
+               }
+               count = entries;
+            }
+      };
+   }
+
+   record_log::record_log(const fc::path& dir, const std::string& prefix, uint64_t max_segment_size)
+   :my(new detail::record_log_impl()) {
+      my->dir = dir;
+      my->prefix = prefix;
+      my->max_segment_size = std::min(max_segment_size, max_segment_offset);
+      if (!fc::is_directory(dir))
+         fc::create_directories(dir);
+
+      my->open_index();
+      my->recover();
+
+      // cut the segments back to the last indexed entry, including segments it never reached
+      uint32_t last_segment = 0;
+      uint64_t end = 0;
+      if (my->count > 0) {
+         uint64_t locator = my->locator_at(my->count - 1);
+         last_segment = my->segment_of(locator);
+         uint32_t size = 0;
+         std::ifstream in(my->segment_file(last_segment).generic_string().c_str(), LOG_READ);
+         in.seekg(my->offset_of(locator));
+         in.read((char*)&size, sizeof(size));
+         end = my->offset_of(locator) + sizeof(size) + size;
+      }
+      for (uint32_t extra = last_segment + 1; bfs::exists(my->segment_file(extra)); ++extra)
+         bfs::remove(my->segment_file(extra));
+      if (bfs::exists(my->segment_file(last_segment)) && bfs::file_size(my->segment_file(last_segment)) != end)
+         bfs::resize_file(my->segment_file(last_segment), end);
+      my->open_segment(last_segment);
+   }
+
+   record_log::~record_log() {
+      if (my) flush();
+   }
+
+   uint64_t record_log::append(const std::vector<char>& entry) {
+      uint32_t size = entry.size();
+      if (my->segment_size > 0 && my->segment_size + sizeof(size) + size > my->max_segment_size) {
+         my->segment_stream.flush();
+         my->open_segment(my->segment + 1);
+      }
+
+      uint64_t locator = (uint64_t(my->segment) << 40) | my->segment_size;
+      my->segment_stream.write((const char*)&size, sizeof(size));
+      my->segment_stream.write(entry.data(), size);
+      my->index_out.write((const char*)&locator, sizeof(locator));
+      ULTRAIN_ASSERT(my->segment_stream.good() && my->index_out.good(), chain::plugin_exception,
+                     "failed to append to history log ${p}", ("p", my->prefix));
+
+      my->segment_size += sizeof(size) + size;
+      my->dirty = true;
+      return my->count++;
+   }
+
+   std::vector<char> record_log::read(uint64_t seq)const {
+      ULTRAIN_ASSERT(seq < my->count, chain::plugin_exception,
+                     "history sequence ${s} out of range for ${p}", ("s", seq)("p", my->prefix));
+      uint64_t locator = my->locator_at(seq);
+      uint32_t s = my->segment_of(locator);
+      uint64_t offset = my->offset_of(locator);
+
+      const char* base = my->map(s, offset + sizeof(uint32_t));
+      uint32_t size = 0;
+      memcpy(&size, base + offset, sizeof(size));
+      base = my->map(s, offset + sizeof(size) + size);
+      return std::vector<char>(base + offset + sizeof(size), base + offset + sizeof(size) + size);
+   }
+
+   uint64_t record_log::size()const {
+      return my->count;
+   }
+
+   void record_log::flush() {
+      my->flush_writes();
+   }
+
+   void record_log::truncate(uint64_t seq) {
+      if (seq >= my->count)
+         return;
+      flush();
+      uint64_t locator = my->locator_at(seq);
+      uint32_t s = my->segment_of(locator);
+
+      my->segment_stream.close();
+      my->index_out.close();
+      my->index_in.close();
+      my->mapped.clear();
+      for (uint32_t extra = s + 1; bfs::exists(my->segment_file(extra)); ++extra)
+         bfs::remove(my->segment_file(extra));
+      bfs::resize_file(my->segment_file(s), my->offset_of(locator));
+      bfs::resize_file(my->index_file(), seq * sizeof(uint64_t));
+
+      my->count = seq;
+      my->open_index();
+      my->open_segment(s);
+   }
+
+} } /// ultrainio::history
@@ -0,0 +1,415 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#include <ultrainio/local_history_plugin/sorted_index.hpp>
+#include <ultrainio/chain/exceptions.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <queue>
+#include <vector>
+
+#define LOG_READ  (std::ios::in | std::ios::binary)
+#define LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
+#define LOG_REWRITE (std::ios::out | std::ios::binary | std::ios::trunc)
+
+namespace ultrainio { namespace history {
+
+   namespace bip = boost::interprocess;
+   namespace bfs = boost::filesystem;
+
+   namespace detail {
+      struct sorted_run {
+         uint64_t                            start = 0;
+         uint64_t                            end = 0;
+         uint64_t                            entries = 0;
+         fc::path                            file;
+         std::unique_ptr<bip::file_mapping>  mapping;
+         std::unique_ptr<bip::mapped_region> region;
+
+         const char* data()const { return static_cast<const char*>(region->get_address()); }
+
+         void unmap() {
+            region.reset();
+            mapping.reset();
+         }
+      };
+
+      class sorted_index_impl {
+         public:
+            fc::path                                        dir;
+            std::string                                     prefix;
+            uint32_t                                        key_size = 0;
+            uint64_t                                        run_entries = 0;
+
+            /// consecutive sequence ranges starting at 0
+            std::vector<sorted_run>                         runs;
+            /// entries with seq >= runs_end(), also in the wal
+            std::map<std::string, std::vector<uint64_t>>    table;
+            uint64_t                                        table_entries = 0;
+            uint64_t                                        next = 0;
+            std::fstream                                    wal;
+
+            uint32_t entry_size()const { return key_size + sizeof(uint64_t); }
+            uint64_t runs_end()const { return runs.empty() ? 0 : runs.back().end; }
+
+            fc::path wal_file()const {
+               return dir / (prefix + ".wal");
+            }
+
+            fc::path run_file(uint64_t start, uint64_t end)const {
+               return dir / (prefix + "." + std::to_string(start) + "-" + std::to_string(end) + ".run");
+            }
+
+            /// runs are ordered by the size class of their entry count, fanout runs of a class merge into the next
+            uint32_t level(uint64_t entries)const {
+               uint32_t l = 0;
+               for (uint64_t n = entries / run_entries; n >= sorted_index::fanout; n /= sorted_index::fanout)
+                  ++l;
+               return l;
+            }
+
+            uint64_t seq_at(const sorted_run& r, uint64_t i)const {
+               uint64_t seq = 0;
+               memcpy(&seq, r.data() + i * entry_size() + key_size, sizeof(seq));
+               return seq;
+            }
+
+            /// first entry of r whose key is not less than key, or greater than key if upper
+            uint64_t bound(const sorted_run& r, const char* key, bool upper)const {
+               uint64_t lo = 0, hi = r.entries;
+               while (lo < hi) {
+                  uint64_t mid = lo + (hi - lo) / 2;
+                  int c = memcmp(r.data() + mid * entry_size(), key, key_size);
+                  if (c < 0 || (upper && c == 0))
+                     lo = mid + 1;
+                  else
+                     hi = mid;
+               }
+               return lo;
+            }
+
+            void write_entry(std::ostream& out, const char* key, uint64_t seq)const {
+               out.write(key, key_size);
+               out.write((const char*)&seq, sizeof(seq));
+            }
+
+            void map(sorted_run& r) {
+               r.unmap();
+               r.entries = bfs::file_size(r.file) / entry_size();
+               if (r.entries == 0)
+                  return;
+               r.mapping.reset(new bip::file_mapping(r.file.generic_string().c_str(), bip::read_only));
+               r.region.reset(new bip::mapped_region(*r.mapping, bip::read_only));
+            }
+
+            /// moves a fully written temporary file in place as run r
+            void install(sorted_run& r, const fc::path& tmp) {
+               r.file = run_file(r.start, r.end);
+               bfs::rename(tmp, r.file);
+               map(r);
+            }
+
+            void rewrite_wal() {
+               if (wal.is_open())
+                  wal.close();
+               {
+                  std::ofstream out(wal_file().generic_string().c_str(), LOG_REWRITE);
+                  for (const auto& kv : table)
+                     for (auto seq : kv.second)
+                        write_entry(out, kv.first.data(), seq);
+                  ULTRAIN_ASSERT(out.good(), chain::plugin_exception, "failed to write history index ${p}", ("p", prefix));
+               }
+               wal.open(wal_file().generic_string().c_str(), LOG_WRITE);
+            }
+
+            /// writes the memory table as the run [runs_end(), next) and empties the wal
+            void write_table() {
+               sorted_run r;
+               r.start = runs_end();
+               r.end = next;
+               auto tmp = run_file(r.start, r.end).generic_string() + ".tmp";
+               {
+                  std::ofstream out(tmp.c_str(), LOG_REWRITE);
+                  for (const auto& kv : table)
+                     for (auto seq : kv.second)
+                        write_entry(out, kv.first.data(), seq);
+                  ULTRAIN_ASSERT(out.good(), chain::plugin_exception, "failed to write history index ${p}", ("p", prefix));
+               }
+               install(r, tmp);
+               runs.push_back(std::move(r));
+
+               table.clear();
+               table_entries = 0;
+               rewrite_wal();
+               compact();
+            }
+
+            void compact() {
+               while (runs.size() >= sorted_index::fanout) {
+                  size_t first = runs.size() - sorted_index::fanout;
+                  uint32_t l = level(runs.back().entries);
+                  for (size_t i = first; i < runs.size(); ++i)
+                     if (level(runs[i].entries) != l)
+                        return;
+                  merge(first);
+               }
+            }
+
+            /// replaces runs[first..] by one run, the merged run is in place before the old ones go
+            void merge(size_t first) {
+               struct cursor {
+                  const sorted_run* run;
+                  uint64_t          pos;
+               };
+               auto greater = [this](const cursor& a, const cursor& b) {
+                  int c = memcmp(a.run->data() + a.pos * entry_size(), b.run->data() + b.pos * entry_size(), key_size);
+                  return c > 0 || (c == 0 && seq_at(*a.run, a.pos) > seq_at(*b.run, b.pos));
+               };
+               std::priority_queue<cursor, std::vector<cursor>, decltype(greater)> heap(greater);
+               for (size_t i = first; i < runs.size(); ++i)
+                  if (runs[i].entries > 0)
+                     heap.push(cursor{&runs[i], 0});
+
+               sorted_run merged;
+               merged.start = runs[first].start;
+               merged.end = runs.back().end;
+               auto tmp = run_file(merged.start, merged.end).generic_string() + ".tmp";
+               {
+                  std::ofstream out(tmp.c_str(), LOG_REWRITE);
+                  while (!heap.empty()) {
+                     cursor c = heap.top();
+                     heap.pop();
+                     out.write(c.run->data() + c.pos * entry_size(), entry_size());
+                     if (++c.pos < c.run->entries)
+                        heap.push(c);
+                  }
+                  ULTRAIN_ASSERT(out.good(), chain::plugin_exception, "failed to merge history index ${p}", ("p", prefix));
+               }
+               install(merged, tmp);
+
+               for (size_t i = first; i < runs.size(); ++i) {
+                  runs[i].unmap();
+                  bfs::remove(runs[i].file);
+               }
+               runs.erase(runs.begin() + first, runs.end());
+               runs.push_back(std::move(merged));
+            }
+
+            static bool parse_range(const std::string& s, uint64_t& start, uint64_t& end) {
+               auto dash = s.find('-');
+               if (dash == 0 || dash == std::string::npos || dash + 1 == s.size())
+                  return false;
+               if (s.find_first_not_of("0123456789-") != std::string::npos || s.find('-', dash + 1) != std::string::npos)
+                  return false;
+               start = std::stoull(s.substr(0, dash));
+               end = std::stoull(s.substr(dash + 1));
+               return start < end;
+            }
+
+            /// Keep the runs that cover [0, end) without a gap. A run inside an earlier one is what a merge
+            /// left behind, a gap means a run never made it to disk and everything after it is dropped.
+            void open_runs() {
+               const std::string run_prefix = prefix + ".";
+               const std::string run_suffix = ".run";
+               std::vector<sorted_run> found;
+               std::vector<fc::path> partial;
+               for (bfs::directory_iterator itr(dir); itr != bfs::directory_iterator(); ++itr) {
+                  auto name = itr->path().filename().string();
+                  if (name.compare(0, run_prefix.size(), run_prefix) != 0)
+                     continue;
+                  if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+                     partial.push_back(itr->path());
+                     continue;
+                  }
+                  if (name.size() <= run_prefix.size() + run_suffix.size() ||
+                      name.compare(name.size() - run_suffix.size(), run_suffix.size(), run_suffix) != 0)
+                     continue;
+                  sorted_run r;
+                  if (!parse_range(name.substr(run_prefix.size(), name.size() - run_prefix.size() - run_suffix.size()),
+                                   r.start, r.end))
+                     continue;
+                  r.file = itr->path();
+                  found.push_back(std::move(r));
+               }
+               for (const auto& f : partial)
+                  bfs::remove(f);
+               std::sort(found.begin(), found.end(), [](const sorted_run& a, const sorted_run& b) {
+                  return a.start < b.start || (a.start == b.start && a.end > b.end);
+               });
+
+               uint64_t end = 0;
+               for (auto& r : found) {
+                  if (r.end > end && r.start == end && bfs::file_size(r.file) % entry_size() == 0) {
+                     map(r);
+                     end = r.end;
+                     runs.push_back(std::move(r));
+                  } else {
+                     if (r.end > end)
+                        wlog("history index ${f} does not follow the run before it, dropped",
+                             ("f", r.file.generic_string()));
+                     bfs::remove(r.file);
+                  }
+               }
+            }
+
+            /// Load the wal into the memory table. A crash can tear the wal inside the entries of the
+            /// highest sequence number, so they are dropped and have to be added again.
+            void open_wal() {
+               std::vector<std::pair<std::string, uint64_t>> loaded;
+               uint64_t file_entries = 0;
+               uint64_t highest = 0;
+               if (bfs::exists(wal_file())) {
+                  std::ifstream in(wal_file().generic_string().c_str(), LOG_READ);
+                  std::vector<char> entry(entry_size());
+                  while (in.read(entry.data(), entry.size())) {
+                     ++file_entries;
+                     uint64_t seq = 0;
+                     memcpy(&seq, entry.data() + key_size, sizeof(seq));
+                     // entries a run already holds are left over from a crash before the wal was emptied
+                     if (seq < runs_end())
+                        continue;
+                     loaded.emplace_back(std::string(entry.data(), key_size), seq);
+                     highest = std::max(highest, seq);
+                  }
+               }
+
+               next = runs_end();
+               if (!loaded.empty()) {
+                  loaded.erase(std::remove_if(loaded.begin(), loaded.end(), [highest](const auto& e) {
+                     return e.second == highest;
+                  }), loaded.end());
+                  next = highest;
+               }
+               for (const auto& e : loaded)
+                  table[e.first].push_back(e.second);
+               table_entries = loaded.size();
+
+               if (!bfs::exists(wal_file()) || file_entries != loaded.size() ||
+                   bfs::file_size(wal_file()) != file_entries * entry_size())
+                  rewrite_wal();
+               else
+                  wal.open(wal_file().generic_string().c_str(), LOG_WRITE);
+            }
+      };
+   }
+
+   sorted_index::sorted_index(const fc::path& dir, const std::string& prefix, uint32_t key_size, uint64_t run_entries)
+   :my(new detail::sorted_index_impl()) {
+      my->dir = dir;
+      my->prefix = prefix;
+      my->key_size = key_size;
+      my->run_entries = std::max<uint64_t>(run_entries, 1);
+      if (!fc::is_directory(dir))
+         fc::create_directories(dir);
+
+      my->open_runs();
+      my->open_wal();
+   }
+
+   sorted_index::~sorted_index() {
+      if (my) my->wal.flush();
+   }
+
+   void sorted_index::add(const char* key, uint64_t seq) {
+      ULTRAIN_ASSERT(seq >= my->runs_end() && seq + 1 >= my->next, chain::plugin_exception,
+                     "history index ${p} out of sequence at ${s}", ("p", my->prefix)("s", seq));
+      my->write_entry(my->wal, key, seq);
+      ULTRAIN_ASSERT(my->wal.good(), chain::plugin_exception, "failed to append to history index ${p}", ("p", my->prefix));
+      my->table[std::string(key, my->key_size)].push_back(seq);
+      ++my->table_entries;
+      my->next = std::max(my->next, seq + 1);
+   }
+
+   uint64_t sorted_index::count(const char* key)const {
+      uint64_t n = 0;
+      for (const auto& r : my->runs)
+         if (r.entries > 0)
+            n += my->bound(r, key, true) - my->bound(r, key, false);
+      auto itr = my->table.find(std::string(key, my->key_size));
+      if (itr != my->table.end())
+         n += itr->second.size();
+      return n;
+   }
+
+   uint64_t sorted_index::at(const char* key, uint64_t i)const {
+      // runs hold increasing sequence ranges, so the i-th one is found by skipping whole runs
+      for (const auto& r : my->runs) {
+         if (r.entries == 0)
+            continue;
+         uint64_t lower = my->bound(r, key, false);
+         uint64_t n = my->bound(r, key, true) - lower;
+         if (i < n)
+            return my->seq_at(r, lower + i);
+         i -= n;
+      }
+      auto itr = my->table.find(std::string(key, my->key_size));
+      ULTRAIN_ASSERT(itr != my->table.end() && i < itr->second.size(), chain::plugin_exception,
+                     "history index ${p} position out of range", ("p", my->prefix));
+      return itr->second[i];
+   }
+
+   uint64_t sorted_index::end()const {
+      return my->next;
+   }
+
+   void sorted_index::flush() {
+      my->wal.flush();
+      if (my->table_entries >= my->run_entries)
+         my->write_table();
+   }
+
+   void sorted_index::truncate(uint64_t seq) {
+      if (seq >= my->next)
+         return;
+
+      for (auto itr = my->table.begin(); itr != my->table.end(); ) {
+         auto& seqs = itr->second;
+         while (!seqs.empty() && seqs.back() >= seq) {
+            seqs.pop_back();
+            --my->table_entries;
+         }
+         if (seqs.empty())
+            itr = my->table.erase(itr);
+         else
+            ++itr;
+      }
+      my->rewrite_wal();
+
+      while (!my->runs.empty() && my->runs.back().start >= seq) {
+         my->runs.back().unmap();
+         bfs::remove(my->runs.back().file);
+         my->runs.pop_back();
+      }
+      // the run holding seq is rewritten without the entries past it, its old file goes first so a
+      // crash in between leaves a gap that open() drops rather than stale entries
+      if (!my->runs.empty() && my->runs.back().end > seq) {
+         auto& old = my->runs.back();
+         detail::sorted_run cut;
+         cut.start = old.start;
+         cut.end = seq;
+         auto tmp = my->run_file(cut.start, cut.end).generic_string() + ".tmp";
+         {
+            std::ofstream out(tmp.c_str(), LOG_REWRITE);
+            for (uint64_t i = 0; i < old.entries; ++i)
+               if (my->seq_at(old, i) < seq)
+                  out.write(old.data() + i * my->entry_size(), my->entry_size());
+            ULTRAIN_ASSERT(out.good(), chain::plugin_exception, "failed to write history index ${p}", ("p", my->prefix));
+         }
+         old.unmap();
+         bfs::remove(old.file);
+         my->install(cut, tmp);
+         old = std::move(cut);
+      }
+      my->next = seq;
+      wlog("history index ${p} truncated to ${s}", ("p", my->prefix)("s", seq));
+   }
+
+} } /// ultrainio::history
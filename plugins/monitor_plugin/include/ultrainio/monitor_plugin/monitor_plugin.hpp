@@ -5,6 +5,8 @@
 #pragma once
 #include <appbase/application.hpp>
 #include <ultrainio/producer_rpos_plugin/producer_rpos_plugin.hpp>
+#include <ultrainio/http_plugin/http_plugin.hpp>
+#include <base/LatencyHistogram.h>
 #include "uranus_node_monitor.hpp"
 #include "uranus_controller_monitor.hpp"
 
@@ -65,6 +67,14 @@ class monitor_only {
 
       monitor_echo_ap_cache_result monitor_echo_ap_cache(const monitor_echo_ap_cache_params& params) const;
 
+      struct monitor_latency_params {};
+      struct monitor_latency_result {
+            std::vector<LatencySummary>   histograms;
+      };
+
+      // percentiles of the consensus and network latency histograms, /v1/monitor/metrics has the buckets
+      monitor_latency_result monitor_latency(const monitor_latency_params& params) const;
+
       //client request to monitor central server
       void getDynamicNodeData(periodic_report_dynamic_data& reportData);
       void getDynamicOsData(periodic_report_dynamic_data& reportData);
@@ -97,7 +107,7 @@ public:
    monitor_plugin();
    virtual ~monitor_plugin();
  
-   APPBASE_PLUGIN_REQUIRES((producer_rpos_plugin))
+   APPBASE_PLUGIN_REQUIRES((producer_rpos_plugin)(http_plugin))
    virtual void set_program_options(options_description&, options_description& cfg) override;
  
    void plugin_initialize(const variables_map& options);
@@ -129,4 +139,8 @@ FC_REFLECT( ultrainio::monitor_apis::monitor_only::monitor_echo_cache_result, (e
 
 FC_REFLECT( ultrainio::monitor_apis::monitor_only::monitor_echo_ap_cache_result, (echoApCache) )
 
+FC_REFLECT( ultrainio::LatencySummary, (name)(labels)(count)(sumUs)(maxUs)(p50Us)(p90Us)(p99Us)(p999Us) )
+FC_REFLECT( ultrainio::monitor_apis::monitor_only::monitor_latency_params, )
+FC_REFLECT( ultrainio::monitor_apis::monitor_only::monitor_latency_result, (histograms) )
+
 FC_REFLECT( ultrainio::alert_info, (alertType)(chainName)(blockNum)(nodeInfo)(reason)(remark) )
@@ -55,7 +55,7 @@ namespace ultrainio {
             if (pController) {
                 auto ite = pController->m_proposerMsgMap.find(bid);
                 if(ite != pController->m_proposerMsgMap.end()){
-                    tempHeaderDigest.digestFromBlockHeader(ite->second.block.id());
+                    tempHeaderDigest.digestFromBlockHeader(ite->second.blockId());
                 } else {
                     ULTRAIN_THROW(chain::msg_not_found_exception, "Propose msg not found by id." );
                 }
@@ -81,11 +81,11 @@ namespace ultrainio {
             std::vector<BlockHeaderDigest> tempDigestVect;
             std::shared_ptr<Scheduler> pController = m_pController.lock();
             if (pController) {
-                auto ite = pController->m_cacheProposeMsgMap.find(info);
-                if(ite != pController->m_cacheProposeMsgMap.end()) {
-                    for(const auto& proposeMsg : ite->second){
+                const ProposeCacheSlot* slot = pController->m_cacheProposeMsgMap.find(info);
+                if(slot) {
+                    for(const auto& proposeMsg : slot->msgs){
                         BlockHeaderDigest tempHeader;
-                        tempHeader.digestFromBlockHeader(proposeMsg.block.id());
+                        tempHeader.digestFromBlockHeader(proposeMsg.blockId());
                         tempDigestVect.push_back(tempHeader);
                     }
                 } else {
@@ -99,9 +99,9 @@ namespace ultrainio {
             std::vector<EchoMsgDigest> tempEchoDigestVect;
             std::shared_ptr<Scheduler> pController = m_pController.lock();
             if (pController) {
-                auto ite = pController->m_cacheEchoMsgMap.find(info);
-                if(ite != pController->m_cacheEchoMsgMap.end()) {
-                    for(const auto& echoMsg : ite->second) {
+                const EchoCacheSlot* slot = pController->m_cacheEchoMsgMap.find(info);
+                if(slot) {
+                    for(const auto& echoMsg : slot->msgs) {
                         EchoMsgDigest tempEchoMsg;
                         tempEchoMsg.digestFromeEchoMsg(echoMsg);
                         tempEchoDigestVect.push_back(tempEchoMsg);
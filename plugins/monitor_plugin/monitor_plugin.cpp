@@ -238,11 +238,44 @@ void monitor_plugin::plugin_initialize(const variables_map& options) {
    context = ultrainio::client::http::create_http_context();
 }
 
+#define CALL(api_name, api_handle, call_name, INVOKE, http_response_code) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle](string, string body, url_response_callback cb) mutable { \
+          try { \
+             if (body.empty()) body = "{}"; \
+             INVOKE \
+             cb(http_response_code, fc::json::to_string(result)); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+#define INVOKE_R_R(api_handle, call_name, in_param) \
+     auto result = api_handle.call_name(fc::json::from_string(body).as<in_param>());
+
 void monitor_plugin::plugin_startup() {
    // Make the magic happen
    my->startup();
+
+   auto ro_api = get_monitor_only_api();
+   app().get_plugin<http_plugin>().add_api({
+      CALL(monitor, ro_api, monitor_latency,
+           INVOKE_R_R(ro_api, monitor_latency, monitor_apis::monitor_only::monitor_latency_params), 200),
+      // Prometheus text exposition of the latency histograms
+      {std::string("/v1/monitor/metrics"),
+       [](string, string body, url_response_callback cb) {
+          try {
+             cb(200, LatencyRegistry::getInstance().toPrometheus());
+          } catch (...) {
+             http_plugin::handle_exception("monitor", "metrics", body, cb);
+          }
+       }}
+   });
 }
 
+#undef INVOKE_R_R
+#undef CALL
+
 void monitor_plugin::plugin_shutdown() {
    // OK, that's enough magic
    my->shutdown();
@@ -296,6 +329,10 @@ monitor_apis::monitor_only  monitor_plugin::get_monitor_only_api()const {
         return {controllerMonitor.findEchoApMsgByKey(params)};
      }
 
+     monitor_only::monitor_latency_result monitor_only::monitor_latency(const monitor_only::monitor_latency_params& params) const {
+        return {LatencyRegistry::getInstance().summaries()};
+     }
+
      void monitor_only::getDynamicNodeData(periodic_report_dynamic_data& reportData) {
         if(nullptr == m_nodeMonitor) {
             auto nodePtr = getNodePtr();
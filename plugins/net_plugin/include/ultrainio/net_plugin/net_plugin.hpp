@@ -28,6 +28,7 @@ namespace ultrainio { namespace net_plugin_n {
         void   broadcast(const EchoMsg& echo);
         void   broadcast(const SignedTransaction& trx);
         void   send_block(const fc::sha256 &node_id, const SyncBlockMsg& sync_block);
+        bool   send_block(const fc::sha256 &node_id, uint32_t seq_num, const std::vector<char>& packed_block, const std::string& proof);
         bool   send_req_sync(const ReqSyncMsg& reqSyncMsg);
         void   send_block_num_range(const fc::sha256 &node_id, const RspBlockNumRangeMsg& last_block_num);
         void   stop_sync_block();
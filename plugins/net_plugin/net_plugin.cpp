@@ -8,10 +8,18 @@
 #include <ultrainio/chain/controller.hpp>
 #include <ultrainio/chain/exceptions.hpp>
 #include <ultrainio/chain/block.hpp>
+#include <ultrainio/chain/config.hpp>
 #include <ultrainio/chain/plugin_interface.hpp>
 #include <ultrainio/producer_rpos_plugin/producer_rpos_plugin.hpp>
 #include <ultrainio/utilities/key_conversion.hpp>
 #include <ultrainio/chain/contract_types.hpp>
+#include <base/LatencyHistogram.h>
+#include <crypto/Validator.h>
+#include <lightclient/CheckPoint.h>
+#include <lightclient/ConfirmPoint.h>
+#include <lightclient/EpochEndPoint.h>
+#include <lightclient/Helper.h>
+#include <lightclient/StartPoint.h>
 
 namespace fc {
     extern std::unordered_map<std::string,logger>& get_logger_map();
@@ -167,10 +175,14 @@ namespace ultrainio { namespace net_plugin_n {
         void handle_message( connection_ptr c, const ultrainio::ReqSyncMsg& msg);
         void handle_message( connection_ptr c, const ultrainio::SyncBlockMsg& msg);
         void handle_message( connection_ptr c, const ultrainio::SyncStopMsg& msg);
+        /** \brief Move the blocks that follow the synced chain from the reorder buffer to the block queue
+         */
+        void drain_sync_blocks();
 
         void start_broadcast(const net_message& msg, msg_priority p);
         void start_broadcast(const SignedTransaction& trx);
         void send_block(const fc::sha256& node_id, const net_message& msg);
+        bool send_block(const fc::sha256& node_id, uint32_t seq_num, const std::vector<char>& packed_block, const std::string& proof);
         bool send_req_sync(const ultrainio::ReqSyncMsg& msg);
         void send_block_num_range(const fc::sha256& node_id, const net_message& msg);
         void stop_sync_block();
@@ -265,6 +277,8 @@ namespace ultrainio { namespace net_plugin_n {
     constexpr auto     def_txn_expire_wait = std::chrono::seconds(12);
     constexpr auto     def_resp_expected_wait = std::chrono::seconds(5);
     constexpr auto     def_sync_fetch_span = 100;
+    constexpr uint32_t def_sync_credit_window = 128;
+    constexpr uint32_t def_sync_max_peers = 4;
     constexpr uint32_t  def_max_just_send = 1500; // roughly 1 "mtu"
     constexpr bool     large_msg_notify = false;
 
@@ -309,6 +323,8 @@ namespace ultrainio { namespace net_plugin_n {
 
         static const uint32_t MAX_OUT_QUEUE = 1000;
         static const uint32_t MAX_WRITE_QUEUE = 100000;
+        static const uint32_t MAX_SYNC_WRITE_QUEUE = 256;
+        static const uint32_t SYNC_WRITE_LOW_WATER = MAX_SYNC_WRITE_QUEUE / 4;
 
         peer_block_state_index  blk_state;
         transaction_state_index trx_state;
@@ -326,6 +342,7 @@ namespace ultrainio { namespace net_plugin_n {
         connection_direction    direct = direction_in;
         deque<queued_write>     write_queue;
         deque<queued_write>     out_queue;
+        bool                    sync_write_blocked = false; // a sync stream found write_queue full
         fc::sha256              node_id;
         handshake_message       last_handshake_recv;
         handshake_message       last_handshake_sent;
@@ -448,6 +465,46 @@ namespace ultrainio { namespace net_plugin_n {
         }
     };
 
+    /**
+     * Per message type latency histograms, exported by monitor_plugin: the time a message waits in the
+     * write queue of a connection until it is on the wire, and the time to handle a received message.
+     */
+    class net_latency {
+    public:
+        static net_latency& instance() {
+            static net_latency latency;
+            return latency;
+        }
+
+        LatencyHistogram& send_queue(int which) {
+            return *send_queue_histograms[which];
+        }
+
+        LatencyHistogram& handle(int which) {
+            return *handle_histograms[which];
+        }
+
+    private:
+        net_latency() {
+            static const char* const names[] = {"handshake_message", "go_away_message", "time_message",
+                                                "notice_message", "request_message", "packed_transaction",
+                                                "ProposeMsg", "EchoMsg", "ReqSyncMsg", "SyncBlockMsg",
+                                                "SyncStopMsg", "ReqBlockNumRangeMsg", "RspBlockNumRangeMsg"};
+            LatencyRegistry& registry = LatencyRegistry::getInstance();
+            for (uint32_t i = 0; i < net_message::count(); i++) {
+                string name = i < sizeof(names) / sizeof(names[0]) ? string(names[i]) : std::to_string(i);
+                string labels = "msg=\"" + name + "\"";
+                send_queue_histograms.push_back(&registry.get("ultrain_net_send_queue_us", labels,
+                        "Time from enqueue of a message to the completion of its write"));
+                handle_histograms.push_back(&registry.get("ultrain_net_handle_us", labels,
+                        "Time to handle a received message"));
+            }
+        }
+
+        vector<LatencyHistogram*> send_queue_histograms;
+        vector<LatencyHistogram*> handle_histograms;
+    };
+
     struct msgHandler : public fc::visitor<void> {
         net_plugin_impl &impl;
         connection_ptr c;
@@ -461,6 +518,23 @@ namespace ultrainio { namespace net_plugin_n {
 
     class sync_block_manager {
     public:
+        // a block range fetched from one peer, its blocks arrive in order
+        struct sync_range {
+            connection_ptr                   conn;
+            uint32_t                         start_block;
+            uint32_t                         end_block;
+            uint32_t                         next_block;
+            BlockIdType                      last_id;
+            uint32_t                         received_in_period = 0;
+            uint32_t                         ungranted_credits = 0;
+            bool                             streaming = false;
+        };
+
+        struct pending_block {
+            SyncBlockMsg                     msg;
+            connection_ptr                   conn;
+        };
+
         uint32_t                         seq_num;
         uint32_t                         last_received_block;
         uint32_t                         last_checked_block;
@@ -474,6 +548,20 @@ namespace ultrainio { namespace net_plugin_n {
         uint32_t                         last_safe_block_num;
         std::list<SyncBlockMsg>          block_msg_queue;
         bool                             selecting_src = false;
+        uint32_t                         credit_window = 0;
+        uint32_t                         fetch_span = 0;
+        uint32_t                         max_sync_peers = 1;
+        std::list<sync_range>            ranges;
+        std::map<uint32_t, uint32_t>     unassigned_ranges; // start -> end
+        std::vector<connection_ptr>      idle_conns;
+        std::map<uint32_t, pending_block> reorder_buffer;
+        uint32_t                         next_block_num;
+        BlockIdType                      last_block_id;
+        bool                             sync_conn_failed = false;
+        std::map<uint32_t, CommitteeSet> sync_committees; // first block signed by the committee -> committee
+        std::string                      next_committee_mroot;
+        std::string                      genesis_pk;
+        static const uint32_t            max_pending_blocks = 1000;
         boost::asio::steady_timer::duration   src_block_period;
         unique_ptr<boost::asio::steady_timer> src_block_check;
         boost::asio::steady_timer::duration   conn_timeout;
@@ -504,6 +592,16 @@ namespace ultrainio { namespace net_plugin_n {
             last_safe_block_num = 0;
             selecting_src = false;
             block_msg_queue.clear();
+            ranges.clear();
+            unassigned_ranges.clear();
+            idle_conns.clear();
+            reorder_buffer.clear();
+            next_block_num = 0;
+            last_block_id = BlockIdType();
+            sync_conn_failed = false;
+            sync_committees.clear();
+            next_committee_mroot.clear();
+            genesis_pk.clear();
 
             if (src_block_check) {
                 src_block_check->cancel();
@@ -526,9 +624,10 @@ namespace ultrainio { namespace net_plugin_n {
                          ("rcv", last_received_block)("chk", last_checked_block));
                     app().get_plugin<producer_rpos_plugin>().sync_cancel();
                     reset();
-                }else if (last_received_block <= last_checked_block || ec.value() != 0) {
+                }else if (!check_ranges() || ec.value() != 0) {
                     ilog("no block received in last period or error occur. last received:${rcv} last checked:${chk} ec:${ec}",
                          ("rcv", last_received_block)("chk", last_checked_block)("ec", ec.value()));
+                    stop_ranges();
                     app().get_plugin<producer_rpos_plugin>().sync_fail(sync_block_msg);
                     reset();
                 }else {
@@ -589,12 +688,342 @@ namespace ultrainio { namespace net_plugin_n {
                 }
             }
             end_block_num = sync_block_msg.endBlockNum;
-            con->enqueue(sync_block_msg);
             sync_conn = con;
+            plan_ranges();
             rsp_conns.clear();
+            assign_ranges();
             start_conn_check_timer();
         }
 
+        // Split the blocks to sync into sync-fetch-span ranges fetched from up to max_sync_peers peers at once.
+        // The range with the end block is left to sync_conn, which sends the proof of the last block.
+        void plan_ranges() {
+            ranges.clear();
+            unassigned_ranges.clear();
+            idle_conns.clear();
+            reorder_buffer.clear();
+            next_block_num = sync_block_msg.startBlockNum;
+            last_block_id = BlockIdType();
+            sync_conn_failed = false;
+
+            uint32_t start = sync_block_msg.startBlockNum;
+            uint32_t span = (max_sync_peers > 1) ? std::min(fetch_span, max_pending_blocks / 4) : 0;
+            if (span == 0 || end_block_num < start) {
+                unassigned_ranges[start] = end_block_num;
+            } else {
+                for (uint32_t s = start; s <= end_block_num; s += span) {
+                    unassigned_ranges[s] = (end_block_num - s < span) ? end_block_num : s + span - 1;
+                    if (unassigned_ranges[s] == end_block_num) {
+                        break;
+                    }
+                }
+            }
+
+            idle_conns.push_back(sync_conn);
+            if (span == 0) {
+                return;
+            }
+            for (auto& con : rsp_conns) {
+                if (idle_conns.size() >= max_sync_peers) {
+                    break;
+                }
+                if (con != sync_conn && con->current() && con->block_num_range.firstNum != 0
+                    && con->block_num_range.firstNum <= start && con->block_num_range.lastNum >= start) {
+                    idle_conns.push_back(con);
+                }
+            }
+            ilog("sync blocks ${s} - ${e} from ${n} peers in ${r} ranges",
+                 ("s", start)("e", end_block_num)("n", idle_conns.size())("r", unassigned_ranges.size()));
+        }
+
+        uint32_t buffered_blocks() const {
+            return block_msg_queue.size() + reorder_buffer.size();
+        }
+
+        uint32_t first_buffered_block() const {
+            return block_msg_queue.empty() ? next_block_num : block_msg_queue.front().block.block_num();
+        }
+
+        bool can_fetch(const connection_ptr& con, uint32_t start, uint32_t end) const {
+            if (end == end_block_num) {
+                return con == sync_conn;
+            }
+            if (start != next_block_num && end >= first_buffered_block() + max_pending_blocks) {
+                return false;
+            }
+            return con == sync_conn || (con->block_num_range.firstNum <= start && con->block_num_range.lastNum >= end);
+        }
+
+        void assign_ranges() {
+            if (!sync_conn) {
+                return;
+            }
+            for (auto c = idle_conns.begin(); c != idle_conns.end() && !unassigned_ranges.empty();) {
+                auto r = unassigned_ranges.begin();
+                while (r != unassigned_ranges.end() && !can_fetch(*c, r->first, r->second)) {
+                    ++r;
+                }
+                if (r == unassigned_ranges.end()) {
+                    ++c;
+                    continue;
+                }
+
+                sync_range range;
+                range.conn = *c;
+                range.start_block = r->first;
+                range.end_block = r->second;
+                range.next_block = r->first;
+                ultrainio::ReqSyncMsg req;
+                req.seqNum = seq_num;
+                req.startBlockNum = range.start_block;
+                req.endBlockNum = range.end_block;
+                if (credit_window > 0) {
+                    req.ext.push_back({kSyncCredit, std::to_string(credit_window)});
+                }
+                range.conn->enqueue(req);
+                ranges.push_back(range);
+                unassigned_ranges.erase(r);
+                c = idle_conns.erase(c);
+            }
+        }
+
+        std::list<sync_range>::iterator find_range(const connection_ptr& con) {
+            return std::find_if(ranges.begin(), ranges.end(), [&con](const sync_range& r) { return r.conn == con; });
+        }
+
+        // Take the rest of the range back from a slow or faulty peer, it is not used again in this sync.
+        std::list<sync_range>::iterator retire(std::list<sync_range>::iterator range) {
+            wlog("retire sync peer ${p}, blocks ${s} - ${e} are fetched again", ("p", range->conn->peer_name())("s", range->next_block)("e", range->end_block));
+            SyncStopMsg stop_msg;
+            stop_msg.seqNum = seq_num;
+            range->conn->enqueue(stop_msg);
+            unassigned_ranges[range->next_block] = range->end_block;
+            return ranges.erase(range);
+        }
+
+        void stop_ranges() {
+            SyncStopMsg stop_msg;
+            stop_msg.seqNum = seq_num;
+            for (auto& r : ranges) {
+                r.conn->enqueue(stop_msg);
+            }
+        }
+
+        // Buffer a block if it follows the previous one of its range, returns false if the peer is retired.
+        bool receive_block(std::list<sync_range>::iterator range, const SyncBlockMsg& msg) {
+            uint32_t num = msg.block.block_num();
+            if (num != range->next_block || (num > range->start_block && msg.block.previous != range->last_id)) {
+                elog("receive block ${n} not linked to its range ${s} - ${e} from ${p}",
+                     ("n", num)("s", range->start_block)("e", range->end_block)("p", range->conn->peer_name()));
+                if (range->conn == sync_conn) {
+                    sync_conn_failed = true;
+                } else {
+                    retire(range);
+                    assign_ranges();
+                }
+                return false;
+            }
+
+            range->last_id = msg.blockId();
+            range->next_block++;
+            range->received_in_period++;
+            reorder_buffer[num] = pending_block{msg, range->conn};
+
+            if (credit_window > 0 && !range->streaming) {
+                for (const auto& e : msg.ext) {
+                    if (e.key == kSyncCredit) {
+                        range->streaming = true;
+                        break;
+                    }
+                }
+            }
+            if (range->streaming) {
+                range->ungranted_credits++;
+            }
+
+            if (range->next_block > range->end_block) {
+                idle_conns.push_back(range->conn);
+                ranges.erase(range);
+                assign_ranges();
+            } else {
+                grant_credits(*range);
+            }
+            return true;
+        }
+
+        // A buffered block does not link to the synced chain or fails pre_validate: drop what its peer sent
+        // from there on and fetch it again.
+        void reject_blocks(const connection_ptr& con, uint32_t from) {
+            elog("reject block ${n} from ${p}", ("n", from)("p", con->peer_name()));
+            if (con == sync_conn) {
+                sync_conn_failed = true;
+                return;
+            }
+            uint32_t run_start = 0;
+            uint32_t run_end = 0;
+            for (auto it = reorder_buffer.lower_bound(from); it != reorder_buffer.end();) {
+                if (it->second.conn != con) {
+                    ++it;
+                    continue;
+                }
+                if (run_start != 0 && it->first != run_end + 1) {
+                    unassigned_ranges[run_start] = run_end;
+                    run_start = 0;
+                }
+                if (run_start == 0) {
+                    run_start = it->first;
+                }
+                run_end = it->first;
+                it = reorder_buffer.erase(it);
+            }
+            if (run_start != 0) {
+                unassigned_ranges[run_start] = run_end;
+            }
+            auto range = find_range(con);
+            if (range != ranges.end()) {
+                retire(range);
+            } else {
+                idle_conns.erase(std::remove(idle_conns.begin(), idle_conns.end(), con), idle_conns.end());
+            }
+            assign_ranges();
+        }
+
+        void start_validation(const StartPoint& sp) {
+            sync_committees.clear();
+            sync_committees[0] = sp.committeeSet;
+            next_committee_mroot = sp.nextCommitteeMroot;
+            genesis_pk = sp.genesisPk;
+        }
+
+        const CommitteeSet& committee_of(uint32_t block_num) const {
+            static const CommitteeSet empty_committee;
+            auto it = sync_committees.upper_bound(block_num);
+            return it == sync_committees.begin() ? empty_committee : (--it)->second;
+        }
+
+        // Check a block in sync order before it reaches the producer and the light client, so a helper peer
+        // sending forged blocks is retired instead of failing the whole sync in the light client. The proposer
+        // signature and the BLS voter sets of the block are verified against the committee of the synced chain
+        // at that point, a check point has to match the mroot of the last epoch end point. Blocks of sync_conn
+        // are only tracked (verify false): a fault there fails the sync in the light client as before, and
+        // their BLS sets are not verified twice. A proposer missing from the tracked committee is a fault too,
+        // the committee of every synced block is known from the start point and the check points.
+        bool pre_validate(const SyncBlockMsg& msg, bool verify) {
+            uint32_t num = msg.block.block_num();
+            try {
+                std::shared_ptr<CommitteeSet> check_point;
+                if (CheckPoint::isCheckPoint(msg.block)) {
+                    check_point = std::make_shared<CommitteeSet>(CheckPoint(msg.block).committeeSet());
+                }
+                if (verify) {
+                    if (check_point && !next_committee_mroot.empty()
+                        && std::string(check_point->committeeMroot()) != next_committee_mroot) {
+                        elog("sync block ${n} check point mroot ${m} is not ${e}",
+                             ("n", num)("m", std::string(check_point->committeeMroot()))("e", next_committee_mroot));
+                        return false;
+                    }
+                    if (!verify_proposer(msg.block, check_point) || !verify_bls(msg, check_point)) {
+                        return false;
+                    }
+                }
+                if (check_point) {
+                    sync_committees[num] = *check_point;
+                }
+                if (EpochEndPoint::isEpochEndPoint(msg.block)) {
+                    next_committee_mroot = EpochEndPoint(msg.block).nextCommitteeMroot();
+                }
+            } catch (const fc::exception& e) {
+                elog("sync block ${n} header extensions error : ${e}", ("n", num)("e", e.to_string()));
+                return !verify;
+            }
+            return true;
+        }
+
+        bool verify_proposer(const Block& block, const std::shared_ptr<CommitteeSet>& check_point) const {
+            uint32_t num = block.block_num();
+            std::string pk;
+            if (Helper::isGenesis(block)) {
+                // as LightClient::handleGenesis
+                const auto& ro_api = app().get_plugin<chain_plugin>().get_read_only_api();
+                if (num == 1 || !ro_api.is_exec_patch_code(chain::config::patch_update_version::verify_genesis_signature_in_lightclient)) {
+                    return true;
+                }
+                pk = genesis_pk;
+            } else {
+                // the proposer of a check point may be in its committee or still in the one before it
+                if (check_point) {
+                    pk = check_point->getPk(block.proposer);
+                }
+                if (pk.empty()) {
+                    pk = committee_of(num).getPk(block.proposer);
+                }
+                if (pk.empty()) {
+                    pk = committee_of(num - 1).getPk(block.proposer);
+                }
+            }
+            if (pk.empty()) {
+                // with no committee known the light client only takes a check point, so this is a fault as well
+                elog("sync block ${n} proposer ${p} is not in the committee", ("n", num)("p", std::string(block.proposer)));
+                return false;
+            }
+            if (!Validator::verify<BlockHeader>(Signature(block.signature), block, PublicKey(pk))) {
+                elog("sync block ${n} signature error, proposer : ${p}", ("n", num)("p", std::string(block.proposer)));
+                return false;
+            }
+            return true;
+        }
+
+        // the confirm point and the proof of the block, each by the committee of the block it confirms
+        bool verify_bls(const SyncBlockMsg& msg, const std::shared_ptr<CommitteeSet>& check_point) const {
+            std::vector<BlsVoterSet> bls_voter_sets;
+            if (ConfirmPoint::isConfirmPoint(msg.block)) {
+                bls_voter_sets.push_back(ConfirmPoint(msg.block).blsVoterSet());
+            }
+            BlsVoterSet proof(msg.proof);
+            if (proof.valid() && proof.commonEchoMsg.blockId == msg.blockId()) {
+                bls_voter_sets.push_back(proof);
+            }
+            uint32_t num = msg.block.block_num();
+            for (const auto& v : bls_voter_sets) {
+                if (!v.valid()) {
+                    continue;
+                }
+                uint32_t confirmed = BlockHeader::num_from_id(v.commonEchoMsg.blockId);
+                const CommitteeSet& committee = (check_point && confirmed == num) ? *check_point : committee_of(confirmed);
+                if (!committee.empty() && !committee.verify(v)) {
+                    elog("sync block ${n} bls error, confirmed num : ${c}", ("n", num)("c", confirmed));
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Called every conn check period, returns false if the sync made no progress.
+        bool check_ranges() {
+            if (sync_conn_failed) {
+                return false;
+            }
+            bool progress = last_received_block > last_checked_block;
+            bool window_full = !unassigned_ranges.empty() && !idle_conns.empty()
+                               && unassigned_ranges.begin()->first != next_block_num
+                               && unassigned_ranges.begin()->second >= first_buffered_block() + max_pending_blocks;
+            for (auto it = ranges.begin(); it != ranges.end();) {
+                bool blocking = window_full && it->start_block <= next_block_num && next_block_num <= it->end_block
+                                && it->received_in_period < fetch_span;
+                if (it->received_in_period > 0) {
+                    progress = true;
+                }
+                if (it->conn != sync_conn && (it->received_in_period == 0 || blocking)) {
+                    it = retire(it);
+                } else {
+                    it->received_in_period = 0;
+                    ++it;
+                }
+            }
+            assign_ranges();
+            return progress;
+        }
+
         void handle_block() {
             if (block_msg_queue.empty()) {
                 return;
@@ -628,6 +1057,26 @@ namespace ultrainio { namespace net_plugin_n {
                     break;
                 }
             }
+            for (auto& r : ranges) {
+                grant_credits(r);
+            }
+            assign_ranges();
+        }
+
+        // Return the credits of the received blocks to a streaming source, held back while too many
+        // blocks wait for confirmation so the buffers stay bounded.
+        void grant_credits(sync_range& range) {
+            if (!range.streaming || range.ungranted_credits < std::max(credit_window / 2, 1u)
+                || buffered_blocks() >= max_pending_blocks) {
+                return;
+            }
+            ultrainio::ReqSyncMsg grant;
+            grant.seqNum = seq_num;
+            grant.startBlockNum = range.next_block;
+            grant.endBlockNum = range.end_block;
+            grant.ext.push_back({kSyncCreditGrant, std::to_string(range.ungranted_credits)});
+            range.conn->enqueue(grant);
+            range.ungranted_credits = 0;
         }
 
         void confirm_safe_blocks(const std::list<BlockHeader>& safe_blocks) {
@@ -927,6 +1376,11 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
                 }
 
                 conn->do_queue_write();
+                if (conn->sync_write_blocked && conn->write_queue.size() <= connection::SYNC_WRITE_LOW_WATER) {
+                    // resume the sync stream now rather than on the next credit grant or sync task timer
+                    conn->sync_write_blocked = false;
+                    app().get_plugin<producer_rpos_plugin>().sync_writable(conn->node_id);
+                }
             }
             catch(const std::exception &ex) {
                 auto conn = c.lock();
@@ -963,9 +1417,12 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
         ds.write( header, header_size );
         fc::raw::pack( ds, m );
         connection_wptr weak_this = shared_from_this();
+        LatencyHistogram& queue_latency = net_latency::instance().send_queue(m.which());
+        auto enqueue_time = std::chrono::steady_clock::now();
 
         queue_write(send_buffer,trigger_send,
-                    [weak_this, close_after_send](boost::system::error_code ec, std::size_t ) {
+                    [weak_this, close_after_send, &queue_latency, enqueue_time](boost::system::error_code ec, std::size_t ) {
+                        queue_latency.record(elapsedUs(enqueue_time));
                         connection_ptr conn = weak_this.lock();
                         if (conn) {
                             if (close_after_send != no_reason) {
@@ -1059,11 +1516,16 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
             net_message msg;
             fc::raw::unpack(ds, msg);
             ticker_rcv = true;
-            bool isexceed = check_pkt_limit_exceed();
+            // sync blocks from a peer holding a sync range are paced by the credits this node grants,
+            // everything else, unsolicited sync blocks included, stays under the packet limit
+            bool paced = which == uint64_t(net_message::tag<SyncBlockMsg>::value)
+                         && impl.sync_block_master->find_range(shared_from_this()) != impl.sync_block_master->ranges.end();
+            bool isexceed = !paced && check_pkt_limit_exceed();
             if(isexceed)
             {
                 return true;
             }
+            ScopedLatency latency(net_latency::instance().handle(msg.which()));
             msgHandler m(impl, shared_from_this() );
             msg.visit(m);
         } catch(  const fc::exception& e ) {
@@ -1536,6 +1998,35 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
         }
     }
 
+    bool net_plugin_impl::send_block(const fc::sha256& node_id, uint32_t seq_num, const std::vector<char>& packed_block, const std::string& proof) {
+        for (auto &c : connections) {
+            if (c->priority == msg_priority_trx && c->current() && c->node_id == node_id) {
+                if (c->write_queue.size() >= connection::MAX_SYNC_WRITE_QUEUE) {
+                    c->sync_write_blocked = true;
+                    return false;
+                }
+                // a SyncBlockMsg frame around the block bytes as stored, marked as sent under credits
+                MsgExtension ext{{kSyncCredit, std::string()}};
+                fc::unsigned_int which(net_message::tag<SyncBlockMsg>::value);
+                uint32_t payload_size = fc::raw::pack_size(which) + sizeof(seq_num) + packed_block.size()
+                        + fc::raw::pack_size(proof) + fc::raw::pack_size(ext);
+                size_t buffer_size = sizeof(payload_size) + payload_size;
+
+                auto send_buffer = std::make_shared<vector<char>>(buffer_size);
+                fc::datastream<char*> ds(send_buffer->data(), buffer_size);
+                ds.write(reinterpret_cast<char*>(&payload_size), sizeof(payload_size));
+                fc::raw::pack(ds, which);
+                fc::raw::pack(ds, seq_num);
+                ds.write(packed_block.data(), packed_block.size());
+                fc::raw::pack(ds, proof);
+                fc::raw::pack(ds, ext);
+                c->queue_write(send_buffer, true, [](boost::system::error_code, std::size_t) {});
+                return true;
+            }
+        }
+        return false;
+    }
+
     void net_plugin_impl::send_block_num_range(const fc::sha256& node_id, const net_message& msg) {
         for (auto &c : connections) {
             if (c->priority == msg_priority_trx && c->current()) {
@@ -1549,11 +2040,7 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
     }
 
     void net_plugin_impl::stop_sync_block() {
-        if (sync_block_master->sync_conn) {
-            SyncStopMsg stop_msg;
-            stop_msg.seqNum = sync_block_master->seq_num;
-            sync_block_master->sync_conn->enqueue(stop_msg);
-        }
+        sync_block_master->stop_ranges();
         sync_block_master->reset();
     }
 
@@ -2106,7 +2593,7 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
 
    void net_plugin_impl::handle_message( connection_ptr c, const ProposeMsg& msg) {
        ilog("propose from ${p} block id: ${id} block num: ${num}",
-            ("p", c->peer_name())("id", short_hash(msg.block.id()))("num", msg.block.block_num()));
+            ("p", c->peer_name())("id", short_hash(msg.blockId()))("num", msg.block.block_num()));
        if (app().get_plugin<producer_rpos_plugin>().handle_message(msg)) {
            for (auto &conn : connections) {
                if (conn != c && conn->priority == msg_priority_rpos) {
@@ -2157,7 +2644,8 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
         ilog("receive block msg!!! message from ${p} blockNum = ${blockNum} end block num:${eb}",
              ("p", c->peer_name())("blockNum", msg.block.block_num())("eb", sync_block_master->end_block_num));
 
-        if (c != sync_block_master->sync_conn || msg.seqNum != sync_block_master->seq_num) {
+        auto range = sync_block_master->find_range(c);
+        if (range == sync_block_master->ranges.end() || msg.seqNum != sync_block_master->seq_num) {
             wlog("receive old block msg!!! Discard. seq num in msg: ${snm}, seq num in master: ${sns}", ("snm", msg.seqNum)("sns", sync_block_master->seq_num));
             SyncStopMsg stop_msg;
             stop_msg.seqNum = msg.seqNum;
@@ -2165,15 +2653,22 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
             return;
         }
 
-        if (sync_block_master->end_block_num > 0) {
-            if (sync_block_master->last_received_block == 0 || sync_block_master->last_received_block + 1 == msg.block.block_num()) {
-                sync_block_master->last_received_block++;
-            } else {
-                elog("receive block with wrong number: ${num}, but last received block num: ${last}", ("num", msg.block.block_num())("last", sync_block_master->last_received_block));
+        if (sync_block_master->end_block_num > 0 && sync_block_master->receive_block(range, msg)) {
+            drain_sync_blocks();
+        }
+    }
+
+    void net_plugin_impl::drain_sync_blocks() {
+        auto& sbm = *sync_block_master;
+        for (auto it = sbm.reorder_buffer.begin(); it != sbm.reorder_buffer.end() && it->first == sbm.next_block_num;
+             it = sbm.reorder_buffer.begin()) {
+            const SyncBlockMsg& msg = it->second.msg;
+            if (sbm.last_block_id != BlockIdType() && msg.block.previous != sbm.last_block_id) {
+                sbm.reject_blocks(it->second.conn, it->first);
+                return;
             }
 
-            sync_block_master->last_received_block = msg.block.block_num();
-            if (sync_block_master->last_received_block == sync_block_master->sync_block_msg.startBlockNum) {
+            if (it->first == sbm.sync_block_msg.startBlockNum) {
                 controller &cc = chain_plug->chain();
                 std::shared_ptr<StakeVoteBase> stake = MsgMgr::getInstance()->getStakeVote(cc.head_block_num() + 1);
                 StartPoint sp(stake->getCommitteeSet(), cc.head_block_id());
@@ -2183,10 +2678,20 @@ connection::connection(string endpoint, msg_priority pri, connection_direction d
                 }
                 sp.genesisPk = Genesis::s_genesisPk;
                 light_client->setStartPoint(sp);
+                sbm.start_validation(sp);
             }
-            sync_block_master->block_msg_queue.emplace_back(msg);
+            if (!sbm.pre_validate(msg, it->second.conn != sbm.sync_conn)) {
+                sbm.reject_blocks(it->second.conn, it->first);
+                return;
+            }
+
+            sbm.last_received_block = it->first;
+            sbm.last_block_id = msg.blockId();
+            sbm.next_block_num++;
+            sbm.block_msg_queue.emplace_back(msg);
             BlsVoterSet blsVoterSet(msg.proof);
             light_client->accept(msg.block, msg.block.signature, blsVoterSet);
+            sbm.reorder_buffer.erase(it);
         }
     }
 
@@ -2886,6 +3391,8 @@ bool net_plugin_impl::authenticate_peer(const handshake_message& msg) {
          ( "network-version-match", bpo::value<bool>()->default_value(false),
            "True to require exact match of peer network version.")
          ( "sync-fetch-span", bpo::value<uint32_t>()->default_value(def_sync_fetch_span), "number of blocks to retrieve in a chunk from any individual peer during synchronization")
+         ( "sync-max-peers", bpo::value<uint32_t>()->default_value(def_sync_max_peers), "maximum number of peers blocks are fetched from at once during synchronization, 1 to sync from the longest peer only")
+         ( "sync-credit-window", bpo::value<uint32_t>()->default_value(def_sync_credit_window), "number of blocks a sync source may stream ahead of this node, 0 to fall back to the timer paced sync")
          ( "max-implicit-request", bpo::value<uint32_t>()->default_value(def_max_just_send), "maximum sizes of transaction or block messages that are sent without first sending a notice")
          ( "use-socket-read-watermark", bpo::value<bool>()->default_value(false), "Enable expirimental socket read watermark optimization")
          ( "peer-log-format", bpo::value<string>()->default_value( "[\"${_name}\" ${_ip}:${_port}]" ),
@@ -2920,6 +3427,9 @@ bool net_plugin_impl::authenticate_peer(const handshake_message& msg) {
          my->max_waitblock_seconds = options.at( "max-waitblock-seconds" ).as<int>();
          my->dispatcher.reset( new dispatch_manager );
          my->sync_block_master.reset( new sync_block_manager(my->max_waitblocknum_seconds, my->max_waitblock_seconds) );
+         my->sync_block_master->credit_window = options.at( "sync-credit-window" ).as<uint32_t>();
+         my->sync_block_master->fetch_span = options.at( "sync-fetch-span" ).as<uint32_t>();
+         my->sync_block_master->max_sync_peers = options.at( "sync-max-peers" ).as<uint32_t>();
          my->light_client = LightClientMgr::getInstance()->getLightClient(0);
          my->light_client->addCallback(std::make_shared<CheckBlockCallback>(*my->sync_block_master));
 
@@ -3190,7 +3700,7 @@ bool net_plugin_impl::authenticate_peer(const handshake_message& msg) {
     }
 
    void net_plugin::broadcast(const ProposeMsg& propose) {
-      ilog("broadcast propose msg. blockHash : ${blockHash}", ("blockHash", short_hash(propose.block.id())));
+      ilog("broadcast propose msg. blockHash : ${blockHash}", ("blockHash", short_hash(propose.blockId())));
       my->start_broadcast(net_message(propose), msg_priority_rpos);
    }
 
@@ -3208,6 +3718,10 @@ bool net_plugin_impl::authenticate_peer(const handshake_message& msg) {
        my->send_block(node_id, net_message(msg));
    }
 
+   bool net_plugin::send_block(const fc::sha256& node_id, uint32_t seq_num, const std::vector<char>& packed_block, const std::string& proof) {
+       return my->send_block(node_id, seq_num, packed_block, proof);
+   }
+
    bool net_plugin::send_req_sync(const ultrainio::ReqSyncMsg& msg) {
        ilog("send req sync msg");
        return my->send_req_sync(msg);
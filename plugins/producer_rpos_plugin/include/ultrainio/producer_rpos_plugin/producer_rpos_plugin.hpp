@@ -47,6 +47,7 @@ public:
    bool handle_message(const fc::sha256& node_id, const SyncStopMsg& msg);
    bool sync_fail(const ultrainio::ReqSyncMsg& sync_msg);
    bool sync_cancel();
+   void sync_writable(const fc::sha256& node_id);
    int  get_round_interval();
    string get_account_sk();
    string get_account_name();
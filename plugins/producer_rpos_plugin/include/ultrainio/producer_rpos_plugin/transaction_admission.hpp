@@ -0,0 +1,105 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#pragma once
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include <ultrainio/chain/transaction_metadata.hpp>
+
+namespace ultrainio {
+
+   /**
+    * Stateless admission of transactions received by a producer, done on a pool of worker threads.
+    *
+    * A worker unpacks the transaction (and decompresses it), computes its id and signed id, checks
+    * its size and expiration, drops it if the same signed id was admitted before and recovers the
+    * signing keys. The results are handed back to the main io_service in batches, where the checks
+    * that read chain state (TaPoS, known transactions) and the push into the pending pool are done.
+    *
+    * With 0 threads every transaction is admitted inline on the calling thread.
+    */
+   class transaction_admission {
+      public:
+         struct limits {
+            fc::time_point head_block_time;
+            uint32_t       max_transaction_lifetime = 0;
+            uint32_t       max_transaction_net_usage = 0;
+         };
+
+         struct result {
+            chain::packed_transaction_ptr   packed;
+            /// null if the transaction can not be unpacked
+            chain::transaction_metadata_ptr trx;
+            /// null if the transaction passed the stateless checks
+            fc::exception_ptr               error;
+         };
+
+         using batch_callback = std::function<void(std::vector<result>&)>;
+
+         transaction_admission( boost::asio::io_service& main_ios, const chain::chain_id_type& chain_id,
+                                uint32_t threads, batch_callback on_batch );
+         ~transaction_admission();
+
+         void start();
+         void stop();
+
+         /// called from the main thread, the limits apply to transactions submitted afterwards
+         void update_limits( const limits& l );
+
+         void submit( const chain::packed_transaction_ptr& trx );
+
+         /// a transaction rejected after admission, or dropped by the pending pool, may be admitted again later
+         void forget( const chain::digest_type& signed_id );
+
+         uint32_t threads()const { return _threads; }
+
+      private:
+         static constexpr size_t filter_shard_count = 16;
+         /// expired ids are pruned from a shard once it is larger than this
+         static constexpr size_t filter_shard_prune_size = 4096;
+
+         struct filter_shard {
+            std::mutex                                                     mutex;
+            std::unordered_map<chain::digest_type, fc::time_point_sec>     ids;
+            /// twice the ids left by the last prune, so every prune scan is paid for by as many inserts
+            size_t                                                         prune_size = filter_shard_prune_size;
+         };
+
+         result admit( const chain::packed_transaction_ptr& trx );
+
+         /// false if signed_id is already admitted
+         bool insert_filter( const chain::digest_type& signed_id, const fc::time_point_sec& expiration,
+                             const fc::time_point& now );
+
+         void deliver( result&& r );
+
+         void drain();
+
+         boost::asio::io_service&                            _main_ios;
+         chain::chain_id_type                                _chain_id;
+         uint32_t                                            _threads;
+         batch_callback                                      _on_batch;
+
+         boost::asio::io_service                             _ios;
+         std::unique_ptr<boost::asio::io_service::work>      _work;
+         std::vector<std::thread>                            _workers;
+
+         std::mutex                                          _limits_mutex;
+         limits                                              _limits;
+
+         std::array<filter_shard, filter_shard_count>        _filter;
+
+         std::mutex                                          _ready_mutex;
+         std::vector<result>                                 _ready;
+   };
+
+} /// ultrainio
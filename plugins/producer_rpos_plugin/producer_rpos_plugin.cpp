@@ -3,6 +3,7 @@
  *  @copyright defined in ultrain/LICENSE.txt
  */
 #include <ultrainio/producer_rpos_plugin/producer_rpos_plugin.hpp>
+#include <ultrainio/producer_rpos_plugin/transaction_admission.hpp>
 #include <ultrainio/chain/producer_object.hpp>
 #include <ultrainio/chain/plugin_interface.hpp>
 #include <ultrainio/chain/global_property_object.hpp>
@@ -129,6 +130,8 @@ class producer_rpos_plugin_impl : public std::enable_shared_from_this<producer_r
       int32_t  _max_round_seconds                  = Config::s_maxRoundSeconds;
       int32_t  _max_phase_seconds                  = Config::s_maxPhaseSeconds;
       int32_t  _max_trxs_seconds                   = Config::s_maxTrxMicroSeconds;
+      uint32_t _admission_threads                  = 2;
+      std::unique_ptr<transaction_admission>       _admission;
       using signature_provider_type = std::function<chain::signature_type(chain::digest_type)>;
       std::map<chain::public_key_type, signature_provider_type> _signature_providers;
       std::set<chain::account_name>                             _producers;
@@ -222,6 +225,53 @@ class producer_rpos_plugin_impl : public std::enable_shared_from_this<producer_r
 
       std::vector<std::tuple<packed_transaction_ptr, bool, next_function<transaction_trace_ptr>>> _pending_incoming_transactions;
 
+      void publish_transaction_ack(const fc::exception_ptr& e, const packed_transaction_ptr& trx) {
+          _transaction_ack_channel.publish(std::tuple<const fc::exception_ptr, const transaction_trace_ptr, const packed_transaction_ptr>(e, nullptr, trx));
+      }
+
+      // main thread part of the admission, the checks reading chain state and the push into the pending pool
+      void on_admitted_transactions(std::vector<transaction_admission::result>& batch) {
+          chain::controller& chain = app().get_plugin<chain_plugin>().chain();
+          for (auto& r : batch) {
+              if (r.error) {
+                  dlog("on_incoming_transaction_async drop trx ${id}: ${e}",
+                       ("id", r.trx ? r.trx->id : transaction_id_type())("e", r.error->to_string()));
+                  publish_transaction_ack(r.error, r.packed);
+                  continue;
+              }
+              const transaction_metadata_ptr& trx_ptr = r.trx;
+              if (chain.is_known_unexpired_transaction(trx_ptr->id)) {
+                  ilog("on_incoming_transaction_async cache trx.id = ${id}, but known so drop", ("id", trx_ptr->id));
+                  publish_transaction_ack(std::make_shared<tx_duplicate>(
+                      FC_LOG_MESSAGE(error, "duplicate transaction ${id}", ("id", trx_ptr->id))), r.packed);
+                  continue;
+              }
+              try {
+                  chain.validate_tapos(trx_ptr->trx);
+              } catch (const fc::exception& e) {
+                  ilog("on_incoming_transaction_async cache trx.id = ${id}, but bad TaPoS so drop", ("id", trx_ptr->id));
+                  _admission->forget(trx_ptr->signed_id);
+                  publish_transaction_ack(e.dynamic_copy_exception(), r.packed);
+                  continue;
+              }
+
+              auto ret = chain.push_into_pending_transaction(trx_ptr);
+              if (ret == pending_transaction_pool::push_result::accepted) {
+                  publish_transaction_ack(nullptr, r.packed);
+              } else if (ret == pending_transaction_pool::push_result::duplicate) {
+                  publish_transaction_ack(std::make_shared<tx_duplicate>(
+                      FC_LOG_MESSAGE(error, "duplicate transaction ${id}", ("id", trx_ptr->id))), r.packed);
+              } else {
+                  // may be sent again once the pool has room
+                  _admission->forget(trx_ptr->signed_id);
+                  publish_transaction_ack(std::make_shared<too_many_tx_at_once>(
+                      FC_LOG_MESSAGE(error, "pending pool full ${f} or account ${a} over quota, transaction ${id}",
+                                     ("f", ret == pending_transaction_pool::push_result::pool_full)
+                                     ("a", trx_ptr->trx.first_authorizor())("id", trx_ptr->id))), r.packed);
+              }
+          }
+      }
+
       void on_incoming_transaction_async(const packed_transaction_ptr& trx, bool from_network, bool persist_until_expired, next_function<transaction_trace_ptr> next) {
           // We do pre-run here only for returning results asap to the transaction caller.
           #define MAKE_TRANSACTION_ACK_TUPLE std::tuple<const fc::exception_ptr, const transaction_trace_ptr, const packed_transaction_ptr>
@@ -248,34 +298,15 @@ class producer_rpos_plugin_impl : public std::enable_shared_from_this<producer_r
                   return;
               }
 
-              transaction_metadata_ptr trx_ptr = std::make_shared<transaction_metadata>(*trx);
-              auto block_time = chain.head_block_state()->header.timestamp.to_time_point();
-
-              if( fc::time_point(trx_ptr->trx.expiration) < block_time ) {
-                  ilog("on_incoming_transaction_async cache trx.id = ${id}, but expired so drop", ("id", trx_ptr->id));
-                  auto e = std::make_shared<expired_tx_exception>(FC_LOG_MESSAGE(error, "expired transaction ${id}", ("id", trx_ptr->id)));
-                  _transaction_ack_channel.publish(MAKE_TRANSACTION_ACK_TUPLE(e, nullptr, trx));
-                  return;
-              }
-
-              if (chain.is_known_unexpired_transaction(trx_ptr->id)) {
-                  ilog("on_incoming_transaction_async cache trx.id = ${id}, but known so drop", ("id", trx_ptr->id));
-                  auto e = std::make_shared<tx_duplicate>(FC_LOG_MESSAGE(error, "duplicate transaction ${id}", ("id", trx_ptr->id)));
-                  _transaction_ack_channel.publish(MAKE_TRANSACTION_ACK_TUPLE(e, nullptr, trx));
-                  return;
-              }
-
-              std::pair<bool, bool> ret = chain.push_into_pending_transaction(trx_ptr);
-              //         ilog("on_incoming_transaction_async cache trx.id = ${id}, overflow ${o}, duplicate ${d}",
-              //              ("id", trx->id())("o", ret.first)("d", ret.second));;
-              if (!ret.first && !ret.second) {
-                  _transaction_ack_channel.publish(MAKE_TRANSACTION_ACK_TUPLE(nullptr, nullptr, trx));
-              } else {
-                  auto e = std::make_shared<tx_duplicate>(
-                      FC_LOG_MESSAGE(error, "overflow ${o} or duplicate ${d} transaction ${id}",
-                                     ("o", ret.first)("d", ret.second)("id", trx_ptr->id)));
-                  _transaction_ack_channel.publish(MAKE_TRANSACTION_ACK_TUPLE(e, nullptr, trx));
-              }
+              // unpack, dedup, expiration and signatures are checked on the admission threads,
+              // the rest is done in on_admitted_transactions
+              const auto& cfg = chain.get_global_properties().configuration;
+              transaction_admission::limits limits;
+              limits.head_block_time = chain.head_block_state()->header.timestamp.to_time_point();
+              limits.max_transaction_lifetime = cfg.max_transaction_lifetime;
+              limits.max_transaction_net_usage = cfg.max_transaction_net_usage;
+              _admission->update_limits(limits);
+              _admission->submit(trx);
 
               if (time_delta > fc::seconds(report_period) || incoming_trx_count > report_trx_count_thresh) {
                   ilog("on_incoming_transaction_async cache ${count} trxs in last ${delta} seconds",
@@ -439,6 +470,7 @@ void producer_rpos_plugin::set_program_options(
          ("worldstates-dir", bpo::value<bfs::path>()->default_value("worldstate"),"the location of the worldstates directory (absolute path or relative to application data dir)")
          ("max-trxs-microseconds", bpo::value<int32_t>()->default_value(Config::s_maxTrxMicroSeconds), "max trxs microseconds in initpropose,set by test mode usually")
          ("allow-report-evil", bpo::value<bool>()->default_value(false), "whether report evil evidence")
+         ("txn-admission-threads", bpo::value<uint32_t>()->default_value(2), "threads unpacking and checking incoming transactions on a producer, 0 to do it on the main thread")
          ;
    config_file_options.add(producer_options);
 }
@@ -563,6 +595,7 @@ void producer_rpos_plugin::plugin_initialize(const boost::program_options::varia
    my->_allow_report_evil = options.at("allow-report-evil").as<bool>();
    my->_max_trxs_seconds = options.at("max-trxs-microseconds").as<int32_t>();
    my->_is_config_encrypt = options.at("encrypt-config").as<bool>();
+   my->_admission_threads = options.at("txn-admission-threads").as<uint32_t>();
    ultrainio::chain::config::block_interval_ms = my->_max_round_seconds * 1000;
    ultrainio::chain::config::block_interval_us =  my->_max_round_seconds * 1000000;
    if(options.count("genesis-time"))
@@ -648,6 +681,10 @@ bool producer_rpos_plugin::sync_cancel() {
   return Node::getInstance()->syncCancel();
 }
 
+void producer_rpos_plugin::sync_writable(const fc::sha256& node_id) {
+  Node::getInstance()->syncWritable(node_id);
+}
+
 void producer_rpos_plugin::plugin_startup()
 { try {
    if(fc::get_logger_map().find(logger_name) != fc::get_logger_map().end()) {
@@ -656,6 +693,19 @@ void producer_rpos_plugin::plugin_startup()
 
    ilog("producer plugin:  plugin_startup() begin");
 
+   my->_admission.reset(new transaction_admission(app().get_io_service(),
+                                                  app().get_plugin<chain_plugin>().chain().get_chain_id(),
+                                                  my->_admission_threads,
+                                                  [this](std::vector<transaction_admission::result>& batch) {
+                                                      my->on_admitted_transactions(batch);
+                                                  }));
+   my->_admission->start();
+   // a transaction the pending pool drops unapplied may be sent again
+   app().get_plugin<chain_plugin>().chain().get_pending_transactions().set_drop_handler(
+      [this](const transaction_metadata_ptr& trx) {
+         my->_admission->forget(trx->signed_id);
+      });
+
    std::shared_ptr<Node> nodePtr = Node::initAndGetInstance(app().get_io_service());
    // set before committee key
    nodePtr->setNonProducingNode(my->_is_non_producing_node);
@@ -696,6 +746,10 @@ void producer_rpos_plugin::plugin_startup()
 } FC_CAPTURE_AND_RETHROW() }
 
 void producer_rpos_plugin::plugin_shutdown() {
+   if (my->_admission) {
+      app().get_plugin<chain_plugin>().chain().get_pending_transactions().set_drop_handler(nullptr);
+      my->_admission->stop();
+   }
    my->_accepted_block_connection.reset();
    my->_irreversible_block_connection.reset();
 }
@@ -0,0 +1,149 @@
+/**
+ *  @file
+ *  @copyright defined in ultrain/LICENSE.txt
+ */
+#include <ultrainio/producer_rpos_plugin/transaction_admission.hpp>
+
+#include <ultrainio/chain/exceptions.hpp>
+
+namespace ultrainio {
+
+   using namespace ultrainio::chain;
+
+   transaction_admission::transaction_admission( boost::asio::io_service& main_ios, const chain_id_type& chain_id,
+                                                 uint32_t threads, batch_callback on_batch )
+   :_main_ios( main_ios )
+   ,_chain_id( chain_id )
+   ,_threads( threads )
+   ,_on_batch( std::move(on_batch) )
+   {}
+
+   transaction_admission::~transaction_admission() {
+      stop();
+   }
+
+   void transaction_admission::start() {
+      if( _threads == 0 || !_workers.empty() ) {
+         return;
+      }
+      _work.reset( new boost::asio::io_service::work( _ios ) );
+      for( uint32_t i = 0; i < _threads; ++i ) {
+         _workers.emplace_back( [this]() { _ios.run(); } );
+      }
+   }
+
+   void transaction_admission::stop() {
+      if( _workers.empty() ) {
+         return;
+      }
+      _work.reset();
+      _ios.stop();
+      for( auto& t : _workers ) {
+         t.join();
+      }
+      _workers.clear();
+   }
+
+   void transaction_admission::update_limits( const limits& l ) {
+      std::lock_guard<std::mutex> g( _limits_mutex );
+      _limits = l;
+   }
+
+   void transaction_admission::submit( const packed_transaction_ptr& trx ) {
+      if( _workers.empty() ) {
+         std::vector<result> batch;
+         batch.emplace_back( admit( trx ) );
+         _on_batch( batch );
+         return;
+      }
+      _ios.post( [this, trx]() {
+         deliver( admit( trx ) );
+      } );
+   }
+
+   void transaction_admission::forget( const digest_type& signed_id ) {
+      filter_shard& s = _filter[signed_id._hash[1] % filter_shard_count];
+      std::lock_guard<std::mutex> g( s.mutex );
+      s.ids.erase( signed_id );
+   }
+
+   transaction_admission::result transaction_admission::admit( const packed_transaction_ptr& trx ) {
+      result r;
+      r.packed = trx;
+      limits l;
+      {
+         std::lock_guard<std::mutex> g( _limits_mutex );
+         l = _limits;
+      }
+      bool filtered = false;
+      try {
+         uint32_t size = trx->get_unprunable_size() + trx->get_prunable_size();
+         ULTRAIN_ASSERT( size <= l.max_transaction_net_usage, tx_too_big,
+                         "transaction is ${s} bytes, max ${m}", ("s", size)("m", l.max_transaction_net_usage) );
+         // unpacks and decompresses the transaction, then hashes it for id and signed_id
+         r.trx = std::make_shared<transaction_metadata>( *trx );
+         ULTRAIN_ASSERT( fc::time_point(r.trx->trx.expiration) >= l.head_block_time, expired_tx_exception,
+                         "expired transaction ${id}", ("id", r.trx->id) );
+         ULTRAIN_ASSERT( fc::time_point(r.trx->trx.expiration) <= l.head_block_time + fc::seconds(l.max_transaction_lifetime),
+                         tx_exp_too_far_exception, "transaction expiration ${e} is too far in the future",
+                         ("e", r.trx->trx.expiration) );
+         ULTRAIN_ASSERT( insert_filter( r.trx->signed_id, r.trx->trx.expiration, l.head_block_time ), tx_duplicate,
+                         "duplicate transaction ${id}", ("id", r.trx->id) );
+         filtered = true;
+         // the keys stay in the metadata, push_transaction does not recover them again
+         r.trx->recover_keys( _chain_id );
+      } catch( const fc::exception& e ) {
+         r.error = e.dynamic_copy_exception();
+      } catch( const std::exception& e ) {
+         r.error = fc::exception( FC_LOG_MESSAGE( info, "Caught std::exception: ${what}", ("what", e.what()) ),
+                                  fc::std_exception_code, BOOST_CORE_TYPEID(e).name(), e.what() ).dynamic_copy_exception();
+      }
+      // a transaction whose keys can not be recovered was not admitted
+      if( r.error && filtered ) {
+         forget( r.trx->signed_id );
+      }
+      return r;
+   }
+
+   bool transaction_admission::insert_filter( const digest_type& signed_id, const fc::time_point_sec& expiration,
+                                              const fc::time_point& now ) {
+      filter_shard& s = _filter[signed_id._hash[1] % filter_shard_count];
+      std::lock_guard<std::mutex> g( s.mutex );
+      if( s.ids.size() >= s.prune_size ) {
+         for( auto itr = s.ids.begin(); itr != s.ids.end(); ) {
+            if( fc::time_point(itr->second) < now ) {
+               itr = s.ids.erase( itr );
+            } else {
+               ++itr;
+            }
+         }
+         s.prune_size = std::max( filter_shard_prune_size, 2 * s.ids.size() );
+      }
+      return s.ids.emplace( signed_id, expiration ).second;
+   }
+
+   void transaction_admission::deliver( result&& r ) {
+      bool first = false;
+      {
+         std::lock_guard<std::mutex> g( _ready_mutex );
+         first = _ready.empty();
+         _ready.emplace_back( std::move(r) );
+      }
+      // one drain per batch, results arriving before it runs join the same batch
+      if( first ) {
+         _main_ios.post( [this]() { drain(); } );
+      }
+   }
+
+   void transaction_admission::drain() {
+      std::vector<result> batch;
+      {
+         std::lock_guard<std::mutex> g( _ready_mutex );
+         batch.swap( _ready );
+      }
+      if( !batch.empty() ) {
+         _on_batch( batch );
+      }
+   }
+
+} /// ultrainio
@@ -11,6 +11,60 @@ namespace ultrainio {
 
 using namespace appbase;
 
+struct open_loop_account {
+   chain::account_name account;
+   std::string          private_key;
+};
+
+/**
+ * Parameters of an open loop run: target_tps * duration_sec transactions are signed up front by
+ * signer_threads threads and then submitted on a fixed schedule, whether or not the node keeps up.
+ */
+struct open_loop_params {
+   std::string                    salt;
+   uint32_t                       target_tps = 1000;
+   uint32_t                       duration_sec = 60;
+   uint32_t                       signer_threads = 4;
+   /// the schedule is checked every tick_ms, all transactions due by then are submitted
+   uint32_t                       tick_ms = 10;
+   /// token transfers go from each account to the next one, user.111 and user.112 if empty
+   std::vector<open_loop_account> accounts;
+   chain::account_name            token_contract = chain::account_name("utrio.token");
+   std::string                    quantity = "0.0001 UGAS";
+   /// relative weights of token transfers and hello::hi calls
+   uint32_t                       transfer_weight = 1;
+   uint32_t                       hello_weight = 0;
+};
+
+/// latencies are measured from the scheduled submit time, so a generator falling behind is not hidden
+struct open_loop_latency {
+   uint64_t count = 0;
+   uint64_t avg_us = 0;
+   uint64_t p50_us = 0;
+   uint64_t p90_us = 0;
+   uint64_t p99_us = 0;
+   uint64_t p999_us = 0;
+   uint64_t max_us = 0;
+};
+
+struct open_loop_report {
+   std::string       state;
+   uint32_t          target_tps = 0;
+   uint64_t          pool_size = 0;
+   uint64_t          sign_ms = 0;
+   uint64_t          sent = 0;
+   uint64_t          admitted = 0;
+   uint64_t          rejected = 0;
+   uint64_t          included = 0;
+   uint64_t          irreversible = 0;
+   double            sent_tps = 0;
+   /// how far the submission fell behind the schedule at worst
+   uint64_t          max_send_lag_us = 0;
+   open_loop_latency admit_latency;
+   open_loop_latency include_latency;
+   open_loop_latency irreversible_latency;
+};
+
 class txn_test_gen_plugin : public appbase::plugin<txn_test_gen_plugin> {
 public:
    txn_test_gen_plugin();
@@ -28,3 +82,10 @@ private:
 };
 
 }
+
+FC_REFLECT( ultrainio::open_loop_account, (account)(private_key) )
+FC_REFLECT( ultrainio::open_loop_params, (salt)(target_tps)(duration_sec)(signer_threads)(tick_ms)(accounts)
+            (token_contract)(quantity)(transfer_weight)(hello_weight) )
+FC_REFLECT( ultrainio::open_loop_latency, (count)(avg_us)(p50_us)(p90_us)(p99_us)(p999_us)(max_us) )
+FC_REFLECT( ultrainio::open_loop_report, (state)(target_tps)(pool_size)(sign_ms)(sent)(admitted)(rejected)(included)
+            (irreversible)(sent_tps)(max_send_lag_us)(admit_latency)(include_latency)(irreversible_latency) )
@@ -6,6 +6,9 @@
 #include <ultrainio/chain_plugin/chain_plugin.hpp>
 #include <ultrainio/chain/wast_to_wasm.hpp>
 #include <ultrainio/utilities/key_conversion.hpp>
+#include <ultrainio/chain/plugin_interface.hpp>
+#include <ultrainio/chain/global_property_object.hpp>
+#include <base/LatencyHistogram.h>
 
 #include <fc/variant.hpp>
 #include <fc/io/json.hpp>
@@ -15,6 +18,12 @@
 
 #include <boost/asio/high_resolution_timer.hpp>
 #include <boost/algorithm/clamp.hpp>
+#include <boost/signals2/connection.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include <Inline/BasicTypes.h>
 #include <IR/Module.h>
@@ -42,6 +51,160 @@ static fc::microseconds abi_serializer_max_time;
 
 using namespace ultrainio::chain;
 
+static const char* const user_111_priv_key = "5JbXkT2DP8HpwfaCRmSa3Qw2vH1pqnxfKGk5w8riUJUSVx7j1ir";
+static const char* const user_112_priv_key = "5J4fz4cApTLTZzqjKsFSdCYPUyDNcmSD2WsLRoPbGjSB8KBu7RL";
+static const char* const hello_priv_key = "5KPyztSimiMwNw78BanenZ4nCXjxUdjBNx4JMDNGJhNc5gFku6Q";
+
+// the pool holds every transaction of a run, about 300 bytes each
+static const uint64_t max_open_loop_pool_size = 5000000;
+// the last transaction of an open loop run must be due at least this long before the run's transactions expire
+static const uint32_t open_loop_expiration_margin_sec = 60;
+
+static open_loop_latency to_open_loop_latency(const LatencyHistogram& h) {
+   LatencySummary s = h.summary();
+   open_loop_latency l;
+   l.count = s.count;
+   l.avg_us = s.count ? s.sumUs / s.count : 0;
+   l.p50_us = s.p50Us;
+   l.p90_us = s.p90Us;
+   l.p99_us = s.p99Us;
+   l.p999_us = s.p999Us;
+   l.max_us = s.maxUs;
+   return l;
+}
+
+/**
+ *  One open loop run. The signer threads, the pacing timer, the callbacks of the submitted transactions and
+ *  the block signals all hold it, so it outlives a stop. Latencies are taken from the time a transaction was
+ *  scheduled rather than sent, so a generator that falls behind shows up in them.
+ */
+struct open_loop_run {
+   enum run_state { signing, sending, draining, stopped, failed };
+
+   struct pending_trx {
+      uint64_t scheduled_us;
+      bool     included;
+   };
+
+   open_loop_run(const open_loop_params& p, size_t pool_size)
+      : params(p), pool(pool_size), ids(pool_size),
+        admit_latency(latency("admit")), include_latency(latency("include")), irreversible_latency(latency("irreversible")) {
+      admit_latency.reset();
+      include_latency.reset();
+      irreversible_latency.reset();
+   }
+
+   static LatencyHistogram& latency(const std::string& stage) {
+      return LatencyRegistry::getInstance().get("ultrain_txn_test_gen_latency_us", "stage=\"" + stage + "\"",
+                                                "Time from the scheduled submit of a generated transaction to the stage");
+   }
+
+   bool active() const {
+      return state == signing || state == sending;
+   }
+
+   uint64_t now_us() const {
+      return elapsedUs(start);
+   }
+
+   uint64_t scheduled_us(size_t i) const {
+      return i * 1000000 / params.target_tps;
+   }
+
+   void track(const transaction_id_type& id, uint64_t scheduled) {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending[id] = pending_trx{scheduled, false};
+   }
+
+   void on_admitted(const transaction_id_type& id, uint64_t scheduled, bool ok) {
+      if (ok) {
+         admitted++;
+         admit_latency.record(now_us() - scheduled);
+      } else {
+         rejected++;
+         std::lock_guard<std::mutex> lock(mutex);
+         pending.erase(id);
+      }
+   }
+
+   void on_block(const block_state_ptr& bs, bool irreversible_block) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (pending.empty()) {
+         return;
+      }
+      uint64_t now = now_us();
+      for (const auto& receipt : bs->block->transactions) {
+         if (!receipt.trx.contains<packed_transaction>()) {
+            continue;
+         }
+         auto itr = pending.find(receipt.trx.get<packed_transaction>().id());
+         if (itr == pending.end()) {
+            continue;
+         }
+         if (!itr->second.included) {
+            itr->second.included = true;
+            included++;
+            include_latency.record(now - itr->second.scheduled_us);
+         }
+         if (irreversible_block) {
+            irreversible++;
+            irreversible_latency.record(now - itr->second.scheduled_us);
+            pending.erase(itr);
+         }
+      }
+   }
+
+   open_loop_report report() {
+      static const char* const state_names[] = {"signing", "sending", "draining", "stopped", "failed"};
+      open_loop_report r;
+      r.state = state_names[state];
+      r.target_tps = params.target_tps;
+      r.pool_size = pool.size();
+      r.sign_ms = sign_ms;
+      r.sent = next;
+      r.admitted = admitted;
+      r.rejected = rejected;
+      uint64_t send_us = state == sending ? now_us() : send_end_us;
+      r.sent_tps = send_us ? next * 1000000.0 / send_us : 0;
+      r.max_send_lag_us = max_send_lag_us;
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         r.included = included;
+         r.irreversible = irreversible;
+      }
+      r.admit_latency = to_open_loop_latency(admit_latency);
+      r.include_latency = to_open_loop_latency(include_latency);
+      r.irreversible_latency = to_open_loop_latency(irreversible_latency);
+      return r;
+   }
+
+   open_loop_params                      params;
+   std::vector<packed_transaction_ptr>   pool;
+   std::vector<transaction_id_type>      ids;
+   std::atomic<int>                      state{signing};
+   std::atomic<bool>                     cancelled{false};
+   std::atomic<uint64_t>                 sign_ms{0};
+   fc::time_point_sec                    expiration;
+
+   // the pacing state is only used on the application thread
+   std::chrono::steady_clock::time_point start;
+   size_t                                next = 0;
+   uint64_t                              send_end_us = 0;
+   uint64_t                              max_send_lag_us = 0;
+
+   std::atomic<uint64_t>                 admitted{0};
+   std::atomic<uint64_t>                 rejected{0};
+
+   std::mutex                            mutex;
+   std::unordered_map<transaction_id_type, pending_trx> pending;
+   uint64_t                              included = 0;
+   uint64_t                              irreversible = 0;
+
+   LatencyHistogram&                     admit_latency;
+   LatencyHistogram&                     include_latency;
+   LatencyHistogram&                     irreversible_latency;
+};
+
 #define CALL(api_name, api_handle, call_name, INVOKE, http_response_code) \
 {std::string("/v1/" #api_name "/" #call_name), \
    [this](string, string body, url_response_callback cb) mutable { \
@@ -64,10 +227,18 @@ using namespace ultrainio::chain;
      api_handle->call_name(vs.at(0).as<in_param0>(), vs.at(1).as<in_param1>()); \
      ultrainio::detail::txn_test_gen_empty result;
 
+#define INVOKE_V_R(api_handle, call_name, in_param0) \
+     const auto& vs = fc::json::json::from_string(body).as<fc::variants>(); \
+     api_handle->call_name(vs.at(0).as<in_param0>()); \
+     ultrainio::detail::txn_test_gen_empty result;
+
 #define INVOKE_V_V(api_handle, call_name) \
      api_handle->call_name(); \
      ultrainio::detail::txn_test_gen_empty result;
 
+#define INVOKE_R_V(api_handle, call_name) \
+     auto result = api_handle->call_name();
+
 #define CALL_ASYNC(api_name, api_handle, call_name, INVOKE, http_response_code) \
 {std::string("/v1/" #api_name "/" #call_name), \
    [this](string, string body, url_response_callback cb) mutable { \
@@ -317,6 +488,238 @@ struct txn_test_gen_plugin_impl {
       arm_timer(boost::asio::high_resolution_timer::clock_type::now());
    }
 
+   block_id_type get_reference_block_id(controller& cc) const {
+      uint32_t reference_block_num = cc.last_irreversible_block_num();
+      if (txn_reference_block_lag >= 0) {
+         reference_block_num = cc.head_block_num();
+         if (reference_block_num <= (uint32_t)txn_reference_block_lag) {
+            reference_block_num = 0;
+         } else {
+            reference_block_num -= (uint32_t)txn_reference_block_lag;
+         }
+      }
+      return cc.get_block_id_for_num(reference_block_num);
+   }
+
+   void start_generation_open_loop(const open_loop_params& params) {
+      FC_ASSERT(!running && !(open_loop && open_loop->active()), "a transaction generation test is already running");
+      FC_ASSERT(params.target_tps >= 1 && params.target_tps <= 1000000, "target_tps must be in [1, 1000000]");
+      FC_ASSERT(params.duration_sec >= 1, "duration_sec must be positive");
+      FC_ASSERT(params.signer_threads >= 1 && params.signer_threads <= 64, "signer_threads must be in [1, 64]");
+      FC_ASSERT(params.tick_ms >= 1 && params.tick_ms <= 1000, "tick_ms must be in [1, 1000]");
+      FC_ASSERT(params.transfer_weight + params.hello_weight > 0, "transfer_weight or hello_weight must be positive");
+      uint64_t pool_size = uint64_t(params.target_tps) * params.duration_sec;
+      FC_ASSERT(pool_size <= max_open_loop_pool_size, "target_tps * duration_sec must not exceed ${m}", ("m", max_open_loop_pool_size));
+
+      chain_plugin& cp = app().get_plugin<chain_plugin>();
+      controller& cc = cp.chain();
+      uint32_t max_lifetime = cc.get_global_properties().configuration.max_transaction_lifetime;
+      FC_ASSERT(params.duration_sec + open_loop_expiration_margin_sec <= max_lifetime,
+                "duration_sec must be at most ${d}, the max transaction lifetime less ${m}s",
+                ("d", max_lifetime - std::min(max_lifetime, open_loop_expiration_margin_sec))("m", open_loop_expiration_margin_sec));
+
+      std::vector<open_loop_account> accounts = params.accounts;
+      if (accounts.empty()) {
+         accounts.push_back(open_loop_account{name("user.111"), user_111_priv_key});
+         accounts.push_back(open_loop_account{name("user.112"), user_112_priv_key});
+      }
+      FC_ASSERT(params.transfer_weight == 0 || accounts.size() >= 2, "token transfers need at least two accounts");
+
+      // the actions and keys are shared read only by the signer threads, a transfer goes from each account to the next
+      abi_serializer_max_time = cp.get_abi_serializer_max_time();
+      auto transfers = std::make_shared<std::vector<std::pair<action, fc::crypto::private_key>>>();
+      if (params.transfer_weight > 0) {
+         abi_serializer ultrainio_token_serializer{fc::json::from_string(ultrainio_token_abi).as<abi_def>(), abi_serializer_max_time};
+         for (size_t i = 0; i < accounts.size(); i++) {
+            const account_name& from = accounts[i].account;
+            const account_name& to = accounts[(i + 1) % accounts.size()].account;
+            action act;
+            act.account = params.token_contract;
+            act.name = NEX(transfer);
+            act.authorization = vector<permission_level>{{from, config::active_name}};
+            act.data = ultrainio_token_serializer.variant_to_binary("transfer",
+                                                                    fc::mutable_variant_object()("from", from)("to", to)("quantity", params.quantity)("memo", params.salt),
+                                                                    abi_serializer_max_time);
+            transfers->emplace_back(std::move(act), fc::crypto::private_key(accounts[i].private_key));
+         }
+      }
+      auto hi = std::make_shared<std::pair<action, fc::crypto::private_key>>();
+      if (params.hello_weight > 0) {
+         if (!hello_serializer) {
+            hello_serializer = new abi_serializer(fc::json::from_string(hello_abi).as<abi_def>(), abi_serializer_max_time);
+         }
+         hi->first.account = N(hello);
+         hi->first.name = NEX(hi);
+         hi->first.authorization = vector<permission_level>{{name("hello"), config::active_name}};
+         hi->first.data = hello_serializer->variant_to_binary("hi", fc::json::from_string("{\"user\":\"hhh\"}"), abi_serializer_max_time);
+         hi->second = fc::crypto::private_key(std::string(hello_priv_key));
+      }
+
+      chain_id_type chainid = cp.get_chain_id();
+      block_id_type reference_block_id = get_reference_block_id(cc);
+      // signing the pool takes a while, so the transactions get the longest lifetime the chain accepts and
+      // start_sending() checks that the run still ends in time
+      fc::time_point_sec expiration = cc.head_block_time() + fc::seconds(max_lifetime);
+      uint64_t nonce = static_cast<uint64_t>(fc::time_point::now().sec_since_epoch()) << 32;
+
+      if (open_loop_builder.joinable()) {
+         open_loop_builder.join();
+      }
+      auto run = std::make_shared<open_loop_run>(params, pool_size);
+      run->expiration = expiration;
+      open_loop = run;
+      accepted_block_connection.emplace(cc.accepted_block.connect([run](const block_state_ptr& bs) {
+         run->on_block(bs, false);
+      }));
+      irreversible_block_connection.emplace(cc.irreversible_block.connect([run](const block_state_ptr& bs) {
+         run->on_block(bs, true);
+      }));
+
+      ilog("Signing ${n} transactions for an open loop run of ${t} transactions per second over ${d}s",
+           ("n", pool_size)("t", params.target_tps)("d", params.duration_sec));
+      open_loop_builder = std::thread([this, run, transfers, hi, chainid, reference_block_id, expiration, nonce]() {
+         std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+         if (!sign_open_loop_pool(*run, *transfers, *hi, chainid, reference_block_id, expiration, nonce)) {
+            return;
+         }
+         run->sign_ms = elapsedUs(pointStart) / 1000;
+         app().get_io_service().post([this, run]() {
+            if (!run->cancelled) {
+               start_sending(run);
+            }
+         });
+      });
+   }
+
+   // Signs and packs the whole pool, transaction i goes to signer thread i % signer_threads.
+   static bool sign_open_loop_pool(open_loop_run& run, const std::vector<std::pair<action, fc::crypto::private_key>>& transfers,
+                                   const std::pair<action, fc::crypto::private_key>& hi, const chain_id_type& chainid,
+                                   const block_id_type& reference_block_id, const fc::time_point_sec& expiration, uint64_t nonce) {
+      size_t threads = run.params.signer_threads;
+      size_t pool_size = run.pool.size();
+      uint32_t weight = run.params.transfer_weight + run.params.hello_weight;
+      std::vector<std::thread> signers;
+      std::vector<std::exception_ptr> errors(threads);
+      for (size_t t = 0; t < threads; t++) {
+         signers.emplace_back([&, t]() {
+            try {
+               for (size_t i = t; i < pool_size && !run.cancelled; i += threads) {
+                  signed_transaction trx;
+                  const fc::crypto::private_key* key = &hi.second;
+                  if (i % weight < run.params.transfer_weight) {
+                     // the transfers take the accounts in turn
+                     const auto& transfer = transfers[(i / weight * run.params.transfer_weight + i % weight) % transfers.size()];
+                     trx.actions.push_back(transfer.first);
+                     key = &transfer.second;
+                  } else {
+                     trx.actions.push_back(hi.first);
+                  }
+                  trx.context_free_actions.emplace_back(action({}, config::null_account_name, "nonce", fc::raw::pack(nonce + i)));
+                  trx.set_reference_block(reference_block_id);
+                  trx.expiration = expiration;
+                  trx.max_net_usage_words = 100;
+                  trx.sign(*key, chainid);
+                  run.ids[i] = trx.id();
+                  run.pool[i] = std::make_shared<packed_transaction>(std::move(trx), packed_transaction::zlib);
+               }
+            } catch (...) {
+               errors[t] = std::current_exception();
+            }
+         });
+      }
+      for (auto& signer : signers) {
+         signer.join();
+      }
+      for (const auto& e : errors) {
+         if (e) {
+            try {
+               std::rethrow_exception(e);
+            } catch (const fc::exception& ex) {
+               elog("signing the open loop pool failed: ${e}", ("e", ex.to_detail_string()));
+            } catch (const std::exception& ex) {
+               elog("signing the open loop pool failed: ${e}", ("e", ex.what()));
+            }
+            run.state = open_loop_run::failed;
+            return false;
+         }
+      }
+      return !run.cancelled;
+   }
+
+   void start_sending(const std::shared_ptr<open_loop_run>& run) {
+      fc::time_point last_due = fc::time_point::now() + fc::seconds(run->params.duration_sec + open_loop_expiration_margin_sec);
+      if (last_due > fc::time_point(run->expiration)) {
+         elog("Signing ${n} transactions took ${t}ms, the open loop run would end within ${m}s of their expiration at ${e}, lower duration_sec or add signer_threads",
+              ("n", run->pool.size())("t", run->sign_ms.load())("m", open_loop_expiration_margin_sec)("e", run->expiration));
+         run->state = open_loop_run::failed;
+         run->pool.clear();
+         return;
+      }
+      ilog("Signed ${n} transactions in ${t}ms, sending ${r} transactions per second",
+           ("n", run->pool.size())("t", run->sign_ms.load())("r", run->params.target_tps));
+      run->start = std::chrono::steady_clock::now();
+      run->state = open_loop_run::sending;
+      open_loop_timer.expires_at(boost::asio::high_resolution_timer::clock_type::now());
+      send_due_transactions(run);
+   }
+
+   // Submits every transaction scheduled up to now without waiting for the previous ones to be admitted,
+   // so a slow node builds up a backlog instead of slowing the generator down.
+   void send_due_transactions(const std::shared_ptr<open_loop_run>& run) {
+      if (run->cancelled) {
+         return;
+      }
+      auto& incoming_transaction_async = app().get_method<chain::plugin_interface::incoming::methods::transaction_async>();
+      uint64_t now = run->now_us();
+      size_t due = std::min<uint64_t>(run->pool.size(), now * run->params.target_tps / 1000000 + 1);
+      for (; run->next < due; run->next++) {
+         size_t i = run->next;
+         uint64_t scheduled = run->scheduled_us(i);
+         run->max_send_lag_us = std::max(run->max_send_lag_us, now - scheduled);
+         run->track(run->ids[i], scheduled);
+         incoming_transaction_async(run->pool[i], false, false, [run, i, scheduled](const fc::static_variant<fc::exception_ptr, transaction_trace_ptr>& result) {
+            bool ok = result.contains<transaction_trace_ptr>() && !result.get<transaction_trace_ptr>()->except;
+            run->on_admitted(run->ids[i], scheduled, ok);
+         });
+         // the incoming queue holds its own reference
+         run->pool[i].reset();
+      }
+      if (run->next == run->pool.size()) {
+         run->send_end_us = run->now_us();
+         run->state = open_loop_run::draining;
+         ilog("Sent all ${n} open loop transactions", ("n", run->next));
+         return;
+      }
+      open_loop_timer.expires_at(open_loop_timer.expires_at() + std::chrono::milliseconds(run->params.tick_ms));
+      open_loop_timer.async_wait([this, run](const boost::system::error_code& ec) {
+         if (ec) {
+            return;
+         }
+         send_due_transactions(run);
+      });
+   }
+
+   open_loop_report get_open_loop_report() {
+      if (!open_loop) {
+         open_loop_report r;
+         r.state = "idle";
+         return r;
+      }
+      return open_loop->report();
+   }
+
+   void stop_open_loop() {
+      open_loop->cancelled = true;
+      open_loop_timer.cancel();
+      if (open_loop_builder.joinable()) {
+         open_loop_builder.join();
+      }
+      if (open_loop->state == open_loop_run::sending) {
+         open_loop->send_end_us = open_loop->now_us();
+      }
+      open_loop->state = open_loop_run::stopped;
+   }
+
    void arm_timer(boost::asio::high_resolution_timer::time_point s) {
       timer.expires_at(s + std::chrono::milliseconds(timer_timeout));
       timer.async_wait([this](const boost::system::error_code& ec) {
@@ -343,24 +746,14 @@ struct txn_test_gen_plugin_impl {
           controller& cc = app().get_plugin<chain_plugin>().chain();
           auto chainid = app().get_plugin<chain_plugin>().get_chain_id();
 
-          fc::crypto::private_key a_priv_key(std::string("5JbXkT2DP8HpwfaCRmSa3Qw2vH1pqnxfKGk5w8riUJUSVx7j1ir"));
-          fc::crypto::private_key b_priv_key(std::string("5J4fz4cApTLTZzqjKsFSdCYPUyDNcmSD2WsLRoPbGjSB8KBu7RL"));
-          fc::crypto::private_key hello_priv_key(std::string("5KPyztSimiMwNw78BanenZ4nCXjxUdjBNx4JMDNGJhNc5gFku6Q"));
+          fc::crypto::private_key a_priv_key = fc::crypto::private_key(std::string(user_111_priv_key));
+          fc::crypto::private_key b_priv_key = fc::crypto::private_key(std::string(user_112_priv_key));
+          fc::crypto::private_key h_priv_key = fc::crypto::private_key(std::string(hello_priv_key));
 
          static uint64_t nonce = static_cast<uint64_t>(fc::time_point::now().sec_since_epoch()) << 32;
          //         abi_serializer ultrainio_serializer(cc.db().find<account_object, by_name>(config::system_account_name)->get_abi());
 
-         uint32_t reference_block_num = cc.last_irreversible_block_num();
-         if (txn_reference_block_lag >= 0) {
-            reference_block_num = cc.head_block_num();
-            if (reference_block_num <= (uint32_t)txn_reference_block_lag) {
-               reference_block_num = 0;
-            } else {
-               reference_block_num -= (uint32_t)txn_reference_block_lag;
-            }
-         }
-
-         block_id_type reference_block_id = cc.get_block_id_for_num(reference_block_num);
+         block_id_type reference_block_id = get_reference_block_id(cc);
 
          for(unsigned int i = 0; i < batch; ++i) {
              if(trx_count%1000 == 0){
@@ -411,7 +804,7 @@ struct txn_test_gen_plugin_impl {
                      trx.set_reference_block(reference_block_id);
                      trx.expiration = cc.head_block_time() + fc::seconds(60);
                      trx.max_net_usage_words = 100;
-                     trx.sign(hello_priv_key, chainid);
+                     trx.sign(h_priv_key, chainid);
                      trxs.emplace_back(std::move(trx));
                  }
              }
@@ -424,8 +817,11 @@ struct txn_test_gen_plugin_impl {
    }
 
    void stop_generation() {
-      if(!running)
+      bool open_loop_active = open_loop && open_loop->active();
+      if(!running && !open_loop_active)
          throw fc::exception(fc::invalid_operation_exception_code);
+      if(open_loop_active)
+         stop_open_loop();
       timer.cancel();
       running = false;
       is_transfer_test = false;
@@ -433,6 +829,15 @@ struct txn_test_gen_plugin_impl {
       ilog("Stopping transaction generation test");
    }
 
+   ~txn_test_gen_plugin_impl() {
+      if (open_loop) {
+         open_loop->cancelled = true;
+      }
+      if (open_loop_builder.joinable()) {
+         open_loop_builder.join();
+      }
+   }
+
     boost::asio::high_resolution_timer timer{app().get_io_service()};
     bool running{false};
 
@@ -448,6 +853,12 @@ struct txn_test_gen_plugin_impl {
 
     int32_t txn_reference_block_lag;
 
+    std::shared_ptr<open_loop_run> open_loop;
+    std::thread open_loop_builder;
+    boost::asio::high_resolution_timer open_loop_timer{app().get_io_service()};
+    fc::optional<boost::signals2::scoped_connection> accepted_block_connection;
+    fc::optional<boost::signals2::scoped_connection> irreversible_block_connection;
+
 //    abi_serializer ultrainio_token_serializer = fc::json::from_string(ultrainio_token_abi).as<abi_def>();
     static int64_t trx_count;
 
@@ -475,7 +886,9 @@ void txn_test_gen_plugin::plugin_startup() {
       CALL_ASYNC(txn_test_gen, my, create_test_accounts, INVOKE_ASYNC_R_R(my, create_test_accounts, std::string, std::string), 200),
       CALL(txn_test_gen, my, stop_generation, INVOKE_V_V(my, stop_generation), 200),
       CALL(txn_test_gen, my, start_generation_transfer, INVOKE_V_R_R_R(my, start_generation_transfer, std::string, uint64_t, uint64_t), 200),
-      CALL(txn_test_gen, my, start_generation_hello, INVOKE_V_R_R_R(my, start_generation_hello, std::string, uint64_t, uint64_t), 200)
+      CALL(txn_test_gen, my, start_generation_hello, INVOKE_V_R_R_R(my, start_generation_hello, std::string, uint64_t, uint64_t), 200),
+      CALL(txn_test_gen, my, start_generation_open_loop, INVOKE_V_R(my, start_generation_open_loop, open_loop_params), 200),
+      CALL(txn_test_gen, my, get_open_loop_report, INVOKE_R_V(my, get_open_loop_report), 200)
    });
 }
 
@@ -485,6 +898,8 @@ void txn_test_gen_plugin::plugin_shutdown() {
    }
    catch(fc::exception e) {
    }
+   my->accepted_block_connection.reset();
+   my->irreversible_block_connection.reset();
 }
 
 }
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <fc/io/json.hpp>
+#include <fc/log/logger.hpp>
+#include <fc/variant_object.hpp>
+
+#include <ultrainio/chain/abi_serializer.hpp>
+#include <ultrainio/testing/tester.hpp>
+
+#include <test_api_multi_index/test_api_multi_index.wast.hpp>
+#include <ultrainio.token/ultrainio.token.abi.hpp>
+#include <ultrainio.token/ultrainio.token.wast.hpp>
+
+using namespace ultrainio;
+using namespace ultrainio::chain;
+using namespace ultrainio::testing;
+using namespace std;
+
+namespace bpo = boost::program_options;
+namespace bfs = boost::filesystem;
+
+struct BenchConfig {
+    uint32_t transactions = 2000;
+    uint32_t trxPerBlock = 200;
+    uint32_t accounts = 100;
+    std::string wasmRuntime = "wavm";
+    std::string worldstate;
+    std::string output;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t actions = 0;
+    uint64_t blocks = 0;
+    uint64_t totalUs = 0;
+};
+
+// tester only exposes the config it was opened with to derived classes
+class BenchTester : public tester {
+public:
+    explicit BenchTester(const controller::config& config) : tester(config) {}
+
+    const controller::config& getConfig() const {
+        return cfg;
+    }
+};
+
+static const account_name kTokenAccount = N(utrio.token);
+static const account_name kMultiIndexAccount = N(testapi);
+// the token symbol, in the same form as txn_test_gen_plugin
+static const char* kSymbol = "CUR";
+
+static uint64_t djbh(const char* s) {
+    unsigned int hash = 5381;
+    while (*s) {
+        hash = 33 * hash ^ static_cast<unsigned char>(*s++);
+    }
+    return hash;
+}
+
+// action name of a WASM_TEST_HANDLER_EX handler of the test_api contracts
+static action_name testApiAction(const char* cls, const char* method) {
+    return action_name(0, djbh(cls) << 32 | djbh(method));
+}
+
+static controller::config makeConfig(const bfs::path& dir, const BenchConfig& bench) {
+    controller::config config;
+    config.blocks_dir = dir / config::default_blocks_dir_name;
+    config.state_dir = dir / config::default_state_dir_name;
+    config.worldstate_dir = dir / "worldstate";
+    config.state_size = 1024 * 1024 * 1024ll;
+    config.state_guard_size = 0;
+    config.contracts_console = false;
+    config.genesis.initial_timestamp = fc::time_point::from_iso_string("2020-01-01T00:00:00.000");
+    config.genesis.initial_key = base_tester::get_public_key(config::system_account_name, "active");
+    if (bench.wasmRuntime == "binaryen") {
+        config.wasm_runtime = wasm_interface::vm_type::binaryen;
+    } else if (bench.wasmRuntime == "wabt") {
+        config.wasm_runtime = wasm_interface::vm_type::wabt;
+    } else {
+        config.wasm_runtime = wasm_interface::vm_type::wavm;
+    }
+    return config;
+}
+
+static account_name holder(uint32_t i) {
+    // holder names are bench.aaaaa, bench.aaaab, ... only a-z keep them valid account names
+    std::string s = "bench.";
+    for (int d = 0; d < 5; d++) {
+        s.insert(6, 1, static_cast<char>('a' + i % 26));
+        i /= 26;
+    }
+    return account_name(s);
+}
+
+static signed_transaction makeTrx(const base_tester& chain, action&& act, account_name signer) {
+    signed_transaction trx;
+    trx.actions.emplace_back(std::move(act));
+    // every batch is signed just before its block, so the expiration only has to cover the next block,
+    // one spare interval is kept; a longer one only grows the index of transaction ids kept until expiry
+    chain.set_transaction_headers(trx, 2 * config::block_interval_ms / 1000);
+    trx.sign(base_tester::get_private_key(signer, "active"), chain.control->get_chain_id());
+    return trx;
+}
+
+// Pushes count transactions, trxPerBlock per block, and times the pushes and the block production only,
+// build(i) creates and signs the i-th transaction outside the timed region.
+template <typename Builder>
+static BenchResult runTransactions(BenchTester& chain, const std::string& name, uint32_t count, uint32_t trxPerBlock,
+                                   Builder build) {
+    BenchResult result;
+    result.name = name;
+    for (uint32_t start = 0; start < count; start += trxPerBlock) {
+        uint32_t end = std::min(count, start + trxPerBlock);
+        std::vector<signed_transaction> batch;
+        batch.reserve(end - start);
+        for (uint32_t i = start; i < end; i++) {
+            batch.emplace_back(build(i));
+        }
+        std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+        for (auto& trx : batch) {
+            chain.push_transaction(trx);
+        }
+        chain.produce_block();
+        result.totalUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart).count();
+        for (const auto& trx : batch) {
+            result.actions += trx.actions.size();
+        }
+        result.count += batch.size();
+        result.blocks++;
+    }
+    return result;
+}
+
+static BenchResult benchNewAccount(BenchTester& chain, const BenchConfig& bench) {
+    return runTransactions(chain, "system_newaccount", bench.accounts, bench.trxPerBlock, [&](uint32_t i) {
+        account_name a = holder(i);
+        action act(vector<permission_level>{{config::system_account_name, config::active_name}},
+                   newaccount{
+                           .creator = config::system_account_name,
+                           .name = a,
+                           .owner = authority(base_tester::get_public_key(a, "owner")),
+                           .active = authority(base_tester::get_public_key(a, "active")),
+                   });
+        return makeTrx(chain, std::move(act), config::system_account_name);
+    });
+}
+
+static BenchResult benchTokenTransfer(BenchTester& chain, const BenchConfig& bench) {
+    chain.create_account(kTokenAccount);
+    chain.set_code(kTokenAccount, ultrainio_token_wast);
+    chain.set_abi(kTokenAccount, ultrainio_token_abi);
+    chain.produce_block();
+
+    std::string supply = std::string("1000000000.0000 ") + kSymbol;
+    std::string balance = std::string("10000.0000 ") + kSymbol;
+    chain.push_action(kTokenAccount, "create", kTokenAccount,
+                      fc::mutable_variant_object()("issuer", kTokenAccount)("maximum_supply", supply));
+    chain.push_action(kTokenAccount, "issue", kTokenAccount,
+                      fc::mutable_variant_object()("to", kTokenAccount)("quantity", supply)("memo", ""));
+    for (uint32_t i = 0; i < bench.accounts; i++) {
+        chain.push_action(kTokenAccount, "transfer", kTokenAccount,
+                          fc::mutable_variant_object()("from", kTokenAccount)("to", holder(i))("quantity", balance)("memo", ""));
+    }
+    chain.produce_block();
+
+    abi_serializer serializer(fc::json::from_string(ultrainio_token_abi).as<abi_def>(), base_tester::abi_serializer_max_time);
+    std::string quantity = std::string("0.0001 ") + kSymbol;
+    return runTransactions(chain, "token_transfer", bench.transactions, bench.trxPerBlock, [&](uint32_t i) {
+        account_name from = holder(i % bench.accounts);
+        account_name to = holder((i + 1) % bench.accounts);
+        action act;
+        act.account = kTokenAccount;
+        act.name = "transfer";
+        act.authorization = vector<permission_level>{{from, config::active_name}};
+        // the memo keeps the transaction ids apart
+        act.data = serializer.variant_to_binary("transfer",
+                                                fc::mutable_variant_object()("from", from)("to", to)("quantity", quantity)("memo", std::to_string(i)),
+                                                base_tester::abi_serializer_max_time);
+        return makeTrx(chain, std::move(act), from);
+    });
+}
+
+static BenchResult benchMultiIndex(BenchTester& chain, const BenchConfig& bench) {
+    chain.create_account(kMultiIndexAccount);
+    chain.set_code(kMultiIndexAccount, test_api_multi_index_wast);
+    chain.produce_block();
+
+    auto makeAction = [](const char* method, uint32_t nonce) {
+        action act;
+        act.account = kMultiIndexAccount;
+        act.name = testApiAction("test_multi_index", method);
+        act.authorization = vector<permission_level>{{kMultiIndexAccount, config::active_name}};
+        // the handlers do not read the action data, the nonce keeps the transaction ids apart
+        act.data = fc::raw::pack(nonce);
+        return act;
+    };
+    // the rows have fixed primary keys, so they are stored once and then only read
+    signed_transaction store = makeTrx(chain, makeAction("idx64_store_only", 0), kMultiIndexAccount);
+    chain.push_transaction(store);
+    chain.produce_block();
+
+    return runTransactions(chain, "multi_index_read", bench.transactions, bench.trxPerBlock, [&](uint32_t i) {
+        return makeTrx(chain, makeAction("idx64_check_without_storing", i), kMultiIndexAccount);
+    });
+}
+
+// actions of the transactions a block carries, deferred transactions are counted by id only and have none here
+static uint64_t countActions(const signed_block& block) {
+    uint64_t actions = 0;
+    for (const auto& receipt : block.transactions) {
+        if (receipt.trx.contains<packed_transaction>()) {
+            actions += receipt.trx.get<packed_transaction>().get_transaction().actions.size();
+        } else if (receipt.trx.contains<packed_generated_transaction>()) {
+            actions += receipt.trx.get<packed_generated_transaction>().get_transaction().actions.size();
+        }
+    }
+    return actions;
+}
+
+static BenchResult benchBlockApply(BenchTester& source, BenchTester& target) {
+    BenchResult result;
+    result.name = "block_apply";
+    uint32_t head = source.control->head_block_num();
+    std::vector<signed_block_ptr> blocks;
+    for (uint32_t num = target.control->head_block_num() + 1; num <= head; num++) {
+        blocks.push_back(source.control->fetch_block_by_number(num));
+        result.count += blocks.back()->transactions.size();
+        result.actions += countActions(*blocks.back());
+    }
+    std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+    for (const auto& b : blocks) {
+        target.push_block(b);
+    }
+    result.totalUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart).count();
+    result.blocks = blocks.size();
+    return result;
+}
+
+static BenchResult benchReplay(BenchTester& chain) {
+    BenchResult result;
+    result.name = "replay";
+    controller::config config = chain.getConfig();
+    chain.close();
+    // without the state the controller rebuilds it from the block log
+    bfs::remove_all(config.state_dir);
+    std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+    chain.open();
+    result.totalUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart).count();
+    result.blocks = chain.control->head_block_num();
+    for (uint32_t num = 1; num <= result.blocks; num++) {
+        signed_block_ptr b = chain.control->fetch_block_by_number(num);
+        if (b) {
+            result.count += b->transactions.size();
+            result.actions += countActions(*b);
+        }
+    }
+    return result;
+}
+
+static BenchResult benchWorldstateRestore(const bfs::path& dir, const BenchConfig& bench) {
+    BenchResult result;
+    result.name = "worldstate_restore";
+    controller::config config = makeConfig(dir, bench);
+    std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+    controller control(config);
+    control.add_indices();
+    control.startup(bench.worldstate);
+    result.totalUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart).count();
+    result.count = 1;
+    result.blocks = control.head_block_num();
+    return result;
+}
+
+static fc::variant toVariant(const BenchResult& r) {
+    uint64_t us = std::max<uint64_t>(1, r.totalUs);
+    return fc::mutable_variant_object()
+            ("name", r.name)
+            ("count", r.count)
+            ("actions", r.actions)
+            ("blocks", r.blocks)
+            ("total_us", r.totalUs)
+            ("per_second", static_cast<uint64_t>(r.count * 1000000.0 / us))
+            ("us_per_action", r.actions ? static_cast<double>(us) / r.actions : 0.0)
+            ("us_per_block", r.blocks ? static_cast<double>(us) / r.blocks : 0.0);
+}
+
+// push system actions, token transfers and multi_index reads through a real controller, then apply the
+// same blocks on a second chain, replay them from the block log and optionally restore a worldstate,
+// and write every result as json so runs can be compared
+int main(int argc, char* argv[]) {
+    BenchConfig bench;
+    bpo::options_description options("chain benchmark options");
+    options.add_options()
+            ("help,h", "print this help")
+            ("transactions,t", bpo::value<uint32_t>(&bench.transactions)->default_value(bench.transactions), "transactions of every contract scenario")
+            ("trx-per-block", bpo::value<uint32_t>(&bench.trxPerBlock)->default_value(bench.trxPerBlock), "transactions in a block")
+            ("accounts,a", bpo::value<uint32_t>(&bench.accounts)->default_value(bench.accounts), "accounts created and used by the token transfers")
+            ("wasm-runtime", bpo::value<std::string>(&bench.wasmRuntime)->default_value(bench.wasmRuntime), "wavm, binaryen or wabt")
+            ("worldstate", bpo::value<std::string>(&bench.worldstate), "worldstate file to restore, skipped if not given")
+            ("output,o", bpo::value<std::string>(&bench.output), "json result file, stdout if not given");
+    bpo::variables_map vm;
+    try {
+        bpo::store(bpo::parse_command_line(argc, argv, options), vm);
+        bpo::notify(vm);
+    } catch (const std::exception& e) {
+        cout << e.what() << std::endl << options << std::endl;
+        return 1;
+    }
+    if (vm.count("help") || bench.transactions == 0 || bench.trxPerBlock == 0 || bench.accounts < 2) {
+        cout << options << std::endl;
+        return 0;
+    }
+    fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::warn);
+
+    fc::variants results;
+    try {
+        fc::temp_directory dir;
+        BenchTester chain(makeConfig(dir.path() / "producer", bench));
+        chain.produce_block();
+        results.push_back(toVariant(benchNewAccount(chain, bench)));
+        results.push_back(toVariant(benchTokenTransfer(chain, bench)));
+        results.push_back(toVariant(benchMultiIndex(chain, bench)));
+
+        BenchTester validator(makeConfig(dir.path() / "validator", bench));
+        results.push_back(toVariant(benchBlockApply(chain, validator)));
+        results.push_back(toVariant(benchReplay(validator)));
+
+        if (!bench.worldstate.empty()) {
+            results.push_back(toVariant(benchWorldstateRestore(dir.path() / "worldstate", bench)));
+        }
+    } catch (const fc::exception& e) {
+        elog("${e}", ("e", e.to_detail_string()));
+        return 1;
+    } catch (const std::exception& e) {
+        elog("${e}", ("e", e.what()));
+        return 1;
+    }
+
+    std::string json = fc::json::to_pretty_string(fc::mutable_variant_object()
+            ("wasm_runtime", bench.wasmRuntime)
+            ("transactions", bench.transactions)
+            ("trx_per_block", bench.trxPerBlock)
+            ("accounts", bench.accounts)
+            ("results", results));
+    if (bench.output.empty()) {
+        cout << json << std::endl;
+    } else {
+        std::ofstream out(bench.output);
+        out << json << std::endl;
+    }
+    return 0;
+}
@@ -1,21 +1,97 @@
 #include <fc/crypto/sha256.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
+static const char* kernelName(fc::sha256::batch_kernel k) {
+    switch (k) {
+        case fc::sha256::batch_kernel::portable:
+            return "portable";
+        case fc::sha256::batch_kernel::shani:
+            return "shani";
+        case fc::sha256::batch_kernel::avx2:
+            return "avx2";
+        default:
+            return "automatic";
+    }
+}
+
+static void report(const std::string& name, int n, size_t bytes, std::chrono::microseconds d) {
+    uint64_t us = std::max<uint64_t>(1, d.count());
+    std::cout << name << " : " << n << " hashes in " << us << " microseconds, "
+              << static_cast<uint64_t>(n * 1000000.0 / us) << " hashes/s, "
+              << static_cast<uint64_t>(static_cast<double>(n) * bytes / us) << " MB/s" << std::endl;
+}
+
+// usage : sha256_performance_test <ignored> <count>
+// hashes count messages one by one for several sizes, then count 64 byte messages in batches
+// with every batch kernel the cpu supports, the 64 byte case is a merkle node or a pair of ids
 int main(int argc, char* argv[]) {
     if (argc < 3) {
         std::cout << "argument count < 3";
         return 0;
     }
     int n = atoi(argv[2]);
-    std::string* m = new std::string[n];
+    if (n <= 0) {
+        std::cout << "count <= 0";
+        return 0;
+    }
+
+    size_t sizes[] = {32, 64, 256, 1024};
+    for (size_t size : sizes) {
+        std::vector<char> data(size, 'u');
+        std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            data[0] = static_cast<char>(i);
+            fc::sha256::hash(data.data(), size);
+        }
+        report("single " + std::to_string(size) + " bytes", n, size,
+               std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart));
+    }
+
+    std::vector<char> in(64 * static_cast<size_t>(n));
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = static_cast<char>(i * 131 + (i >> 8));
+    }
+    std::vector<fc::sha256> expected(n);
+    std::vector<fc::sha256> out(n);
+    fc::sha256::hash_64(in.data(), n, expected.data(), fc::sha256::batch_kernel::portable);
+    std::cout << "best batch kernel : " << kernelName(fc::sha256::best_batch_kernel()) << std::endl;
+
+    fc::sha256::batch_kernel kernels[] = {fc::sha256::batch_kernel::portable, fc::sha256::batch_kernel::shani,
+                                          fc::sha256::batch_kernel::avx2};
+    for (auto k : kernels) {
+        if (!fc::sha256::has_batch_kernel(k)) {
+            std::cout << "batch " << kernelName(k) << " : not supported" << std::endl;
+            continue;
+        }
+        std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+        fc::sha256::hash_64(in.data(), n, out.data(), k);
+        std::chrono::microseconds d = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart);
+        if (out != expected) {
+            std::cout << "batch " << kernelName(k) << " : mismatch with the portable kernel" << std::endl;
+            return 1;
+        }
+        report("batch " + std::string(kernelName(k)), n, 64, d);
+    }
+
+    // one merkle root over n leaves, level by level as merkle() does
+    std::vector<fc::sha256> level(expected);
     std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
-    for (int i = 0; i < n; i++) {
-        fc::sha256::hash(m[i]);
+    int pairs = 0;
+    while (level.size() > 1) {
+        if (level.size() % 2) {
+            level.push_back(level.back());
+        }
+        std::vector<fc::sha256> next(level.size() / 2);
+        fc::sha256::hash_pairs(level.data(), next.size(), next.data());
+        pairs += next.size();
+        level.swap(next);
     }
-    std::chrono::microseconds d = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart);
-    std::cout << "hash each one consume : " << d.count() / n << " microseconds " << std::endl;
-    delete []m;
+    report("merkle levels", pairs, 64,
+           std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart));
     return 0;
-}
\ No newline at end of file
+}
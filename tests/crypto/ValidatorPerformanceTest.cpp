@@ -0,0 +1,69 @@
+#include <stdlib.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <core/Message.h>
+#include <crypto/Digest.h>
+#include <crypto/PrivateKey.h>
+#include <crypto/PublicKey.h>
+#include <crypto/Signer.h>
+#include <crypto/Validator.h>
+
+using namespace ultrainio;
+using namespace std;
+
+// the way Validator hashed a message before HexDigest
+template <class T>
+static bool legacyVerify(const Signature& signature, const T& v, const PublicKey& publicKey) {
+    fc::sha256 h = fc::sha256::hash(v);
+    return publicKey.verify(signature, Digest(h.str()));
+}
+
+template <class T>
+static void run(const std::string& name, const T& v, const Signature& signature, const PublicKey& publicKey, int number) {
+    std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < number; i++) {
+        if (!legacyVerify<T>(signature, v, publicKey)) {
+            cout << "legacy verify " << name << " error" << std::endl;
+            exit(1);
+        }
+    }
+    std::chrono::nanoseconds d = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pointStart);
+    cout << name << " legacy verify each one consume : " << d.count() / number << " ns " << std::endl;
+
+    pointStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < number; i++) {
+        if (!Validator::verify<T>(signature, v, publicKey)) {
+            cout << "verify " << name << " error" << std::endl;
+            exit(1);
+        }
+    }
+    d = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - pointStart);
+    cout << name << " verify each one consume : " << d.count() / number << " ns " << std::endl;
+}
+
+// compare the echo/propose verify time of Validator with the string digest path
+int main(int argc, char* argv[]) {
+    int NUMBER = 10000;
+    if (argc > 1) {
+        NUMBER = atoi(argv[1]);
+    }
+    PrivateKey privateKey;
+    PublicKey publicKey;
+    PrivateKey::generate(publicKey, privateKey);
+
+    EchoMsg echoMsg;
+    echoMsg.baxCount = 0;
+    echoMsg.account = N("ultr_test");
+    echoMsg.timestamp = 1;
+    Signature echoSignature = Signer::sign<UnsignedEchoMsg>(echoMsg, privateKey);
+    run<UnsignedEchoMsg>("echo", echoMsg, echoSignature, publicKey, NUMBER);
+
+    Block block;
+    block.version = 1;
+    block.proposer = N("ultr_genesis");
+    Signature blockSignature = Signer::sign<BlockHeader>(block, privateKey);
+    run<BlockHeader>("propose", block, blockSignature, publicKey, NUMBER);
+    return 0;
+}
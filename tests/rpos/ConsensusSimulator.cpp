@@ -0,0 +1,559 @@
+#include "ConsensusSimulator.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <fc/crypto/private_key.hpp>
+#include <fc/io/raw.hpp>
+
+#include <base/Hex.h>
+#include <crypto/Bls.h>
+#include <crypto/Signer.h>
+#include <crypto/Validator.h>
+#include <lightclient/CommitteeInfo.h>
+#include <rpos/Config.h>
+#include <rpos/Genesis.h>
+#include <rpos/MsgMgr.h>
+#include <rpos/Node.h>
+#include <rpos/Scheduler.h>
+
+namespace ultrainio {
+    // overflow rounds of the message caches, m_maxCachePropose and m_maxCacheEcho of Scheduler
+    static const size_t kMaxCacheRounds = 200;
+
+    SimNode::SimNode(ConsensusSimulator& simulator, int index, std::shared_ptr<NodeInfo> nodeInfo)
+            : m_simulator(simulator), m_index(index), m_nodeInfo(nodeInfo),
+              m_cacheProposeMsgMap(kMaxCacheRounds), m_cacheEchoMsgMap(kMaxCacheRounds) {}
+
+    void SimNode::start() {
+        // MsgMgr starts from block 2, the round after the genesis block
+        BlockHeader genesis;
+        genesis.timestamp = chain::block_timestamp_type(1);
+        newRound(genesis.id());
+    }
+
+    ConsensusPhase SimNode::getPhase() const {
+        return m_phase;
+    }
+
+    uint32_t SimNode::getBlockNum() const {
+        return m_blockNum;
+    }
+
+    std::shared_ptr<NodeInfo> SimNode::getNodeInfo() const {
+        return m_nodeInfo;
+    }
+
+    std::shared_ptr<StakeVoteBase> SimNode::getStakeVote() const {
+        return MsgMgr::getInstance()->getStakeVote(m_blockNum);
+    }
+
+    void SimNode::phaseLoop(uint32_t timeoutMs, std::function<void()> process) {
+        uint64_t seq = ++m_timerSeq;
+        m_simulator.schedule(m_index, timeoutMs * 1000ULL, [this, seq, process]() {
+            if (seq == m_timerSeq) {
+                process();
+            }
+        });
+    }
+
+    // as Node::run
+    void SimNode::newRound(const BlockIdType& previous) {
+        m_previous = previous;
+        m_blockNum = BlockHeader::num_from_id(previous) + 1;
+        m_roundStartUs = m_simulator.now();
+        m_proposerMsgMap.clear();
+        m_echoMsgMap.clear();
+        m_echoMsgAllPhase.clear();
+
+        BlockHeader emptyBlock;
+        emptyBlock.previous = m_previous;
+        emptyBlock.timestamp = chain::block_timestamp_type(m_blockNum);
+        emptyBlock.proposer = N(utrio.empty);
+        m_emptyBlockId = emptyBlock.id();
+        m_ba0Echo = emptyEcho();
+
+        moveToStep(kPhaseBA0, 0);
+        processCache(RoundInfo(m_blockNum, kPhaseBA0));
+        vote();
+
+        uint32_t leftMs = Node::getLeftTime(m_simulator.clock());
+        if (m_simulator.getConfig().fastPhase && Node::isFastLoop(leftMs, MsgMgr::getInstance()->isProposer(m_blockNum))) {
+            phaseLoop(Node::getFastLoopTime(), [this]() { fastProcess(); });
+        } else {
+            phaseLoop(leftMs, [this]() { ba0Process(); });
+        }
+    }
+
+    void SimNode::moveToStep(ConsensusPhase phase, uint32_t baxCount) {
+        m_phase = phase;
+        m_baxCount = baxCount;
+        MsgMgr::getInstance()->moveToNewStep(m_blockNum, phase, baxCount);
+    }
+
+    // as Scheduler::processCache
+    void SimNode::processCache(const RoundInfo& info) {
+        m_cacheProposeMsgMap.expireBefore(RoundInfo(info.blockNum, kPhaseBA0));
+        m_cacheEchoMsgMap.expireBefore(info);
+
+        ProposeCacheSlot* proposeSlot = m_cacheProposeMsgMap.find(info);
+        if (proposeSlot) {
+            std::vector<ProposeMsg> proposes;
+            proposes.swap(proposeSlot->msgs);
+            m_cacheProposeMsgMap.erase(info);
+            for (const auto& propose : proposes) {
+                handlePropose(propose);
+            }
+        }
+        EchoCacheSlot* echoSlot = m_cacheEchoMsgMap.find(info);
+        if (echoSlot) {
+            std::vector<EchoMsg> echoes;
+            echoes.swap(echoSlot->msgs);
+            m_cacheEchoMsgMap.erase(info);
+            for (const auto& echo : echoes) {
+                handleEcho(echo);
+            }
+        }
+    }
+
+    // as Node::fastProcess, leave BA0 when f + 1 BA1 echoes are cached
+    void SimNode::fastProcess() {
+        if (Scheduler::isFastba0(m_cacheEchoMsgMap.find(RoundInfo(m_blockNum, kPhaseBA1)),
+                                 getStakeVote()->getSendEchoThreshold())) {
+            ba0Process();
+            return;
+        }
+        phaseLoop(Node::getLeftTime(m_simulator.clock()), [this]() { ba0Process(); });
+    }
+
+    void SimNode::ba0Process() {
+        m_ba0Echo = emptyEcho();
+        BlockIdType blockId = Scheduler::findMin2fEcho(m_echoMsgMap, m_blockNum, kPhaseBA0);
+        if (blockId != BlockIdType()) {
+            auto itor = m_proposerMsgMap.find(blockId);
+            if (itor != m_proposerMsgMap.end()) {
+                m_ba0Echo.blockId = blockId;
+                m_ba0Echo.proposer = itor->second.block.proposer;
+            }
+        }
+        phaseLoop(Node::getLeftTime(m_simulator.clock()), [this]() { ba1Process(); });
+        m_echoMsgMap.clear();
+        moveToStep(kPhaseBA1, 0);
+        vote();
+        processCache(RoundInfo(m_blockNum, kPhaseBA1));
+    }
+
+    void SimNode::ba1Process() {
+        if (produceTentativeBlock()) {
+            return;
+        }
+        baxLoop();
+    }
+
+    // as Node::baxLoop, the echoes of the phase are kept as Scheduler::moveEchoMsg2AllPhaseMap does
+    void SimNode::baxLoop() {
+        phaseLoop(Node::getLeftTime(m_simulator.clock()), [this]() { baxProcess(); });
+        m_echoMsgAllPhase.insert(std::make_pair(RoundInfo(m_blockNum, m_phase + m_baxCount), std::move(m_echoMsgMap)));
+        m_echoMsgMap.clear();
+        moveToStep(kPhaseBAX, m_baxCount + 1);
+        vote();
+        processCache(RoundInfo(m_blockNum, m_phase + m_baxCount));
+    }
+
+    void SimNode::baxProcess() {
+        // fast into the baxCount of empty block voting
+        bool changePhase = Scheduler::isChangePhase(m_cacheEchoMsgMap, m_blockNum, getStakeVote()->getSendEchoThreshold());
+        if (Node::isSkipToEmptyBlockPhase(m_phase, m_baxCount, changePhase)) {
+            m_baxCount = Config::kMaxBaxCount - m_phase - 1;
+            baxLoop();
+            return;
+        }
+
+        // current phase first, then the former phases as Scheduler::produceBaxBlock
+        if (produceTentativeBlock()) {
+            return;
+        }
+        VoterSet voterSet = Scheduler::findBax2fEcho(m_echoMsgAllPhase, m_blockNum, m_phase + m_baxCount,
+                                                     m_emptyBlockId, m_proposerMsgMap);
+        if (!voterSet.empty()) {
+            decide(voterSet.commonEchoMsg.blockId, false);
+            return;
+        }
+
+        // the others are voting for a later block, take the block they decided as syncBlock would
+        BlockIdType blockId;
+        if (isNeedSync() && m_simulator.getDecidedBlock(m_blockNum, blockId)) {
+            decide(blockId, true);
+            return;
+        }
+        baxLoop();
+    }
+
+    // as Scheduler::isNeedSync
+    bool SimNode::isNeedSync() const {
+        return hasEchoesAhead(m_cacheEchoMsgMap, m_blockNum, THRESHOLD_SYNCING);
+    }
+
+    // as Scheduler::produceTentativeBlock
+    bool SimNode::produceTentativeBlock() {
+        BlockIdType blockId = Scheduler::findMin2fEcho(m_echoMsgMap, m_blockNum, m_phase + m_baxCount);
+        if (blockId == BlockIdType()) {
+            return false;
+        }
+        // 2f + 1 echoes without the propose, a real node would sync the block
+        decide(blockId, blockId != m_emptyBlockId && m_proposerMsgMap.find(blockId) == m_proposerMsgMap.end());
+        return true;
+    }
+
+    void SimNode::decide(const BlockIdType& blockId, bool sync) {
+        m_simulator.onDecide(m_index, m_blockNum, blockId, blockId == m_emptyBlockId, m_phase == kPhaseBAX, sync,
+                             m_simulator.now() - m_roundStartUs);
+        newRound(blockId);
+    }
+
+    // as Node::vote
+    void SimNode::vote() {
+        if (m_phase == kPhaseBA0) {
+            if (!MsgMgr::getInstance()->isProposer(m_blockNum)) {
+                return;
+            }
+            ProposeMsg propose;
+            propose.block.previous = m_previous;
+            propose.block.timestamp = chain::block_timestamp_type(m_blockNum);
+            propose.block.proposer = m_nodeInfo->getMyAccount();
+            propose.block.signature = std::string(Signer::sign<BlockHeader>(propose.block, m_nodeInfo->getPrivateKey()));
+            m_proposerMsgMap.insert(std::make_pair(propose.blockId(), propose));
+
+            SimMessage msg;
+            msg.propose = std::make_shared<ProposeMsg>(propose);
+            msg.size = fc::raw::pack_size(propose) + m_simulator.getConfig().blockBytes;
+            m_simulator.broadcast(m_index, msg, kPhaseBA0);
+
+            if (MsgMgr::getInstance()->isVoter(m_blockNum, kPhaseBA0, 0)) {
+                CommonEchoMsg common;
+                common.blockId = propose.blockId();
+                common.phase = kPhaseBA0;
+                common.baxCount = 0;
+                common.proposer = propose.block.proposer;
+                sendEcho(common);
+            }
+            return;
+        }
+
+        if (!MsgMgr::getInstance()->isVoter(m_blockNum, m_phase, m_baxCount)) {
+            return;
+        }
+        CommonEchoMsg common = Node::isEmptyBlockPhase(m_phase + m_baxCount) ? emptyEcho() : m_ba0Echo;
+        common.phase = m_phase;
+        common.baxCount = m_baxCount;
+        sendEcho(common);
+    }
+
+    // signed as MsgBuilder::constructMsg, kept as Scheduler::insert
+    void SimNode::sendEcho(const CommonEchoMsg& common) {
+        EchoMsg echo;
+        static_cast<CommonEchoMsg&>(echo) = common;
+        echo.account = m_nodeInfo->getMyAccount();
+        unsigned char sk[Bls::BLS_PRI_KEY_LENGTH];
+        m_nodeInfo->getMyBlsPrivateKey(sk, Bls::BLS_PRI_KEY_LENGTH);
+        echo.blsSignature = Signer::sign<CommonEchoMsg>(echo, sk);
+        echo.timestamp = Node::getRoundCount(m_simulator.clock());
+        echo.signature = std::string(Signer::sign<UnsignedEchoMsg>(echo, m_nodeInfo->getPrivateKey()));
+
+        VoterSet& voterSet = m_echoMsgMap[echo.blockId];
+        addVoter(voterSet, echo);
+        voterSet.hasSend = true;
+
+        SimMessage msg;
+        msg.echo = std::make_shared<EchoMsg>(echo);
+        msg.size = fc::raw::pack_size(echo);
+        m_simulator.broadcast(m_index, msg, echo.phase);
+    }
+
+    void SimNode::handleMessage(const SimMessage& msg) {
+        if (msg.propose) {
+            handlePropose(*msg.propose);
+        } else {
+            handleEcho(*msg.echo);
+        }
+    }
+
+    bool SimNode::handlePropose(const ProposeMsg& propose) {
+        // later blocks wait in the cache, the propose is obsolete after BA0 as in Scheduler::handleMessage
+        uint32_t blockNum = propose.block.block_num();
+        if (blockNum > m_blockNum) {
+            ProposeCacheSlot* slot = m_cacheProposeMsgMap.findOrClaim(RoundInfo(blockNum, kPhaseBA0));
+            if (slot && !slot->contains(propose.blockId())) {
+                slot->add(propose);
+            }
+            return true;
+        }
+        if (blockNum < m_blockNum || m_phase > kPhaseBA0) {
+            return false;
+        }
+
+        BlockIdType blockId = propose.blockId();
+        if (propose.block.previous != m_previous || m_proposerMsgMap.find(blockId) != m_proposerMsgMap.end()) {
+            return false;
+        }
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = getStakeVote();
+        if (!stakeVotePtr->isProposer(propose.block.proposer, false)) {
+            return false;
+        }
+        if (m_simulator.getConfig().verify
+            && !Validator::verifyDigest(Signature(propose.block.signature), propose.blockDigest(),
+                                        stakeVotePtr->getPublicKey(propose.block.proposer))) {
+            return false;
+        }
+        bool isMin = Scheduler::isMinPropose(propose, m_proposerMsgMap);
+        m_proposerMsgMap.insert(std::make_pair(blockId, propose));
+        if (isMin && MsgMgr::getInstance()->isVoter(m_blockNum, kPhaseBA0, 0)) {
+            CommonEchoMsg common;
+            common.blockId = blockId;
+            common.phase = kPhaseBA0;
+            common.baxCount = 0;
+            common.proposer = propose.block.proposer;
+            sendEcho(common);
+        }
+        return true;
+    }
+
+    // as Scheduler::handleMessage, later rounds wait in the cache and the former phases of the block
+    // are kept for Scheduler::findBax2fEcho as Scheduler::processBeforeMsg does
+    bool SimNode::handleEcho(const EchoMsg& echo) {
+        uint32_t blockNum = echo.blockNum();
+        uint32_t phaseCount = echo.phase + echo.baxCount;
+        if (blockNum > m_blockNum || (blockNum == m_blockNum && phaseCount > m_phase + m_baxCount)) {
+            EchoCacheSlot* slot = m_cacheEchoMsgMap.findOrClaim(RoundInfo(blockNum, phaseCount));
+            if (slot && !slot->contains(echo)) {
+                slot->add(echo);
+            }
+            return true;
+        }
+        if (blockNum < m_blockNum) {
+            return false;
+        }
+        if (phaseCount < m_phase + m_baxCount) {
+            if (echo.phase == kPhaseBA0) {
+                return false;
+            }
+            return addEcho(m_echoMsgAllPhase[RoundInfo(blockNum, phaseCount)], echo, false);
+        }
+        return addEcho(m_echoMsgMap, echo, true);
+    }
+
+    // as Scheduler::updateAndMayResponse
+    bool SimNode::addEcho(BlockIdVoterSetMap& voterSetMap, const EchoMsg& echo, bool response) {
+        auto itor = voterSetMap.find(echo.blockId);
+        if (itor != voterSetMap.end()
+            && std::find(itor->second.accountPool.begin(), itor->second.accountPool.end(), echo.account) != itor->second.accountPool.end()) {
+            return false;
+        }
+        if (!echo.valid()) {
+            return false;
+        }
+        std::shared_ptr<StakeVoteBase> stakeVotePtr = getStakeVote();
+        if (!stakeVotePtr->isVoter(echo.account, echo.phase, echo.baxCount, false)) {
+            return false;
+        }
+        if (m_simulator.getConfig().verify
+            && !Validator::verify<UnsignedEchoMsg>(Signature(echo.signature), echo, stakeVotePtr->getPublicKey(echo.account))) {
+            return false;
+        }
+        VoterSet& voterSet = voterSetMap[echo.blockId];
+        addVoter(voterSet, echo);
+
+        if (response && Scheduler::isResponseEcho(voterSet, voterSetMap, m_phase, stakeVotePtr->getSendEchoThreshold())
+            && MsgMgr::getInstance()->isVoter(m_blockNum, echo.phase, echo.baxCount)) {
+            voterSet.hasSend = true;
+            CommonEchoMsg common = voterSet.commonEchoMsg;
+            sendEcho(common);
+        }
+        return true;
+    }
+
+    bool SimNode::addVoter(VoterSet& voterSet, const EchoMsg& echo) {
+        if (std::find(voterSet.accountPool.begin(), voterSet.accountPool.end(), echo.account) != voterSet.accountPool.end()) {
+            return false;
+        }
+        if (voterSet.accountPool.empty()) {
+            voterSet.commonEchoMsg = echo;
+        }
+        voterSet.accountPool.push_back(echo.account);
+        voterSet.sigPool.push_back(echo.signature);
+        voterSet.timePool.push_back(echo.timestamp);
+        voterSet.blsSignPool.push_back(echo.blsSignature);
+        return true;
+    }
+
+    CommonEchoMsg SimNode::emptyEcho() const {
+        CommonEchoMsg common;
+        common.blockId = m_emptyBlockId;
+        common.phase = m_phase;
+        common.baxCount = m_baxCount;
+        common.proposer = N(utrio.empty);
+        return common;
+    }
+
+    ConsensusSimulator::ConsensusSimulator(const SimConfig& config) : m_config(config), m_rng(config.seed) {
+        static const char* kChars = "abcdefghijklmnopqrstuvwxyz";
+        Config::s_maxPhaseSeconds = m_config.phaseSeconds;
+        Config::s_maxTrxMicroSeconds = m_config.trxMs * 1000;
+        Genesis::s_time = fc::time_point();
+
+        // the account key is not used by the consensus messages, share one
+        std::string accountSk = std::string(fc::crypto::private_key::generate());
+        std::shared_ptr<CommitteeState> committeeStatePtr = std::make_shared<CommitteeState>();
+        committeeStatePtr->chainStateNormal = true;
+        for (int i = 0; i < m_config.nodeNumber; i++) {
+            std::string name = "sim";
+            int n = i;
+            do {
+                name += kChars[n % 26];
+                n /= 26;
+            } while (n > 0);
+            PrivateKey privateKey;
+            PublicKey publicKey;
+            PrivateKey::generate(publicKey, privateKey);
+            unsigned char blsSk[Bls::BLS_PRI_KEY_LENGTH];
+            unsigned char blsPk[Bls::BLS_PUB_KEY_COMPRESSED_LENGTH];
+            Bls::getDefault()->keygen(blsSk, Bls::BLS_PRI_KEY_LENGTH, blsPk, Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+
+            CommitteeInfo cinfo;
+            cinfo.accountName = name;
+            cinfo.pk = std::string(publicKey);
+            cinfo.blsPk = Hex::toHex<unsigned char>(blsPk, Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+            committeeStatePtr->cinfo.push_back(cinfo);
+
+            std::shared_ptr<NodeInfo> nodeInfo = std::make_shared<NodeInfo>();
+            nodeInfo->setCommitteeInfo(name, std::string(privateKey), Hex::toHex<unsigned char>(blsSk, Bls::BLS_PRI_KEY_LENGTH), accountSk);
+            m_nodes.emplace_back(new SimNode(*this, i, nodeInfo));
+        }
+        MsgMgr::getInstance()->setCommitteeState(committeeStatePtr, "ultrain" + std::to_string(m_config.seed));
+        m_uplinkFreeUs.resize(m_config.nodeNumber, 0);
+        m_finishedRounds.resize(m_config.nodeNumber, 0);
+    }
+
+    bool ConsensusSimulator::run() {
+        for (int i = 0; i < m_config.nodeNumber; i++) {
+            schedule(i, 0, [this, i]() { m_nodes[i]->start(); });
+        }
+        uint64_t maxUs = m_config.maxSimulatedMs * 1000;
+        while (!m_events.empty() && !finished()) {
+            Event event = m_events.top();
+            m_events.pop();
+            if (event.at > maxUs) {
+                return false;
+            }
+            m_nowUs = event.at;
+            event.f();
+        }
+        return finished();
+    }
+
+    bool ConsensusSimulator::finished() const {
+        for (auto rounds : m_finishedRounds) {
+            if (rounds < static_cast<uint32_t>(m_config.roundNumber)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const SimConfig& ConsensusSimulator::getConfig() const {
+        return m_config;
+    }
+
+    SimStats& ConsensusSimulator::getStats() {
+        return m_stats;
+    }
+
+    uint64_t ConsensusSimulator::now() const {
+        return m_nowUs;
+    }
+
+    fc::time_point ConsensusSimulator::clock() const {
+        return Genesis::s_time + fc::microseconds(m_nowUs);
+    }
+
+    void ConsensusSimulator::schedule(int index, uint64_t delayUs, std::function<void()> f) {
+        m_events.push(Event{m_nowUs + delayUs, m_seq++, [this, index, f]() { dispatch(index, f); }});
+    }
+
+    void ConsensusSimulator::dispatch(int index, const std::function<void()>& f) {
+        // MsgMgr and MsgBuilder act as the account of StakeVoteBase
+        StakeVoteBase::setNodeInfo(m_nodes[index]->getNodeInfo());
+        ConsensusPhase phase = m_nodes[index]->getPhase();
+        std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+        f();
+        m_stats.phase[phase].cpuNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - pointStart).count();
+    }
+
+    void ConsensusSimulator::broadcast(int from, const SimMessage& msg, ConsensusPhase phase) {
+        SimPhaseStats& stats = m_stats.phase[phase];
+        std::uniform_int_distribution<uint64_t> jitter(0, m_config.jitterMs * 1000ULL);
+        std::uniform_real_distribution<double> loss(0.0, 1.0);
+        uint64_t txUs = 0;
+        if (m_config.bandwidthKBps > 0) {
+            txUs = msg.size * 1000000ULL / (m_config.bandwidthKBps * 1024ULL);
+        }
+        // start from a random peer, or the last peers would always be served late by the uplink
+        int offset = std::uniform_int_distribution<int>(0, m_config.nodeNumber - 1)(m_rng);
+        for (int n = 0; n < m_config.nodeNumber; n++) {
+            int to = (offset + n) % m_config.nodeNumber;
+            if (to == from) {
+                continue;
+            }
+            stats.sent++;
+            stats.bytes += msg.size;
+            m_uplinkFreeUs[from] = std::max(m_uplinkFreeUs[from], m_nowUs) + txUs;
+            if (loss(m_rng) < m_config.lossRate) {
+                stats.dropped++;
+                continue;
+            }
+            stats.delivered++;
+            uint64_t delayUs = m_uplinkFreeUs[from] - m_nowUs + m_config.latencyMs * 1000ULL + jitter(m_rng);
+            schedule(to, delayUs, [this, to, msg]() { m_nodes[to]->handleMessage(msg); });
+        }
+    }
+
+    bool ConsensusSimulator::getDecidedBlock(uint32_t blockNum, BlockIdType& blockId) const {
+        auto itor = m_decided.find(blockNum);
+        if (itor == m_decided.end()) {
+            return false;
+        }
+        blockId = itor->second;
+        return true;
+    }
+
+    void ConsensusSimulator::onDecide(int index, uint32_t blockNum, const BlockIdType& blockId, bool empty, bool bax,
+                                      bool sync, uint64_t latencyUs) {
+        // block 2 is the first round
+        uint32_t round = blockNum - 1;
+        m_finishedRounds[index] = round;
+        if (round > static_cast<uint32_t>(m_config.roundNumber)) {
+            return;
+        }
+        m_stats.roundLatencyUs.push_back(latencyUs);
+        if (sync) {
+            m_stats.syncBlocks++;
+        }
+        auto itor = m_decided.find(blockNum);
+        if (itor != m_decided.end()) {
+            if (itor->second != blockId) {
+                m_stats.divergence++;
+            }
+            return;
+        }
+        m_decided.insert(std::make_pair(blockNum, blockId));
+        if (empty) {
+            m_stats.emptyBlocks++;
+        } else {
+            m_stats.normalBlocks++;
+        }
+        if (bax) {
+            m_stats.baxBlocks++;
+        }
+    }
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fc/time.hpp>
+
+#include <core/Message.h>
+#include <core/types.h>
+#include <rpos/NodeInfo.h>
+#include <rpos/RoundMsgCache.h>
+#include <rpos/StakeVoteBase.h>
+#include <rpos/VoterSet.h>
+
+namespace ultrainio {
+    // The simulator drives the real consensus code behind a simulated network and clock:
+    // - roles and thresholds come from MsgMgr and StakeVoteRandom, fed with a fixed committee and random
+    // - the BA and echo rules are the static ones of Scheduler (is2fEcho, isMinFEcho, isMinPropose, findMin2fEcho,
+    //   isResponseEcho, isChangePhase, isFastba0, findBax2fEcho) over the same message maps as Scheduler keeps
+    // - the phase rules and timers are the static ones of Node (isFastLoop, isEmptyBlockPhase, isSkipToEmptyBlockPhase,
+    //   getLeftTime, getRoundCount) at the simulated time
+    // - messages ahead of a node wait in a RoundMsgCache, isNeedSync is hasEchoesAhead as in Scheduler
+    // - every message is signed by the NodeInfo of its node and verified with the committee keys of StakeVoteBase
+    // The node identity of StakeVoteBase is switched before every event of a node. Node and Scheduler objects
+    // are not created, both are bound to the chain controller of chain_plugin, so SimNode keeps their per block
+    // state and steps through the phases as Node::ba0Loop / ba1Loop / baxLoop do, calling the rules above.
+    struct SimConfig {
+        int nodeNumber = 100;
+        int roundNumber = 10;
+        uint32_t latencyMs = 100;
+        uint32_t jitterMs = 50;
+        double lossRate = 0.0;
+        // uplink bandwidth of every node, 0 means unlimited
+        uint32_t bandwidthKBps = 0;
+        // transaction bytes counted for a proposed block
+        uint32_t blockBytes = 0;
+        // Config::s_maxPhaseSeconds
+        int phaseSeconds = 5;
+        // a non proposer leaves BA0 early when f + 1 BA1 echoes arrived, as Node::fastLoop does
+        bool fastPhase = true;
+        // Config::s_maxTrxMicroSeconds in ms
+        uint32_t trxMs = 2700;
+        bool verify = true;
+        uint32_t seed = 1;
+        uint64_t maxSimulatedMs = 3600 * 1000;
+    };
+
+    struct SimMessage {
+        std::shared_ptr<const ProposeMsg> propose;
+        std::shared_ptr<const EchoMsg> echo;
+        size_t size = 0;
+    };
+
+    struct SimPhaseStats {
+        uint64_t sent = 0;
+        uint64_t delivered = 0;
+        uint64_t dropped = 0;
+        uint64_t bytes = 0;
+        uint64_t cpuNs = 0;
+    };
+
+    struct SimStats {
+        // indexed by kPhaseBA0, kPhaseBA1, kPhaseBAX
+        std::array<SimPhaseStats, 4> phase;
+        // from the start of a round to its block at every node, in microseconds
+        std::vector<uint64_t> roundLatencyUs;
+        uint32_t normalBlocks = 0;
+        uint32_t emptyBlocks = 0;
+        uint32_t baxBlocks = 0;
+        // blocks a node did not decide by itself, a real node would sync them
+        uint32_t syncBlocks = 0;
+        uint32_t divergence = 0;
+    };
+
+    class ConsensusSimulator;
+
+    class SimNode {
+    public:
+        SimNode(ConsensusSimulator& simulator, int index, std::shared_ptr<NodeInfo> nodeInfo);
+
+        void start();
+
+        void handleMessage(const SimMessage& msg);
+
+        ConsensusPhase getPhase() const;
+
+        uint32_t getBlockNum() const;
+
+        std::shared_ptr<NodeInfo> getNodeInfo() const;
+
+    private:
+        void newRound(const BlockIdType& previous);
+
+        void ba0Process();
+
+        void ba1Process();
+
+        void baxProcess();
+
+        void baxLoop();
+
+        bool isNeedSync() const;
+
+        void fastProcess();
+
+        void phaseLoop(uint32_t timeoutMs, std::function<void()> process);
+
+        void moveToStep(ConsensusPhase phase, uint32_t baxCount);
+
+        void vote();
+
+        // returns false if no block is decided, blank in Scheduler::produceTentativeBlock
+        bool produceTentativeBlock();
+
+        void decide(const BlockIdType& blockId, bool sync);
+
+        void processCache(const RoundInfo& info);
+
+        bool handlePropose(const ProposeMsg& propose);
+
+        bool handleEcho(const EchoMsg& echo);
+
+        bool addEcho(BlockIdVoterSetMap& voterSetMap, const EchoMsg& echo, bool response);
+
+        void sendEcho(const CommonEchoMsg& common);
+
+        // as Scheduler::insert and Scheduler::updateAndMayResponse, false if the account has voted
+        static bool addVoter(VoterSet& voterSet, const EchoMsg& echo);
+
+        std::shared_ptr<StakeVoteBase> getStakeVote() const;
+
+        CommonEchoMsg emptyEcho() const;
+
+        ConsensusSimulator& m_simulator;
+        int m_index;
+        std::shared_ptr<NodeInfo> m_nodeInfo;
+
+        uint32_t m_blockNum = 0;
+        BlockIdType m_previous;
+        BlockIdType m_emptyBlockId;
+        ConsensusPhase m_phase = kPhaseInit;
+        uint32_t m_baxCount = 0;
+        uint64_t m_roundStartUs = 0;
+        uint64_t m_timerSeq = 0;
+
+        std::map<BlockIdType, ProposeMsg> m_proposerMsgMap;
+        // echoes of the current phase and of the former phases of the block, as in Scheduler
+        BlockIdVoterSetMap m_echoMsgMap;
+        std::map<RoundInfo, BlockIdVoterSetMap> m_echoMsgAllPhase;
+        CommonEchoMsg m_ba0Echo;
+        RoundMsgCache<ProposeCacheSlot, 1> m_cacheProposeMsgMap;
+        RoundMsgCache<EchoCacheSlot, 64> m_cacheEchoMsgMap;
+    };
+
+    class ConsensusSimulator {
+    public:
+        explicit ConsensusSimulator(const SimConfig& config);
+
+        // returns false if the simulated time limit is reached before every node finishes the rounds
+        bool run();
+
+        const SimConfig& getConfig() const;
+
+        SimStats& getStats();
+
+        // simulated time in microseconds since the genesis time
+        uint64_t now() const;
+
+        // the simulated clock as seen by Node
+        fc::time_point clock() const;
+
+        void schedule(int index, uint64_t delayUs, std::function<void()> f);
+
+        void broadcast(int from, const SimMessage& msg, ConsensusPhase phase);
+
+        bool getDecidedBlock(uint32_t blockNum, BlockIdType& blockId) const;
+
+        void onDecide(int index, uint32_t blockNum, const BlockIdType& blockId, bool empty, bool bax, bool sync,
+                      uint64_t latencyUs);
+
+    private:
+        struct Event {
+            uint64_t at;
+            uint64_t seq;
+            std::function<void()> f;
+
+            bool operator > (const Event& rhs) const {
+                return at > rhs.at || (at == rhs.at && seq > rhs.seq);
+            }
+        };
+
+        void dispatch(int index, const std::function<void()>& f);
+
+        bool finished() const;
+
+        SimConfig m_config;
+        SimStats m_stats;
+        std::vector<std::unique_ptr<SimNode>> m_nodes;
+        std::vector<uint64_t> m_uplinkFreeUs;
+        std::vector<uint32_t> m_finishedRounds;
+        std::map<uint32_t, BlockIdType> m_decided;
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> m_events;
+        std::mt19937_64 m_rng;
+        uint64_t m_nowUs = 0;
+        uint64_t m_seq = 0;
+    };
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+#include <fc/log/logger.hpp>
+
+#include "ConsensusSimulator.h"
+
+using namespace ultrainio;
+using namespace std;
+
+namespace bpo = boost::program_options;
+
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+// run N committee members in one process over a simulated network and report
+// round latency, message count, cpu per phase and empty block rate
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    bpo::options_description options("consensus simulator options");
+    options.add_options()
+            ("help,h", "print this help")
+            ("nodes,n", bpo::value<int>(&config.nodeNumber)->default_value(config.nodeNumber), "committee members")
+            ("rounds,r", bpo::value<int>(&config.roundNumber)->default_value(config.roundNumber), "blocks to produce")
+            ("latency-ms", bpo::value<uint32_t>(&config.latencyMs)->default_value(config.latencyMs), "one way latency")
+            ("jitter-ms", bpo::value<uint32_t>(&config.jitterMs)->default_value(config.jitterMs), "max random latency added to every message")
+            ("loss", bpo::value<double>(&config.lossRate)->default_value(config.lossRate), "message loss rate")
+            ("bandwidth-kbps", bpo::value<uint32_t>(&config.bandwidthKBps)->default_value(config.bandwidthKBps), "uplink KB/s of every node, 0 for unlimited")
+            ("block-bytes", bpo::value<uint32_t>(&config.blockBytes)->default_value(config.blockBytes), "transaction bytes of a proposed block")
+            ("phase-seconds", bpo::value<int>(&config.phaseSeconds)->default_value(config.phaseSeconds), "phase length, max-phase-seconds of producer_rpos_plugin")
+            ("trx-ms", bpo::value<uint32_t>(&config.trxMs)->default_value(config.trxMs), "trx deadline used by the fast BA0 check, max-trxs-microseconds of producer_rpos_plugin")
+            ("fast", bpo::value<bool>(&config.fastPhase)->default_value(config.fastPhase), "leave BA0 early on f + 1 BA1 echoes")
+            ("verify", bpo::value<bool>(&config.verify)->default_value(config.verify), "verify the signature of every received message")
+            ("seed", bpo::value<uint32_t>(&config.seed)->default_value(config.seed), "random seed")
+            ("max-simulated-ms", bpo::value<uint64_t>(&config.maxSimulatedMs)->default_value(config.maxSimulatedMs), "simulated time limit");
+    bpo::variables_map vm;
+    try {
+        bpo::store(bpo::parse_command_line(argc, argv, options), vm);
+        bpo::notify(vm);
+    } catch (const std::exception& e) {
+        cout << e.what() << std::endl << options << std::endl;
+        return 1;
+    }
+    if (vm.count("help") || config.nodeNumber <= 0 || config.roundNumber <= 0 || config.phaseSeconds <= 0) {
+        cout << options << std::endl;
+        return 0;
+    }
+    fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::warn);
+
+    std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+    ConsensusSimulator simulator(config);
+    bool finished = simulator.run();
+    std::chrono::milliseconds d = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - pointStart);
+
+    SimStats& stats = simulator.getStats();
+    std::vector<uint64_t> latency = stats.roundLatencyUs;
+    std::sort(latency.begin(), latency.end());
+    uint64_t total = 0;
+    for (auto l : latency) {
+        total += l;
+    }
+    uint32_t blocks = stats.normalBlocks + stats.emptyBlocks;
+
+    cout << "nodes : " << config.nodeNumber << " rounds : " << config.roundNumber
+         << (finished ? "" : " (simulated time limit reached)") << std::endl;
+    cout << "simulated time : " << simulator.now() / 1000 << " ms, wall time : " << d.count() << " ms" << std::endl;
+    if (!latency.empty()) {
+        cout << "round latency avg : " << total / latency.size() / 1000
+             << " ms p50 : " << percentile(latency, 0.5) / 1000
+             << " ms p99 : " << percentile(latency, 0.99) / 1000
+             << " ms max : " << latency.back() / 1000 << " ms" << std::endl;
+    }
+    cout << "blocks : " << blocks << " empty : " << stats.emptyBlocks << " bax : " << stats.baxBlocks
+         << " synced : " << stats.syncBlocks << " divergence : " << stats.divergence << std::endl;
+    if (blocks > 0) {
+        cout << "empty block rate : " << 100.0 * stats.emptyBlocks / blocks << " %" << std::endl;
+    }
+    const char* names[] = {"init", "ba0", "ba1", "bax"};
+    for (int phase = kPhaseBA0; phase <= kPhaseBAX; phase++) {
+        const SimPhaseStats& p = stats.phase[phase];
+        cout << names[phase] << " sent : " << p.sent << " delivered : " << p.delivered << " dropped : " << p.dropped
+             << " bytes : " << p.bytes << " cpu : " << p.cpuNs / 1000000 << " ms";
+        if (blocks > 0) {
+            cout << " cpu per node per round : " << p.cpuNs / 1000 / blocks / config.nodeNumber << " us";
+        }
+        cout << std::endl;
+    }
+    return finished ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include <rpos/RoleRandom.h>
+#include <rpos/RoleSelection.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace ultrainio;
+
+// usage : roleselection_performance_test <committee size> <rounds>
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "argument count < 3" << std::endl;
+        return 0;
+    }
+    int size = atoi(argv[1]);
+    int n = atoi(argv[2]);
+    if (size <= 0 || n <= 0) {
+        std::cout << "committee size and rounds should be positive" << std::endl;
+        return 0;
+    }
+    std::vector<std::string> committeeV;
+    for (int i = 0; i < size; i++) {
+        committeeV.push_back("user" + std::to_string(i));
+    }
+    fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::warn);
+
+    std::vector<std::shared_ptr<RoleSelection>> selections;
+    selections.reserve(n);
+    std::chrono::steady_clock::time_point pointStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        RoleRandom rand(fc::sha256::hash(std::to_string(i)), i + 1);
+        selections.push_back(std::make_shared<RoleSelection>(committeeV, rand));
+    }
+    std::chrono::microseconds d = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart);
+    std::cout << "selection each one consume : " << d.count() / n << " microseconds " << std::endl;
+
+    int voters = 0;
+    pointStart = std::chrono::steady_clock::now();
+    for (auto& selection : selections) {
+        for (int i = 0; i < size; i++) {
+            voters += selection->isVoter(committeeV[i]);
+        }
+    }
+    d = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart);
+    std::cout << "account checks per second : " << (d.count() > 0 ? uint64_t(size) * n * 1000000 / d.count() : 0) << std::endl;
+
+    pointStart = std::chrono::steady_clock::now();
+    for (auto& selection : selections) {
+        for (int i = 0; i < size; i++) {
+            voters += selection->isVoter(i);
+        }
+    }
+    d = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pointStart);
+    std::cout << "index checks per second : " << (d.count() > 0 ? uint64_t(size) * n * 1000000 / d.count() : 0) << std::endl;
+    std::cout << "voters : " << voters / 2 << std::endl;
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
+#include <fc/io/json.hpp>
+#include <fc/log/binary_appender.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/variant.hpp>
+#include <fc/reflect/variant.hpp>
+
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace po = boost::program_options;
+
+// decode the files written by the binary log appender into the console_appender layout
+int main(int argc, const char **argv) {
+    try {
+        po::options_description desc("Convert binary log to text");
+        desc.add_options()
+            ("help,h", "Print this help message and exit")
+            ("in,i", po::value<string>(), "Pathname of the binary log file")
+            ("out,o", po::value<string>(), "Pathname of the output text file, stdout if not set")
+            ("level,l", po::value<string>()->default_value("all"), "Minimum log level to output: all, debug, info, warn, error")
+            ("json,j", "output one json record per line")
+            ;
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+
+        string in_file;
+        if(vm.count("in")) {
+            in_file = vm.at("in").as<string>();
+        }
+        if( vm.count("help") || !in_file.size() ) {
+            std::cout << desc << std::endl;
+            return 1;
+        }
+        if(!fc::exists(in_file)) {
+            cout << "Input file does not exists: " << in_file << endl;
+            return 1;
+        }
+        fc::log_level min_level = fc::variant(vm.at("level").as<string>()).as<fc::log_level>();
+        bool json = vm.count("json") > 0;
+
+        std::ofstream ofs;
+        if(vm.count("out")) {
+            ofs.open(vm.at("out").as<string>());
+        }
+        std::ostream& out = ofs.is_open() ? ofs : std::cout;
+
+        std::ifstream ifs(in_file, (std::ios::in | std::ios::binary));
+        uint64_t count = 0;
+        while (true) {
+            uint32_t size = 0;
+            ifs.read((char*)&size, sizeof(size));
+            if (!ifs.good()) {
+                break;
+            }
+            std::vector<char> data(size);
+            ifs.read(data.data(), size);
+            if (!ifs.good()) {
+                cerr << "truncated record at the end of " << in_file << endl;
+                break;
+            }
+            fc::binary_log_record r = fc::raw::unpack<fc::binary_log_record>(data);
+            count++;
+            if (r.level < int(min_level)) {
+                continue;
+            }
+            if (json) {
+                fc::mutable_variant_object mvo;
+                mvo("timestamp", r.timestamp)("level", fc::log_level(r.level))("file", r.file)("line", r.line)
+                   ("method", r.method)("thread_name", r.thread_name)("message", fc::format_string(r.format, r.args))
+                   ("data", r.args);
+                out << fc::json::to_string(mvo) << "\n";
+            } else {
+                out << r.to_string() << "\n";
+            }
+        }
+        cerr << count << " records decoded" << endl;
+    } catch( const fc::exception& e ) {
+        cerr << e.to_detail_string() << endl;
+        return 1;
+    } catch( const std::exception& e ) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
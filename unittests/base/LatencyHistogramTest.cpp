@@ -0,0 +1,86 @@
+#define BOOST_TEST_MODULE latency_histogram_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <base/LatencyHistogram.h>
+
+using namespace ultrainio;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(latency_histogram_test_suite)
+    BOOST_AUTO_TEST_CASE(bucket) {
+        for (uint64_t v = 0; v < 100000; v++) {
+            int index = LatencyHistogram::bucketOf(v);
+            BOOST_CHECK(v <= LatencyHistogram::bucketUpperBound(index));
+            if (index > 0) {
+                BOOST_CHECK(v > LatencyHistogram::bucketUpperBound(index - 1));
+            }
+        }
+        BOOST_CHECK(LatencyHistogram::bucketOf(uint64_t(-1)) == LatencyHistogram::kBucketNumber - 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(percentile) {
+        LatencyHistogram h("test_us", "");
+        BOOST_CHECK(h.percentile(0.5) == 0);
+        for (uint64_t v = 1; v <= 1000; v++) {
+            h.record(v);
+        }
+        BOOST_CHECK(h.count() == 1000);
+        BOOST_CHECK(h.sum() == 500500);
+        BOOST_CHECK(h.max() == 1000);
+        // every bucket is at most 1 / 8 wide
+        uint64_t p50 = h.percentile(0.5);
+        BOOST_CHECK(p50 >= 500 && p50 <= 500 + 500 / 8);
+        uint64_t p99 = h.percentile(0.99);
+        BOOST_CHECK(p99 >= 990 && p99 <= 1000);
+        BOOST_CHECK(h.percentile(1.0) == 1000);
+        h.reset();
+        BOOST_CHECK(h.count() == 0);
+        BOOST_CHECK(h.percentile(0.5) == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(concurrent) {
+        LatencyHistogram h("test_us", "");
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++) {
+            threads.emplace_back([&h]() {
+                for (uint64_t v = 0; v < 10000; v++) {
+                    h.record(v);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        BOOST_CHECK(h.count() == 40000);
+        BOOST_CHECK(h.max() == 9999);
+    }
+
+    BOOST_AUTO_TEST_CASE(prometheus) {
+        LatencyRegistry& registry = LatencyRegistry::getInstance();
+        LatencyHistogram& a = registry.get("test_phase_us", "phase=\"ba0\"", "time of a phase");
+        LatencyHistogram& b = registry.get("test_phase_us", "phase=\"ba1\"");
+        BOOST_CHECK(&a == &registry.get("test_phase_us", "phase=\"ba0\""));
+        a.record(100);
+        a.record(200);
+        b.record(1 << 20);
+
+        std::string text = registry.toPrometheus();
+        BOOST_CHECK(text.find("# HELP test_phase_us time of a phase\n") != std::string::npos);
+        BOOST_CHECK(text.find("# TYPE test_phase_us histogram\n") == text.rfind("# TYPE test_phase_us histogram\n"));
+        BOOST_CHECK(text.find("test_phase_us_bucket{phase=\"ba0\",le=\"127\"} 1\n") != std::string::npos);
+        BOOST_CHECK(text.find("test_phase_us_bucket{phase=\"ba0\",le=\"255\"} 2\n") != std::string::npos);
+        BOOST_CHECK(text.find("test_phase_us_bucket{phase=\"ba1\",le=\"+Inf\"} 1\n") != std::string::npos);
+        BOOST_CHECK(text.find("test_phase_us_sum{phase=\"ba0\"} 300\n") != std::string::npos);
+        BOOST_CHECK(text.find("test_phase_us_count{phase=\"ba1\"} 1\n") != std::string::npos);
+
+        std::vector<LatencySummary> summaries = registry.summaries();
+        BOOST_CHECK(summaries.size() == 2);
+        BOOST_CHECK(summaries[0].labels == "phase=\"ba0\"" && summaries[0].count == 2);
+        BOOST_CHECK(summaries[1].p50Us == (1 << 20));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,257 @@
+#define BOOST_TEST_MODULE merkletreecache_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <random>
+
+#include <ultrainio/chain/merkle_tree_cache.hpp>
+
+using namespace ultrainio::chain;
+using namespace std;
+
+namespace {
+    // a block of n receipts, salt makes the trx ids and the block id differ between forks
+    signed_block_ptr makeBlock(uint32_t n, uint16_t salt = 0) {
+        auto block = std::make_shared<signed_block>();
+        block->version = salt;
+        for (uint32_t i = 0; i < n; i++) {
+            signed_transaction trx;
+            trx.ref_block_num = salt;
+            trx.ref_block_prefix = i;
+            block->transactions.emplace_back(packed_transaction(trx));
+        }
+        vector<digest_type> leaves;
+        for (const auto& r : block->transactions) {
+            leaves.push_back(r.digest());
+        }
+        block->transaction_mroot = merkle(leaves);
+        return block;
+    }
+
+    digest_type trxIdAt(const signed_block_ptr& block, uint32_t pos) {
+        return block->transactions[pos].trx.get<packed_transaction>().id();
+    }
+
+    // the proof built by controller::merkle_proof_of before the trees were cached
+    vector<digest_type> legacyProofOf(const signed_block_ptr& block, uint32_t pos) {
+        vector<digest_type> proof;
+        vector<digest_type> digests;
+        for (const auto& r : block->transactions) {
+            digests.push_back(r.digest());
+        }
+        proof.push_back(pos % 2 == 0 ? make_canonical_left(digest_type()) : make_canonical_right(digest_type()));
+        while (digests.size() > 1) {
+            if (digests.size() % 2) {
+                digests.push_back(digests.back());
+            }
+            proof.push_back(pos % 2 != 0 ? make_canonical_left(digests[pos - 1]) : make_canonical_right(digests[pos + 1]));
+            pos /= 2;
+            for (size_t i = 0; i < digests.size() / 2; i++) {
+                digests[i] = digest_type::hash(make_canonical_pair(digests[2 * i], digests[2 * i + 1]));
+            }
+            digests.resize(digests.size() / 2);
+        }
+        return proof;
+    }
+
+    // same walk as controller::verify_merkle_proof
+    bool verifyProof(const vector<digest_type>& proof, const digest_type& root, const digest_type& leaf) {
+        if (proof.empty()) {
+            return false;
+        }
+        if (proof.size() == 1) {
+            return leaf == root;
+        }
+        digest_type left, right;
+        if (is_canonical_left(proof[0]) && is_canonical_right(proof[1])) {
+            left = make_canonical_left(leaf);
+            right = proof[1];
+        } else if (is_canonical_left(proof[1]) && is_canonical_right(proof[0])) {
+            left = proof[1];
+            right = make_canonical_right(leaf);
+        } else {
+            return false;
+        }
+        digest_type node = digest_type::hash(make_canonical_pair(left, right));
+        for (size_t i = 2; i < proof.size(); i++) {
+            if (is_canonical_left(proof[i])) {
+                node = digest_type::hash(make_canonical_pair(proof[i], make_canonical_right(node)));
+            } else {
+                node = digest_type::hash(make_canonical_pair(make_canonical_left(node), proof[i]));
+            }
+        }
+        return node == root;
+    }
+
+    vector<digest_type> leavesAt(const receipt_merkle_tree& tree, const vector<uint32_t>& positions) {
+        vector<digest_type> leaves;
+        for (auto pos : positions) {
+            leaves.push_back(tree.leaf(pos));
+        }
+        return leaves;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(merkletreecache_test_suite)
+    BOOST_AUTO_TEST_CASE(proofOfMatchesLegacy) {
+        for (uint32_t n = 1; n <= 17; n++) {
+            auto block = makeBlock(n);
+            receipt_merkle_tree tree(block);
+            BOOST_CHECK(tree.root() == block->transaction_mroot);
+            for (uint32_t pos = 0; pos < n; pos++) {
+                BOOST_CHECK(tree.position_of(trxIdAt(block, pos)) == pos);
+                vector<digest_type> proof = tree.proof_of(pos);
+                BOOST_CHECK(proof == legacyProofOf(block, pos));
+                BOOST_CHECK(verifyProof(proof, block->transaction_mroot, tree.leaf(pos)));
+            }
+            BOOST_CHECK(tree.proof_of(n).empty());
+            BOOST_CHECK(tree.position_of(digest_type::hash(n)) == -1);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(multiProofRoundTrip) {
+        std::mt19937 rng(43);
+        for (uint32_t n : {1, 2, 3, 5, 7, 9, 11, 13, 17, 31}) {
+            auto block = makeBlock(n);
+            receipt_merkle_tree tree(block);
+            vector<vector<uint32_t>> subsets = {{0}, {n - 1}, {0, n - 1}};
+            vector<uint32_t> all, evens;
+            for (uint32_t i = 0; i < n; i++) {
+                all.push_back(i);
+                if (i % 2 == 0) evens.push_back(i);
+            }
+            subsets.push_back(all);
+            subsets.push_back(evens);
+            for (int k = 0; k < 8; k++) {
+                vector<uint32_t> s;
+                for (uint32_t i = 0; i < n; i++) {
+                    if (rng() % 3 == 0) s.push_back(i);
+                }
+                if (!s.empty()) subsets.push_back(s);
+            }
+            for (auto positions : subsets) {
+                // unsorted, duplicated and out of range positions are normalized
+                vector<uint32_t> request = positions;
+                request.push_back(positions.front());
+                request.push_back(n + 1);
+                std::reverse(request.begin(), request.end());
+                merkle_multi_proof proof = tree.multi_proof_of(request);
+                BOOST_CHECK(proof.positions == positions);
+                BOOST_CHECK(proof.leaf_count == n);
+                BOOST_CHECK(merkle_multi_proof_root(proof, leavesAt(tree, positions)) == block->transaction_mroot);
+                // every needed sibling is sent at most once
+                BOOST_CHECK(proof.nodes.size() <= positions.size() * tree.proof_of(positions.front()).size());
+            }
+            BOOST_CHECK(tree.multi_proof_of(all).nodes.empty());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(tamperedProofs) {
+        auto block = makeBlock(13);
+        receipt_merkle_tree tree(block);
+        const digest_type& root = block->transaction_mroot;
+
+        vector<digest_type> single = tree.proof_of(6);
+        for (size_t i = 1; i < single.size(); i++) {
+            vector<digest_type> bad = single;
+            bad[i] = is_canonical_left(bad[i]) ? make_canonical_left(digest_type::hash(i)) : make_canonical_right(digest_type::hash(i));
+            BOOST_CHECK(!verifyProof(bad, root, tree.leaf(6)));
+        }
+        BOOST_CHECK(!verifyProof(single, root, tree.leaf(7)));
+
+        vector<uint32_t> positions = {1, 4, 5, 12};
+        merkle_multi_proof proof = tree.multi_proof_of(positions);
+        vector<digest_type> leaves = leavesAt(tree, positions);
+        BOOST_REQUIRE(merkle_multi_proof_root(proof, leaves) == root);
+        BOOST_REQUIRE(!proof.nodes.empty());
+
+        for (size_t i = 0; i < proof.nodes.size(); i++) {
+            merkle_multi_proof bad = proof;
+            bad.nodes[i] = digest_type::hash(i);
+            BOOST_CHECK(merkle_multi_proof_root(bad, leaves) != root);
+        }
+        vector<digest_type> badLeaves = leaves;
+        badLeaves[2] = tree.leaf(6);
+        BOOST_CHECK(merkle_multi_proof_root(proof, badLeaves) != root);
+
+        merkle_multi_proof bad = proof;
+        bad.nodes.push_back(digest_type());
+        BOOST_CHECK(merkle_multi_proof_root(bad, leaves) == digest_type());
+        bad = proof;
+        bad.nodes.pop_back();
+        BOOST_CHECK(merkle_multi_proof_root(bad, leaves) == digest_type());
+        bad = proof;
+        std::swap(bad.positions[0], bad.positions[1]);
+        BOOST_CHECK(merkle_multi_proof_root(bad, leaves) == digest_type());
+        bad = proof;
+        bad.positions.back() = bad.leaf_count;
+        BOOST_CHECK(merkle_multi_proof_root(bad, leaves) == digest_type());
+        bad = proof;
+        bad.leaf_count = 16;
+        BOOST_CHECK(merkle_multi_proof_root(bad, leaves) != root);
+        bad = proof;
+        bad.positions.pop_back();
+        BOOST_CHECK(merkle_multi_proof_root(bad, leaves) == digest_type());
+        BOOST_CHECK(merkle_multi_proof_root(merkle_multi_proof(), vector<digest_type>()) == digest_type());
+    }
+
+    BOOST_AUTO_TEST_CASE(lruEviction) {
+        merkle_tree_cache cache(2);
+        auto b1 = makeBlock(3, 1);
+        auto b2 = makeBlock(4, 2);
+        auto b3 = makeBlock(5, 3);
+        cache.put(1, b1, true);
+        cache.put(2, b2, true);
+        BOOST_CHECK(cache.get(1, b1->id()));
+        // 2 is now the least recently used one
+        cache.put(3, b3, true);
+        BOOST_CHECK(cache.size() == 2);
+        BOOST_CHECK(!cache.get_irreversible(2));
+        BOOST_CHECK(cache.get_irreversible(1));
+        BOOST_CHECK(cache.get_irreversible(3));
+
+        cache.set_capacity(1);
+        BOOST_CHECK(cache.size() == 1);
+        BOOST_CHECK(cache.get_irreversible(3));
+        BOOST_CHECK(!cache.get_irreversible(1));
+
+        cache.set_capacity(0);
+        BOOST_CHECK(cache.size() == 0);
+        auto tree = cache.put(4, b1, true);
+        BOOST_CHECK(tree && tree->root() == b1->transaction_mroot);
+        BOOST_CHECK(cache.size() == 0);
+
+        cache.set_capacity(4);
+        cache.put(1, b1, true);
+        cache.clear();
+        BOOST_CHECK(cache.size() == 0);
+        BOOST_CHECK(!cache.get_irreversible(1));
+    }
+
+    BOOST_AUTO_TEST_CASE(forkInvalidation) {
+        merkle_tree_cache cache(8);
+        auto a = makeBlock(6, 1);
+        auto b = makeBlock(6, 2);
+        BOOST_REQUIRE(a->id() != b->id());
+
+        cache.put(5, a, false);
+        BOOST_CHECK(cache.get(5, a->id()));
+        BOOST_CHECK(!cache.get(5, b->id()));
+        // a reversible tree is never served without its block id
+        BOOST_CHECK(!cache.get_irreversible(5));
+
+        // the fork switched to b, the tree of a is replaced
+        cache.put(5, b, false);
+        BOOST_CHECK(cache.size() == 1);
+        BOOST_CHECK(!cache.get(5, a->id()));
+        auto tree = cache.get(5, b->id());
+        BOOST_REQUIRE(tree);
+        BOOST_CHECK(tree->root() == b->transaction_mroot);
+        BOOST_CHECK(tree->position_of(trxIdAt(a, 0)) == -1);
+
+        cache.put(5, b, true);
+        BOOST_CHECK(cache.get_irreversible(5));
+        BOOST_CHECK(cache.get(5, b->id()));
+        BOOST_CHECK(!cache.get(5, a->id()));
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+#define BOOST_TEST_MODULE pendingtransactionpool_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include <ultrainio/chain/pending_transaction_pool.hpp>
+
+using namespace ultrainio::chain;
+using namespace std;
+
+namespace {
+    const fc::time_point_sec kNow(1000000);
+
+    // nonce makes the signed ids differ, expiration is in seconds from kNow
+    transaction_metadata_ptr makeTrx(account_name account, uint32_t nonce, int expiration = 60) {
+        signed_transaction trx;
+        action act;
+        act.account = N(ultrainio);
+        act.name = N(nonce);
+        act.authorization.push_back(permission_level{account, config::active_name});
+        trx.actions.push_back(act);
+        trx.ref_block_prefix = nonce;
+        trx.expiration = kNow + expiration;
+        return std::make_shared<transaction_metadata>(trx);
+    }
+
+    vector<uint32_t> nonces(pending_transaction_pool& pool) {
+        vector<uint32_t> v;
+        while (!pool.empty()) {
+            v.push_back(pool.front()->trx.ref_block_prefix);
+            pool.pop_front();
+        }
+        return v;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(pendingtransactionpool_test_suite)
+    BOOST_AUTO_TEST_CASE(arrivalOrder) {
+        pending_transaction_pool pool(100, 0);
+        BOOST_CHECK(!pool.front());
+        // expiration does not change the order a block is built in
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 1, 300)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(userb), 2, 30)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 3, 120)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 1, 300)) == pending_transaction_pool::push_result::duplicate);
+        BOOST_CHECK(pool.size() == 3);
+        BOOST_CHECK(nonces(pool) == vector<uint32_t>({1, 2, 3}));
+        BOOST_CHECK(pool.count_of(N(usera)) == 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(limits) {
+        pending_transaction_pool pool(5, 2);
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 1)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 2)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 3)) == pending_transaction_pool::push_result::account_quota_exceeded);
+        BOOST_CHECK(pool.count_of(N(usera)) == 2);
+
+        // every way out of the pool returns the quota
+        pool.pop_front();
+        BOOST_CHECK(pool.count_of(N(usera)) == 1);
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 3)) == pending_transaction_pool::push_result::accepted);
+        pool.drop_front();
+        BOOST_CHECK(pool.erase(makeTrx(N(usera), 3)->signed_id));
+        BOOST_CHECK(!pool.erase(makeTrx(N(usera), 3)->signed_id));
+        BOOST_CHECK(pool.count_of(N(usera)) == 0);
+
+        BOOST_CHECK(pool.push(makeTrx(N(usera), 4)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(userb), 5)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(userb), 6)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(userc), 7)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(userc), 8)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.push(makeTrx(N(userd), 9)) == pending_transaction_pool::push_result::pool_full);
+        BOOST_CHECK(pool.count_of(N(userd)) == 0);
+
+        pool.clear();
+        BOOST_CHECK(pool.empty());
+        BOOST_CHECK(pool.count_of(N(userb)) == 0);
+        BOOST_CHECK(pool.push(makeTrx(N(userb), 10)) == pending_transaction_pool::push_result::accepted);
+        BOOST_CHECK(pool.count_of(N(userb)) == 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(expiry) {
+        pending_transaction_pool pool(100, 3);
+        vector<uint32_t> dropped;
+        pool.set_drop_handler([&dropped](const transaction_metadata_ptr& trx) {
+            dropped.push_back(trx->trx.ref_block_prefix);
+        });
+        pool.push(makeTrx(N(usera), 1, 60));
+        pool.push(makeTrx(N(usera), 2, 10));
+        pool.push(makeTrx(N(userb), 3, 30));
+        pool.push(makeTrx(N(usera), 4, 90));
+
+        vector<uint32_t> removed;
+        size_t n = pool.remove_expired(fc::time_point(kNow + 45), [&removed](const transaction_metadata_ptr& trx) {
+            removed.push_back(trx->trx.ref_block_prefix);
+        });
+        // oldest expiration first, the drop handler runs for every removed one
+        BOOST_CHECK(n == 2);
+        BOOST_CHECK(removed == vector<uint32_t>({2, 3}));
+        BOOST_CHECK(dropped == removed);
+        BOOST_CHECK(pool.count_of(N(usera)) == 2);
+        BOOST_CHECK(pool.count_of(N(userb)) == 0);
+        BOOST_CHECK(!pool.contains(makeTrx(N(usera), 2, 10)->signed_id));
+
+        // a transaction expiring exactly now is still valid
+        BOOST_CHECK(pool.remove_expired(fc::time_point(kNow + 60)) == 0);
+        BOOST_CHECK(nonces(pool) == vector<uint32_t>({1, 4}));
+    }
+
+    BOOST_AUTO_TEST_CASE(removal) {
+        pending_transaction_pool pool(100, 0);
+        vector<uint32_t> dropped;
+        pool.set_drop_handler([&dropped](const transaction_metadata_ptr& trx) {
+            dropped.push_back(trx->trx.ref_block_prefix);
+        });
+        for (uint32_t i = 1; i <= 6; i++) {
+            pool.push(makeTrx(i % 2 ? N(usera) : N(userb), i));
+        }
+
+        BOOST_CHECK(pool.remove_if([](const transaction_metadata_ptr& trx) {
+            return trx->trx.first_authorizor() == N(userb);
+        }) == 3);
+        BOOST_CHECK(dropped == vector<uint32_t>({2, 4, 6}));
+        BOOST_CHECK(pool.count_of(N(userb)) == 0);
+        BOOST_CHECK(pool.count_of(N(usera)) == 3);
+
+        // pop_front and erase are not drops
+        dropped.clear();
+        pool.pop_front();
+        BOOST_CHECK(pool.erase(makeTrx(N(usera), 5)->signed_id));
+        BOOST_CHECK(dropped.empty());
+        pool.drop_front();
+        BOOST_CHECK(dropped == vector<uint32_t>({3}));
+        BOOST_CHECK(pool.empty());
+        BOOST_CHECK(pool.count_of(N(usera)) == 0);
+
+        // a drop by signed id, as for the transactions of an applied block
+        pool.push(makeTrx(N(usera), 7));
+        vector<uint32_t> removed;
+        BOOST_CHECK(pool.drop(makeTrx(N(usera), 7)->signed_id, [&removed](const transaction_metadata_ptr& trx) {
+            removed.push_back(trx->trx.ref_block_prefix);
+        }));
+        BOOST_CHECK(!pool.drop(makeTrx(N(usera), 7)->signed_id));
+        BOOST_CHECK(removed == vector<uint32_t>({7}));
+        BOOST_CHECK(dropped == vector<uint32_t>({3, 7}));
+        BOOST_CHECK(pool.count_of(N(usera)) == 0);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
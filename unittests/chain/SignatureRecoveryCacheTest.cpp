@@ -0,0 +1,164 @@
+#define BOOST_TEST_MODULE signaturerecoverycache_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <ultrainio/chain/signature_recovery_cache.hpp>
+
+using namespace ultrainio::chain;
+using namespace std;
+
+namespace {
+    struct Signed {
+        digest_type digest;
+        signature_type sig;
+        public_key_type key;
+    };
+
+    // keys are derived from seed, so every call gives the same signatures
+    Signed makeSigned(uint32_t seed, const digest_type& digest) {
+        auto sk = fc::crypto::private_key::regenerate(fc::sha256::hash(std::to_string(seed)));
+        return Signed{digest, sk.sign(digest), sk.get_public_key()};
+    }
+
+    Signed makeSigned(uint32_t seed) {
+        return makeSigned(seed, digest_type::hash(std::to_string(seed)));
+    }
+
+    // a fresh cache of capacity entries in total, the instance is shared by the test cases
+    signature_recovery_cache& resetCache(size_t capacity) {
+        signature_recovery_cache& cache = signature_recovery_cache::instance();
+        cache.clear();
+        cache.set_capacity(capacity);
+        return cache;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(signaturerecoverycache_test_suite)
+    BOOST_AUTO_TEST_CASE(hit) {
+        signature_recovery_cache& cache = resetCache(1024);
+        Signed s = makeSigned(1);
+        public_key_type key;
+        auto before = cache.get_stats();
+        BOOST_CHECK(!cache.find(s.sig, s.digest, key));
+        BOOST_CHECK(cache.recover(s.sig, s.digest) == s.key);
+        BOOST_CHECK(cache.find(s.sig, s.digest, key));
+        BOOST_CHECK(key == s.key);
+        BOOST_CHECK(cache.recover(s.sig, s.digest) == s.key);
+
+        auto after = cache.get_stats();
+        BOOST_CHECK(after.hits - before.hits == 2);
+        BOOST_CHECK(after.misses - before.misses == 2);
+        BOOST_CHECK(after.size == 1);
+
+        // the same signature over another digest is another entry
+        Signed other = makeSigned(2);
+        BOOST_CHECK(!cache.find(s.sig, other.digest, key));
+    }
+
+    BOOST_AUTO_TEST_CASE(evictionAtCapacity) {
+        // the shards have 2 entries each, one digest keeps all entries in one shard
+        signature_recovery_cache& cache = resetCache(32);
+        BOOST_CHECK(cache.get_stats().capacity == 32);
+        digest_type digest = digest_type::hash(std::string("eviction"));
+        Signed a = makeSigned(1, digest);
+        Signed b = makeSigned(2, digest);
+        Signed c = makeSigned(3, digest);
+        auto before = cache.get_stats();
+        cache.insert(a.sig, a.digest, a.key);
+        cache.insert(b.sig, b.digest, b.key);
+
+        // a is used again, so b is the least recently used one when c comes in
+        public_key_type key;
+        BOOST_CHECK(cache.find(a.sig, a.digest, key));
+        cache.insert(c.sig, c.digest, c.key);
+        BOOST_CHECK(cache.get_stats().evictions - before.evictions == 1);
+        BOOST_CHECK(cache.get_stats().size == 2);
+        BOOST_CHECK(cache.find(a.sig, a.digest, key));
+        BOOST_CHECK(!cache.find(b.sig, b.digest, key));
+        BOOST_CHECK(cache.find(c.sig, c.digest, key));
+        BOOST_CHECK(key == c.key);
+
+        // shrinking evicts down to the new capacity, 0 disables the cache
+        cache.set_capacity(16);
+        BOOST_CHECK(cache.get_stats().size == 1);
+        BOOST_CHECK(cache.find(c.sig, c.digest, key));
+        cache.set_capacity(0);
+        BOOST_CHECK(cache.get_stats().size == 0);
+        cache.insert(a.sig, a.digest, a.key);
+        BOOST_CHECK(!cache.find(a.sig, a.digest, key));
+    }
+
+    BOOST_AUTO_TEST_CASE(capacityBound) {
+        // capacities which are not a multiple of the shard number are not rounded up
+        const uint32_t kEntries = 200;
+        vector<Signed> entries;
+        for (uint32_t i = 0; i < kEntries; i++) {
+            entries.push_back(makeSigned(i));
+        }
+        for (size_t capacity : {1, 5, 20, 37}) {
+            signature_recovery_cache& cache = resetCache(capacity);
+            BOOST_CHECK(cache.get_stats().capacity == capacity);
+            for (const auto& s : entries) {
+                cache.insert(s.sig, s.digest, s.key);
+                BOOST_CHECK(cache.get_stats().size <= capacity);
+            }
+            BOOST_CHECK(cache.get_stats().size > 0);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(concurrentInsertAndFind) {
+        const uint32_t kThreads = 8;
+        const uint32_t kEntries = 64;
+        const uint32_t kRounds = 20;
+        signature_recovery_cache& cache = resetCache(4096);
+        vector<Signed> entries;
+        for (uint32_t i = 0; i < kEntries; i++) {
+            entries.push_back(makeSigned(i));
+        }
+
+        // all threads recover and look up the same entries in a different order
+        std::atomic<uint32_t> wrong(0);
+        vector<std::thread> threads;
+        auto before = cache.get_stats();
+        for (uint32_t t = 0; t < kThreads; t++) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t r = 0; r < kRounds; r++) {
+                    for (uint32_t i = 0; i < kEntries; i++) {
+                        const Signed& s = entries[(i * (t + 1) + r) % kEntries];
+                        public_key_type key;
+                        if (r % 2 == 0) {
+                            key = cache.recover(s.sig, s.digest);
+                        } else if (!cache.find(s.sig, s.digest, key)) {
+                            cache.insert(s.sig, s.digest, s.key);
+                            key = s.key;
+                        }
+                        if (!(key == s.key)) {
+                            wrong++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        auto after = cache.get_stats();
+        BOOST_CHECK(wrong == 0);
+        BOOST_CHECK(after.size == kEntries);
+        BOOST_CHECK(after.evictions == before.evictions);
+        BOOST_CHECK(after.hits + after.misses - before.hits - before.misses == kThreads * kRounds * kEntries);
+        // every entry misses at least once, the threads racing on a miss may each miss it
+        BOOST_CHECK(after.misses - before.misses >= kEntries);
+        BOOST_CHECK(after.misses - before.misses <= kEntries * kThreads);
+        for (const auto& s : entries) {
+            public_key_type key;
+            BOOST_CHECK(cache.find(s.sig, s.digest, key));
+            BOOST_CHECK(key == s.key);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,13 +4,90 @@
 #include <iostream>
 
 #include <base/Hex.h>
+#include <core/BlsVoterSet.h>
 #include <crypto/Bls.h>
 #include <crypto/PrivateKey.h>
 #include <crypto/PublicKey.h>
+#include <crypto/Signer.h>
+#include <lightclient/CommitteeInfo.h>
+#include <lightclient/CommitteeSet.h>
 
 using namespace ultrainio;
 using namespace std;
 
+struct BlsKey {
+    std::vector<unsigned char> skV = std::vector<unsigned char>(Bls::BLS_PRI_KEY_LENGTH);
+    std::vector<unsigned char> pkV = std::vector<unsigned char>(Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+
+    unsigned char* sk() {
+        return skV.data();
+    }
+
+    unsigned char* pk() {
+        return pkV.data();
+    }
+};
+
+static std::vector<BlsKey> genKeys(int n) {
+    std::vector<BlsKey> keys(n);
+    for (auto& key : keys) {
+        Bls::getDefault()->keygen(key.sk(), Bls::BLS_PRI_KEY_LENGTH, key.pk(), Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+    }
+    return keys;
+}
+
+// aggregate signature of msg by all the keys
+static std::vector<unsigned char> aggregateSign(std::vector<BlsKey>& keys, const std::string& msg) {
+    std::vector<unsigned char> sigBytes(keys.size() * Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    std::vector<unsigned char*> sigs(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        sigs[i] = sigBytes.data() + i * Bls::BLS_SIGNATURE_COMPRESSED_LENGTH;
+        Bls::getDefault()->sign(keys[i].sk(), (void*)msg.c_str(), msg.length(), sigs[i], Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    }
+    std::vector<unsigned char> sigX(Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    Bls::getDefault()->aggregate(sigs.data(), sigs.size(), sigX.data(), Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    return sigX;
+}
+
+// voter set of all the committee members signing the echo of blockId
+static BlsVoterSet makeBlsVoterSet(std::vector<BlsKey>& keys, const std::vector<CommitteeInfo>& committee, const std::string& blockId) {
+    BlsVoterSet blsVoterSet;
+    blsVoterSet.commonEchoMsg.blockId = fc::sha256(blockId);
+    blsVoterSet.commonEchoMsg.phase = kPhaseBA1;
+    blsVoterSet.commonEchoMsg.baxCount = 0;
+    blsVoterSet.commonEchoMsg.proposer = AccountName(committee[0].accountName);
+    std::vector<unsigned char> sigBytes(keys.size() * Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    std::vector<unsigned char*> sigs(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        blsVoterSet.accountPool.push_back(AccountName(committee[i].accountName));
+        sigs[i] = sigBytes.data() + i * Bls::BLS_SIGNATURE_COMPRESSED_LENGTH;
+        std::string sig = Signer::sign<CommonEchoMsg>(blsVoterSet.commonEchoMsg, keys[i].sk());
+        Hex::fromHex<unsigned char>(sig, sigs[i], Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    }
+    unsigned char sigX[Bls::BLS_SIGNATURE_COMPRESSED_LENGTH];
+    Bls::getDefault()->aggregate(sigs.data(), sigs.size(), sigX, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    blsVoterSet.sigX = Hex::toHex<unsigned char>(sigX, Bls::BLS_SIGNATURE_COMPRESSED_LENGTH);
+    return blsVoterSet;
+}
+
+static std::vector<CommitteeInfo> makeCommittee(std::vector<BlsKey>& keys) {
+    std::vector<CommitteeInfo> committee;
+    for (size_t i = 0; i < keys.size(); i++) {
+        CommitteeInfo info;
+        info.accountName = std::string("user.11") + std::to_string(i + 1);
+        info.pk = std::string("pk_") + std::to_string(i);
+        info.blsPk = Hex::toHex<unsigned char>(keys[i].pk(), Bls::BLS_PUB_KEY_COMPRESSED_LENGTH);
+        committee.push_back(info);
+    }
+    return committee;
+}
+
+static const char* kBlockIds[] = {
+        "0000052af4157bf7f13c9f08305d6510053dbb58b1c33d0ea38a3e302c6e3287",
+        "0000052bf4157bf7f13c9f08305d6510053dbb58b1c33d0ea38a3e302c6e3287",
+        "0000052cf4157bf7f13c9f08305d6510053dbb58b1c33d0ea38a3e302c6e3287"
+};
+
 BOOST_AUTO_TEST_SUITE(bls_test_suite)
     BOOST_AUTO_TEST_CASE(aggragate) {
         std::string ultrain("ultrain");
@@ -102,4 +179,91 @@ BOOST_AUTO_TEST_SUITE(bls_test_suite)
         BOOST_CHECK(blsPtr->verifyKeyPair(fakeSkChar, Bls::BLS_PRI_KEY_LENGTH, pkChar, Bls::BLS_PUB_KEY_COMPRESSED_LENGTH) == false);
         BOOST_CHECK(blsPtr->verifyKeyPair(skChar, Bls::BLS_PRI_KEY_LENGTH, fakePkChar, Bls::BLS_PUB_KEY_COMPRESSED_LENGTH) == false);
     }
+
+    BOOST_AUTO_TEST_CASE(verifyAggregateBatch) {
+        std::shared_ptr<Bls> blsPtr = Bls::getDefault();
+        std::vector<std::vector<BlsKey>> keys;
+        std::vector<std::string> msgs = {"ultrain", "ultrain.1", "ultrain.2"};
+        std::vector<std::vector<unsigned char>> sigXs;
+        for (size_t i = 0; i < msgs.size(); i++) {
+            keys.push_back(genKeys(i + 1));
+            sigXs.push_back(aggregateSign(keys[i], msgs[i]));
+        }
+        int count = msgs.size();
+        std::vector<std::vector<unsigned char*>> pkV(count);
+        std::vector<unsigned char**> pks(count);
+        std::vector<int> pkSizes(count);
+        std::vector<unsigned char*> sigX(count);
+        std::vector<void*> hmsg(count);
+        std::vector<int> hSizes(count);
+        for (int i = 0; i < count; i++) {
+            for (auto& key : keys[i]) {
+                pkV[i].push_back(key.pk());
+            }
+            pks[i] = pkV[i].data();
+            pkSizes[i] = pkV[i].size();
+            sigX[i] = sigXs[i].data();
+            hmsg[i] = (void*)msgs[i].c_str();
+            hSizes[i] = msgs[i].length();
+        }
+        BOOST_CHECK(blsPtr->verifyAggregateBatch(pks.data(), pkSizes.data(), sigX.data(), hmsg.data(), hSizes.data(), count) == true);
+
+        // one aggregate signature of the batch is over another message
+        std::vector<unsigned char> badSigX = aggregateSign(keys[1], msgs[0]);
+        sigX[1] = badSigX.data();
+        BOOST_CHECK(blsPtr->verifyAggregateBatch(pks.data(), pkSizes.data(), sigX.data(), hmsg.data(), hSizes.data(), count) == false);
+
+        // empty batch
+        BOOST_CHECK(blsPtr->verifyAggregateBatch(pks.data(), pkSizes.data(), sigX.data(), hmsg.data(), hSizes.data(), 0) == false);
+    }
+
+    BOOST_AUTO_TEST_CASE(verifyBlsBatch) {
+        std::vector<BlsKey> keys = genKeys(3);
+        std::vector<CommitteeInfo> committee = makeCommittee(keys);
+        std::vector<BlsVoterSet> blsVoterSetV;
+        for (const char* blockId : kBlockIds) {
+            blsVoterSetV.push_back(makeBlsVoterSet(keys, committee, blockId));
+        }
+        std::vector<const BlsVoterSet*> sets;
+        std::vector<std::vector<unsigned char*>> pks;
+        for (const auto& blsVoterSet : blsVoterSetV) {
+            sets.push_back(&blsVoterSet);
+            std::vector<unsigned char*> pk;
+            for (auto& key : keys) {
+                pk.push_back(key.pk());
+            }
+            pks.push_back(pk);
+        }
+        BOOST_CHECK(BlsVoterSet::verifyBlsBatch(sets, pks) == true);
+
+        // sigX of another block
+        BlsVoterSet bad = blsVoterSetV[2];
+        bad.sigX = blsVoterSetV[0].sigX;
+        sets[2] = &bad;
+        BOOST_CHECK(BlsVoterSet::verifyBlsBatch(sets, pks) == false);
+
+        std::vector<const BlsVoterSet*> emptySets;
+        std::vector<std::vector<unsigned char*>> emptyPks;
+        BOOST_CHECK(BlsVoterSet::verifyBlsBatch(emptySets, emptyPks) == false);
+    }
+
+    BOOST_AUTO_TEST_CASE(committeeSetVerifyBatch) {
+        std::vector<BlsKey> keys = genKeys(3);
+        std::vector<CommitteeInfo> committee = makeCommittee(keys);
+        CommitteeSet committeeSet(committee);
+        std::vector<BlsVoterSet> blsVoterSetV;
+        for (const char* blockId : kBlockIds) {
+            blsVoterSetV.push_back(makeBlsVoterSet(keys, committee, blockId));
+            BOOST_CHECK(committeeSet.verify(blsVoterSetV.back()) == true);
+        }
+        BOOST_CHECK(committeeSet.verify(blsVoterSetV) == true);
+
+        // one voter set carries the signature of another block
+        std::vector<BlsVoterSet> badV = blsVoterSetV;
+        badV[1].sigX = blsVoterSetV[0].sigX;
+        BOOST_CHECK(committeeSet.verify(badV) == false);
+
+        // no voter set to check
+        BOOST_CHECK(committeeSet.verify(std::vector<BlsVoterSet>()) == true);
+    }
 BOOST_AUTO_TEST_SUITE_END()
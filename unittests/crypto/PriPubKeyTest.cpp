@@ -1,6 +1,8 @@
 #define BOOST_TEST_MODULE key_test_suite
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 
 #include <crypto/Digest.h>
@@ -80,4 +82,43 @@ BOOST_AUTO_TEST_SUITE(key_test_suite)
         BOOST_CHECK(pk != pk2);
     }
 
+    BOOST_AUTO_TEST_CASE(raw_case) {
+        PrivateKey sk;
+        PublicKey pk;
+        PrivateKey::generate(pk, sk);
+        Digest digest(std::string("hash test"));
+        Signature signature = sk.sign(digest);
+        std::string sigHexStr = std::string(signature);
+        BOOST_CHECK(sigHexStr.length() == 2 * Signature::kRawLength);
+
+        // hex decoded once, both cases give the same bytes and the text is kept as given
+        std::string upper = sigHexStr;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        Signature sig1(upper);
+        BOOST_CHECK(sig1.isValid());
+        BOOST_CHECK(std::string(sig1) == upper);
+        BOOST_CHECK(pk.verify(sig1, digest));
+        std::string pkUpper = std::string(pk);
+        std::transform(pkUpper.begin(), pkUpper.end(), pkUpper.begin(), ::toupper);
+        BOOST_CHECK(std::string(PublicKey(pkUpper)) == pkUpper);
+        BOOST_CHECK(PublicKey(pkUpper).verify(signature, digest));
+        BOOST_CHECK(PublicKey(pkUpper) != pk);
+
+        uint8_t raw[Signature::kRawLength];
+        BOOST_CHECK(signature.getRaw(raw, Signature::kRawLength));
+        BOOST_CHECK(std::equal(raw, raw + Signature::kRawLength, signature.raw()));
+        BOOST_CHECK(pk.verify(Signature(raw, Signature::kRawLength), digest));
+
+        // wrong length is rejected up front
+        BOOST_CHECK(!Signature(sigHexStr.substr(2)).isValid());
+        BOOST_CHECK(!Signature(std::string()).isValid());
+        BOOST_CHECK(!pk.verify(Signature(sigHexStr.substr(2)), digest));
+        BOOST_CHECK(std::string(Signature(sigHexStr.substr(2))) == sigHexStr.substr(2));
+        BOOST_CHECK(!PublicKey(std::string(pk) + "00").isValid());
+        BOOST_CHECK(std::string(PublicKey(std::string(pk) + "00")) == std::string(pk) + "00");
+        BOOST_CHECK(!PublicKey(std::string(pk) + "00").verify(signature, digest));
+        BOOST_CHECK(PublicKey() == PublicKey(std::string()));
+        BOOST_CHECK(PublicKey() != pk);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include <core/Message.h>
+#include <crypto/HexDigest.h>
 #include <crypto/PrivateKey.h>
 #include <crypto/PublicKey.h>
 #include <crypto/Validator.h>
@@ -32,4 +33,40 @@ BOOST_AUTO_TEST_SUITE(signer_validator_test_suite)
         BOOST_CHECK(Validator::verify<UnsignedEchoMsg>(Signature(echoMsg.signature), echoMsg, publicKey));
     }
 
+    BOOST_AUTO_TEST_CASE(hexDigest) {
+        EchoMsg echoMsg;
+        echoMsg.baxCount = 1;
+        echoMsg.account = N("ultr_test");
+        fc::sha256 h = fc::sha256::hash(static_cast<const UnsignedEchoMsg&>(echoMsg));
+        HexDigest digest = HexDigest::of<UnsignedEchoMsg>(echoMsg);
+        BOOST_CHECK(std::string((const char*)digest.data(), digest.size()) == h.str());
+
+        fc::sha256 h2 = fc::sha256::hash(h);
+        HexDigest digest2 = HexDigest::of(h);
+        BOOST_CHECK(std::string((const char*)digest2.data(), digest2.size()) == h2.str());
+    }
+
+    BOOST_AUTO_TEST_CASE(memoizedBlockHashes) {
+        PrivateKey privateKey;
+        PublicKey publicKey;
+        PrivateKey::generate(publicKey, privateKey);
+        ProposeMsg propose;
+        propose.block.previous = BlockIdType("0000000a00000000000000000000000000000000000000000000000000000000");
+        propose.block.proposer = N("ultr_genesis");
+        propose.block.signature = std::string(Signer::sign<BlockHeader>(propose.block, privateKey));
+        BOOST_CHECK(propose.blockId() == propose.block.id());
+        BOOST_CHECK(propose.blockDigest() == propose.block.digest());
+        BOOST_CHECK(BlockHeader::num_from_id(propose.blockId()) == 11);
+        BOOST_CHECK(Validator::verifyDigest(Signature(propose.block.signature), propose.blockDigest(), publicKey));
+
+        // a copy keeps the hashes, the signature is not part of them
+        ProposeMsg copy = propose;
+        copy.block.signature.clear();
+        BOOST_CHECK(copy.blockId() == propose.block.id());
+
+        SyncBlockMsg msg;
+        msg.block = propose.block;
+        BOOST_CHECK(msg.blockId() == propose.block.id());
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
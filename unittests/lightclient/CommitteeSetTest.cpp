@@ -85,4 +85,31 @@ BOOST_AUTO_TEST_SUITE(committeeset_test_suite)
         BOOST_CHECK(delta.getRemoved() == ba);
     }
 
+    BOOST_AUTO_TEST_CASE(getBlsPk) {
+        std::vector<CommitteeInfo> committeeInfoV;
+        for (std::string name : {"usera", "userb", "userc"}) {
+            CommitteeInfo info;
+            info.accountName = name;
+            info.pk = std::string("pk_") + name;
+            info.blsPk = std::string("bls_pk_") + name;
+            committeeInfoV.push_back(info);
+        }
+        CommitteeSet committeeSet(committeeInfoV);
+
+        std::vector<AccountName> accountV;
+        accountV.push_back(AccountName("userc"));
+        accountV.push_back(AccountName("usera"));
+        accountV.push_back(AccountName("userd"));
+        std::vector<std::string> pkV = committeeSet.getBlsPk(accountV);
+        BOOST_CHECK(pkV.size() == 2);
+        BOOST_CHECK(pkV[0] == std::string("bls_pk_userc"));
+        BOOST_CHECK(pkV[1] == std::string("bls_pk_usera"));
+
+        BOOST_CHECK(committeeSet.contains(committeeInfoV[1]));
+        CommitteeInfo changed = committeeInfoV[1];
+        changed.blsPk = std::string("bls_pk_changed");
+        BOOST_CHECK(!committeeSet.contains(changed));
+        BOOST_CHECK(committeeSet.committeeMroot() == SHA256::hash(committeeSet.toString()));
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
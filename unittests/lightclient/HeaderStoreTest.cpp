@@ -0,0 +1,159 @@
+#define BOOST_TEST_MODULE headerstore_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <fstream>
+
+#include <lightclient/CommitteeSet.h>
+#include <lightclient/HeaderStore.h>
+
+using namespace ultrainio;
+using namespace std;
+
+namespace {
+    std::vector<BlockHeader> makeChain(int n) {
+        std::vector<BlockHeader> chain;
+        BlockIdType previous;
+        for (int i = 0; i < n; i++) {
+            BlockHeader blockHeader;
+            blockHeader.previous = previous;
+            blockHeader.proposer = AccountName("usera");
+            chain.push_back(blockHeader);
+            previous = blockHeader.id();
+        }
+        return chain;
+    }
+
+    void appendBytes(const fc::path& file, const std::vector<char>& bytes) {
+        std::ofstream out(file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::app);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    void fillStore(const fc::path& dir, const std::vector<BlockHeader>& chain, size_t n) {
+        HeaderStore store(dir);
+        for (size_t i = 0; i < n; i++) {
+            store.append(chain[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(headerstore_test_suite)
+    BOOST_AUTO_TEST_CASE(appendAndReopen) {
+        fc::path dir = fc::temp_directory_path() / fc::unique_path();
+        std::vector<BlockHeader> chain = makeChain(5);
+        {
+            HeaderStore store(dir);
+            BOOST_CHECK(store.empty());
+            for (const auto& h : chain) {
+                store.append(h);
+            }
+            // duplicate append is ignored
+            store.append(chain[3]);
+            BOOST_CHECK(store.firstBlockNum() == 1);
+            BOOST_CHECK(store.lastBlockNum() == 5);
+        }
+
+        HeaderStore store(dir);
+        BOOST_CHECK(store.lastBlockNum() == 5);
+        BOOST_CHECK(store.lastBlockId() == chain.back().id());
+        BlockHeader blockHeader;
+        BOOST_CHECK(store.read(3, blockHeader));
+        BOOST_CHECK(blockHeader.id() == chain[2].id());
+        BOOST_CHECK(!store.read(6, blockHeader));
+        fc::remove_all(dir);
+    }
+
+    BOOST_AUTO_TEST_CASE(startPoint) {
+        fc::path dir = fc::temp_directory_path() / fc::unique_path();
+        std::vector<CommitteeInfo> committeeInfoV;
+        CommitteeInfo info;
+        info.accountName = std::string("usera");
+        info.pk = std::string("pk_usera");
+        info.blsPk = std::string("bls_pk_usera");
+        committeeInfoV.push_back(info);
+
+        StartPoint saved(CommitteeSet(committeeInfoV), makeChain(2).back().id());
+        saved.nextCommitteeMroot = std::string("mroot");
+        saved.genesisPk = std::string("genesis_pk");
+        {
+            HeaderStore store(dir);
+            StartPoint loaded;
+            BOOST_CHECK(!store.loadStartPoint(loaded));
+            store.saveStartPoint(saved);
+        }
+
+        HeaderStore store(dir);
+        StartPoint loaded;
+        BOOST_CHECK(store.loadStartPoint(loaded));
+        BOOST_CHECK(loaded.committeeSet == saved.committeeSet);
+        BOOST_CHECK(loaded.lastConfirmedBlockId == saved.lastConfirmedBlockId);
+        BOOST_CHECK(loaded.nextCommitteeMroot == saved.nextCommitteeMroot);
+        BOOST_CHECK(loaded.genesisPk == saved.genesisPk);
+        fc::remove_all(dir);
+    }
+
+    BOOST_AUTO_TEST_CASE(crashRecovery) {
+        std::vector<BlockHeader> chain = makeChain(6);
+
+        // a partial header and a partial index record after the last complete block
+        {
+            fc::path dir = fc::temp_directory_path() / fc::unique_path();
+            fillStore(dir, chain, 5);
+            uint64_t headerSize = fc::file_size(dir / "headers.log");
+            uint64_t indexSize = fc::file_size(dir / "headers.index");
+            uint32_t size = 200;
+            std::vector<char> partial((const char*)&size, (const char*)&size + sizeof(size));
+            partial.resize(partial.size() + 10, 'x');
+            appendBytes(dir / "headers.log", partial);
+            appendBytes(dir / "headers.index", std::vector<char>(HeaderStore::kIndexRecordSize / 2, 'y'));
+
+            HeaderStore store(dir);
+            BOOST_CHECK(store.lastBlockNum() == 5);
+            BOOST_CHECK(store.lastBlockId() == chain[4].id());
+            BOOST_CHECK(fc::file_size(dir / "headers.log") == headerSize);
+            BOOST_CHECK(fc::file_size(dir / "headers.index") == indexSize);
+            store.append(chain[5]);
+            BlockHeader blockHeader;
+            BOOST_CHECK(store.read(6, blockHeader));
+            BOOST_CHECK(blockHeader.id() == chain[5].id());
+            fc::remove_all(dir);
+        }
+
+        // the index record of the last block reached the disk, its header only partly
+        {
+            fc::path dir = fc::temp_directory_path() / fc::unique_path();
+            fillStore(dir, chain, 5);
+            fc::resize_file(dir / "headers.log", fc::file_size(dir / "headers.log") - 3);
+
+            HeaderStore store(dir);
+            BOOST_CHECK(store.lastBlockNum() == 4);
+            BOOST_CHECK(store.lastBlockId() == chain[3].id());
+            BlockHeader blockHeader;
+            BOOST_CHECK(!store.read(5, blockHeader));
+            BOOST_CHECK(store.read(4, blockHeader));
+            BOOST_CHECK(blockHeader.id() == chain[3].id());
+            store.append(chain[4]);
+            BOOST_CHECK(store.lastBlockNum() == 5);
+            BOOST_CHECK(store.read(5, blockHeader));
+            BOOST_CHECK(blockHeader.id() == chain[4].id());
+            fc::remove_all(dir);
+        }
+
+        // a size field larger than the rest of the file
+        {
+            fc::path dir = fc::temp_directory_path() / fc::unique_path();
+            fillStore(dir, chain, 1);
+            uint32_t size = 0xffffff;
+            fc::resize_file(dir / "headers.log", 0);
+            appendBytes(dir / "headers.log", std::vector<char>((const char*)&size, (const char*)&size + sizeof(size)));
+
+            HeaderStore store(dir);
+            BOOST_CHECK(store.empty());
+            BOOST_CHECK(fc::file_size(dir / "headers.log") == 0);
+            BOOST_CHECK(fc::file_size(dir / "headers.index") == 0);
+            store.append(chain[0]);
+            BOOST_CHECK(store.lastBlockNum() == 1);
+            fc::remove_all(dir);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+#define BOOST_TEST_MODULE history_export_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <fstream>
+
+#include <ultrainio/history_export_plugin/columnar_segment.hpp>
+
+using namespace ultrainio::chain;
+using namespace ultrainio::history_export;
+using namespace std;
+
+namespace {
+    block_state makeBlockState(uint32_t num) {
+        block_state bs;
+        bs.block_num = num;
+        bs.header.timestamp = block_timestamp_type(1000 + num);
+        return bs;
+    }
+
+    action_trace makeActionTrace(uint64_t seq, account_name receiver, const string& console) {
+        action_trace at;
+        at.receipt.receiver = receiver;
+        at.receipt.global_sequence = seq;
+        at.act.account = N(utrio.token);
+        at.act.name = NEX(transfer);
+        at.act.authorization.push_back(permission_level{receiver, N(active)});
+        at.act.data = bytes{char(seq), char(seq >> 8), 'x'};
+        at.elapsed = fc::microseconds(seq * 3);
+        at.cpu_usage = seq * 7;
+        at.console = console;
+        return at;
+    }
+
+    // one transaction of an action with one inline action, numbered from seq
+    transaction_trace makeTrace(uint32_t n, uint64_t seq) {
+        transaction_trace trace;
+        trace.id = transaction_id_type::hash(fc::to_string(n));
+        trace.receipt = transaction_receipt_header(n % 2 ? transaction_receipt_header::executed
+                                                         : transaction_receipt_header::soft_fail);
+        trace.receipt->cpu_usage_us = 100 + n;
+        trace.receipt->net_usage_words = 20 + n;
+        trace.action_traces.push_back(makeActionTrace(seq, N(alice), "hello"));
+        trace.action_traces.back().inline_traces.push_back(makeActionTrace(seq + 1, N(bob), ""));
+        return trace;
+    }
+
+    struct TempDir {
+        fc::path path = fc::temp_directory_path() / fc::unique_path();
+        ~TempDir() { fc::remove_all(path); }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(history_export_test_suite)
+
+    BOOST_AUTO_TEST_CASE(roundTrip) {
+        TempDir dir;
+        segment_writer writer(dir.path);
+        BOOST_CHECK(writer.empty());
+
+        vector<transaction_trace> traces;
+        uint64_t seq = 10;
+        for (uint32_t num = 5; num <= 7; num++) {
+            auto bs = makeBlockState(num);
+            writer.add_block(num);
+            for (uint32_t i = 0; i < 2; i++) {
+                traces.push_back(makeTrace(traces.size(), seq));
+                writer.add_transaction(traces.back(), bs);
+                seq += 2;
+            }
+        }
+        // a block without transactions still extends the range
+        writer.add_block(8);
+        BOOST_CHECK(!writer.empty());
+        BOOST_CHECK(writer.buffered_bytes() > 0);
+
+        fc::path file = writer.seal();
+        BOOST_CHECK(writer.empty());
+        BOOST_CHECK_EQUAL(file.filename().generic_string(), "5-8.seg");
+
+        segment_reader reader(file);
+        BOOST_CHECK_EQUAL(reader.footer().first_block, 5);
+        BOOST_CHECK_EQUAL(reader.footer().last_block, 8);
+        BOOST_CHECK_EQUAL(reader.footer().trx_rows, 6);
+        BOOST_CHECK_EQUAL(reader.footer().action_rows, 12);
+
+        auto trxs = reader.read_transactions();
+        BOOST_REQUIRE_EQUAL(trxs.size(), traces.size());
+        for (size_t i = 0; i < trxs.size(); i++) {
+            BOOST_CHECK(trxs[i].id == traces[i].id);
+            BOOST_CHECK_EQUAL(trxs[i].block_num, 5 + i / 2);
+            BOOST_CHECK(trxs[i].block_time == block_timestamp_type(1000 + 5 + i / 2));
+            BOOST_CHECK_EQUAL(trxs[i].status, uint8_t(traces[i].receipt->status));
+            BOOST_CHECK_EQUAL(trxs[i].cpu_usage_us, traces[i].receipt->cpu_usage_us);
+            BOOST_CHECK_EQUAL(trxs[i].net_usage_words, traces[i].receipt->net_usage_words.value);
+            BOOST_CHECK_EQUAL(trxs[i].action_count, 2);
+        }
+
+        auto actions = reader.read_actions();
+        BOOST_REQUIRE_EQUAL(actions.size(), 12);
+        for (size_t i = 0; i < actions.size(); i++) {
+            const auto& expected = i % 2 == 0 ? traces[i / 2].action_traces[0]
+                                              : traces[i / 2].action_traces[0].inline_traces[0];
+            BOOST_CHECK_EQUAL(actions[i].trx_row, i / 2);
+            BOOST_CHECK_EQUAL(actions[i].global_sequence, expected.receipt.global_sequence);
+            BOOST_CHECK(actions[i].receiver == expected.receipt.receiver);
+            BOOST_CHECK(actions[i].account == expected.act.account);
+            BOOST_CHECK(actions[i].name == expected.act.name);
+            BOOST_REQUIRE_EQUAL(actions[i].authorization.size(), 1);
+            BOOST_CHECK(actions[i].authorization[0] == expected.act.authorization[0]);
+            BOOST_CHECK(actions[i].data == expected.act.data);
+            BOOST_CHECK_EQUAL(actions[i].elapsed_us, expected.elapsed.count());
+            BOOST_CHECK_EQUAL(actions[i].cpu_usage, expected.cpu_usage);
+            BOOST_CHECK_EQUAL(actions[i].console, expected.console);
+        }
+
+        auto receivers = reader.read_names("act.receiver");
+        auto names = reader.read_action_names();
+        BOOST_REQUIRE_EQUAL(receivers.size(), 12);
+        BOOST_REQUIRE_EQUAL(names.size(), 12);
+        for (size_t i = 0; i < receivers.size(); i++) {
+            BOOST_CHECK(receivers[i] == actions[i].receiver);
+            BOOST_CHECK(names[i] == NEX(transfer));
+        }
+        BOOST_CHECK(reader.read_column("no.such.column").empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(listSegments) {
+        TempDir dir;
+        segment_writer writer(dir.path);
+        for (uint32_t first : {21, 1, 11}) {
+            auto bs = makeBlockState(first);
+            writer.add_transaction(makeTrace(first, first), bs);
+            writer.add_block(first + 9);
+            writer.seal();
+        }
+        // incomplete segments are not listed
+        std::ofstream(fc::path(dir.path / "31-40.tmp").generic_string().c_str()) << "partial";
+
+        auto segments = segment_reader::list_segments(dir.path);
+        BOOST_REQUIRE_EQUAL(segments.size(), 3);
+        BOOST_CHECK_EQUAL(segments[0].filename().generic_string(), "1-10.seg");
+        BOOST_CHECK_EQUAL(segments[1].filename().generic_string(), "11-20.seg");
+        BOOST_CHECK_EQUAL(segments[2].filename().generic_string(), "21-30.seg");
+        BOOST_CHECK_EQUAL(segment_reader(segments[2]).footer().last_block, 30);
+    }
+
+    BOOST_AUTO_TEST_CASE(rejectCorruptSegment) {
+        TempDir dir;
+        segment_writer writer(dir.path);
+        auto bs = makeBlockState(1);
+        writer.add_transaction(makeTrace(1, 1), bs);
+        fc::path file = writer.seal();
+
+        // cut off the trailing magic
+        auto size = fc::file_size(file);
+        fc::resize_file(file, size - 4);
+        BOOST_CHECK_THROW(segment_reader{file}, fc::exception);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+#define BOOST_TEST_MODULE record_log_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <fstream>
+
+#include <fc/exception/exception.hpp>
+
+#include <ultrainio/local_history_plugin/record_log.hpp>
+
+using namespace ultrainio::history;
+using namespace std;
+
+namespace {
+    // 20 bytes, so with the 4 byte size prefix two entries fill a 48 byte segment
+    vector<char> makeEntry(uint64_t n) {
+        string s = "entry-" + to_string(n);
+        s.resize(20, '.');
+        return vector<char>(s.begin(), s.end());
+    }
+
+    fc::path segmentFile(const fc::path& dir, uint32_t s) {
+        return dir / ("test." + to_string(s) + ".log");
+    }
+
+    void appendBytes(const fc::path& file, const string& bytes) {
+        std::ofstream out(file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ios::app);
+        out.write(bytes.data(), bytes.size());
+    }
+
+    struct TempDir {
+        fc::path path = fc::temp_directory_path() / fc::unique_path();
+        ~TempDir() { fc::remove_all(path); }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(record_log_test_suite)
+
+    BOOST_AUTO_TEST_CASE(appendRead) {
+        TempDir dir;
+        {
+            record_log log(dir.path, "test", 48);
+            for (uint64_t i = 0; i < 5; i++) {
+                BOOST_CHECK_EQUAL(log.append(makeEntry(i)), i);
+            }
+            BOOST_CHECK_EQUAL(log.size(), 5);
+            for (uint64_t i = 0; i < 5; i++) {
+                BOOST_CHECK(log.read(i) == makeEntry(i));
+            }
+            BOOST_CHECK_THROW(log.read(5), fc::exception);
+        }
+        BOOST_CHECK(fc::exists(segmentFile(dir.path, 2)));
+        BOOST_CHECK(!fc::exists(segmentFile(dir.path, 3)));
+
+        record_log log(dir.path, "test", 48);
+        BOOST_CHECK_EQUAL(log.size(), 5);
+        BOOST_CHECK(log.read(4) == makeEntry(4));
+    }
+
+    BOOST_AUTO_TEST_CASE(recoverTornIndexTail) {
+        TempDir dir;
+        {
+            record_log log(dir.path, "test", 1024);
+            for (uint64_t i = 0; i < 3; i++) {
+                log.append(makeEntry(i));
+            }
+        }
+        // half of a locator reached the disk
+        appendBytes(dir.path / "test.index", string(4, '\xff'));
+
+        record_log log(dir.path, "test", 1024);
+        BOOST_CHECK_EQUAL(log.size(), 3);
+        BOOST_CHECK_EQUAL(fc::file_size(dir.path / "test.index"), 3 * sizeof(uint64_t));
+        BOOST_CHECK(log.read(2) == makeEntry(2));
+        BOOST_CHECK_EQUAL(log.append(makeEntry(3)), 3);
+        BOOST_CHECK(log.read(3) == makeEntry(3));
+    }
+
+    BOOST_AUTO_TEST_CASE(recoverTornSegmentTail) {
+        TempDir dir;
+        {
+            record_log log(dir.path, "test", 1024);
+            for (uint64_t i = 0; i < 3; i++) {
+                log.append(makeEntry(i));
+            }
+        }
+        // the last entry is indexed but only part of it reached the segment
+        fc::resize_file(segmentFile(dir.path, 0), 2 * 24 + 10);
+        {
+            record_log log(dir.path, "test", 1024);
+            BOOST_CHECK_EQUAL(log.size(), 2);
+            BOOST_CHECK_EQUAL(fc::file_size(segmentFile(dir.path, 0)), 2 * 24);
+            BOOST_CHECK(log.read(1) == makeEntry(1));
+            BOOST_CHECK_EQUAL(log.append(makeEntry(7)), 2);
+            BOOST_CHECK(log.read(2) == makeEntry(7));
+        }
+
+        // an unindexed entry written past the index and a segment the index never reached
+        appendBytes(segmentFile(dir.path, 0), "garbage");
+        appendBytes(segmentFile(dir.path, 1), "garbage");
+        record_log log(dir.path, "test", 1024);
+        BOOST_CHECK_EQUAL(log.size(), 3);
+        BOOST_CHECK_EQUAL(fc::file_size(segmentFile(dir.path, 0)), 3 * 24);
+        BOOST_CHECK(!fc::exists(segmentFile(dir.path, 1)));
+        BOOST_CHECK_EQUAL(log.append(makeEntry(8)), 3);
+        BOOST_CHECK(log.read(3) == makeEntry(8));
+    }
+
+    BOOST_AUTO_TEST_CASE(truncateAcrossSegments) {
+        TempDir dir;
+        {
+            record_log log(dir.path, "test", 48);
+            for (uint64_t i = 0; i < 10; i++) {
+                log.append(makeEntry(i));
+            }
+            BOOST_CHECK(fc::exists(segmentFile(dir.path, 4)));
+
+            // seq 3 is the second entry of segment 1
+            log.truncate(3);
+            BOOST_CHECK_EQUAL(log.size(), 3);
+            BOOST_CHECK_EQUAL(fc::file_size(segmentFile(dir.path, 1)), 24);
+            for (uint32_t s = 2; s <= 4; s++) {
+                BOOST_CHECK(!fc::exists(segmentFile(dir.path, s)));
+            }
+            BOOST_CHECK(log.read(2) == makeEntry(2));
+            BOOST_CHECK_THROW(log.read(3), fc::exception);
+
+            // appends continue in the cut segment and roll over again
+            BOOST_CHECK_EQUAL(log.append(makeEntry(13)), 3);
+            BOOST_CHECK_EQUAL(log.append(makeEntry(14)), 4);
+            BOOST_CHECK(fc::exists(segmentFile(dir.path, 2)));
+            BOOST_CHECK(log.read(3) == makeEntry(13));
+            BOOST_CHECK(log.read(4) == makeEntry(14));
+
+            // truncating at a segment boundary empties that segment
+            log.truncate(2);
+            BOOST_CHECK_EQUAL(fc::file_size(segmentFile(dir.path, 1)), 0);
+            BOOST_CHECK(!fc::exists(segmentFile(dir.path, 2)));
+            log.truncate(5);
+            BOOST_CHECK_EQUAL(log.size(), 2);
+        }
+
+        record_log log(dir.path, "test", 48);
+        BOOST_CHECK_EQUAL(log.size(), 2);
+        BOOST_CHECK(log.read(0) == makeEntry(0));
+        BOOST_CHECK(log.read(1) == makeEntry(1));
+        BOOST_CHECK_EQUAL(log.append(makeEntry(2)), 2);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+#define BOOST_TEST_MODULE sorted_index_test_suite
+#include <boost/test/included/unit_test.hpp>
+
+#include <fstream>
+
+#include <ultrainio/local_history_plugin/sorted_index.hpp>
+
+using namespace ultrainio::history;
+using namespace std;
+
+namespace {
+    const char* key(const uint64_t& k) {
+        return (const char*)&k;
+    }
+
+    vector<uint64_t> seqsOf(const sorted_index& index, uint64_t k) {
+        vector<uint64_t> v;
+        for (uint64_t i = 0; i < index.count(key(k)); i++) {
+            v.push_back(index.at(key(k), i));
+        }
+        return v;
+    }
+
+    // seq n is indexed under key n % 3, and under key 10 when n is even
+    void addSeq(sorted_index& index, uint64_t n) {
+        uint64_t k = n % 3;
+        index.add(key(k), n);
+        if (n % 2 == 0) {
+            uint64_t even = 10;
+            index.add(key(even), n);
+        }
+    }
+
+    vector<uint64_t> expected(uint64_t k, uint64_t end) {
+        vector<uint64_t> v;
+        for (uint64_t n = 0; n < end; n++) {
+            if (k == 10 ? n % 2 == 0 : n % 3 == k) {
+                v.push_back(n);
+            }
+        }
+        return v;
+    }
+
+    size_t runFiles(const fc::path& dir) {
+        size_t n = 0;
+        for (fc::directory_iterator itr(dir); itr != fc::directory_iterator(); ++itr) {
+            if (itr->extension() == ".run") {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    struct TempDir {
+        fc::path path = fc::temp_directory_path() / fc::unique_path();
+        ~TempDir() { fc::remove_all(path); }
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(sorted_index_test_suite)
+
+    BOOST_AUTO_TEST_CASE(lookupAcrossRuns) {
+        TempDir dir;
+        {
+            // a run every 4 entries, 8 of them are merged into one
+            sorted_index index(dir.path, "test", sizeof(uint64_t), 4);
+            for (uint64_t n = 0; n < 100; n++) {
+                addSeq(index, n);
+                index.flush();
+            }
+            BOOST_CHECK_EQUAL(index.end(), 100);
+            BOOST_CHECK(runFiles(dir.path) < 16);
+            for (uint64_t k : {0, 1, 2, 10}) {
+                BOOST_CHECK(seqsOf(index, k) == expected(k, 100));
+            }
+            uint64_t missing = 5;
+            BOOST_CHECK_EQUAL(index.count(key(missing)), 0);
+        }
+
+        // the last sequence number in the wal may be torn, it is dropped and added again
+        sorted_index index(dir.path, "test", sizeof(uint64_t), 4);
+        BOOST_CHECK(index.end() <= 100);
+        for (uint64_t n = index.end(); n < 120; n++) {
+            addSeq(index, n);
+        }
+        index.flush();
+        for (uint64_t k : {0, 1, 2, 10}) {
+            BOOST_CHECK(seqsOf(index, k) == expected(k, 120));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(truncate) {
+        TempDir dir;
+        sorted_index index(dir.path, "test", sizeof(uint64_t), 4);
+        for (uint64_t n = 0; n < 50; n++) {
+            addSeq(index, n);
+            index.flush();
+        }
+
+        // cuts through a run and drops the memory table
+        index.truncate(21);
+        BOOST_CHECK_EQUAL(index.end(), 21);
+        for (uint64_t k : {0, 1, 2, 10}) {
+            BOOST_CHECK(seqsOf(index, k) == expected(k, 21));
+        }
+        index.truncate(30);
+        BOOST_CHECK_EQUAL(index.end(), 21);
+
+        for (uint64_t n = 21; n < 40; n++) {
+            addSeq(index, n);
+            index.flush();
+        }
+        for (uint64_t k : {0, 1, 2, 10}) {
+            BOOST_CHECK(seqsOf(index, k) == expected(k, 40));
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(recoverRuns) {
+        TempDir dir;
+        {
+            sorted_index index(dir.path, "test", sizeof(uint64_t), 4);
+            for (uint64_t n = 0; n < 10; n++) {
+                addSeq(index, n);
+                index.flush();
+            }
+        }
+        // a merge that stopped before its inputs were removed, a run after a gap and a partial run
+        {
+            std::ofstream out((dir.path / "test.0-2.run").generic_string().c_str(), std::ios::binary);
+            uint64_t k = 0, seq = 0;
+            out.write((const char*)&k, sizeof(k));
+            out.write((const char*)&seq, sizeof(seq));
+        }
+        std::ofstream((dir.path / "test.500-600.run").generic_string().c_str());
+        std::ofstream((dir.path / "test.600-700.run.tmp").generic_string().c_str());
+
+        sorted_index index(dir.path, "test", sizeof(uint64_t), 4);
+        BOOST_CHECK(!fc::exists(dir.path / "test.0-2.run"));
+        BOOST_CHECK(!fc::exists(dir.path / "test.500-600.run"));
+        BOOST_CHECK(!fc::exists(dir.path / "test.600-700.run.tmp"));
+        BOOST_CHECK(index.end() <= 10);
+        for (uint64_t n = index.end(); n < 10; n++) {
+            addSeq(index, n);
+        }
+        for (uint64_t k : {0, 1, 2, 10}) {
+            BOOST_CHECK(seqsOf(index, k) == expected(k, 10));
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,42 @@
+#define BOOST_TEST_MODULE binomialcdftable_unittest
+#include <boost/test/included/unit_test.hpp>
+
+#include <random>
+
+#include <boost/math/distributions/binomial.hpp>
+
+#include <rpos/BinomialCdfTable.h>
+
+using namespace ultrainio;
+
+static int reverseBinoCdf(double rand, int stake, double p) {
+    int k = 0;
+    boost::math::binomial b(stake, p);
+    while (rand > boost::math::cdf(b, k)) {
+        k++;
+    }
+    return k;
+}
+
+BOOST_AUTO_TEST_SUITE(binomialcdftable_unittest)
+
+    BOOST_AUTO_TEST_CASE(same_as_cdf_loop) {
+        std::mt19937_64 rng(7);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (int members : {1, 7, 100, 1000}) {
+            double total = members * 6000.0;
+            for (double stakeNumber : {7.0, 1000.0}) {
+                double p = stakeNumber / total;
+                BinomialCdfTable table(6000, p);
+                BOOST_CHECK(table.size() > 0);
+                BOOST_CHECK_EQUAL(table.reverse(0.0), 0);
+                BOOST_CHECK_EQUAL(table.reverse(1.0), reverseBinoCdf(1.0, 6000, p));
+                for (int i = 0; i < 200; i++) {
+                    double rand = dist(rng);
+                    BOOST_CHECK_EQUAL(table.reverse(rand), reverseBinoCdf(rand, 6000, p));
+                }
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
 
 #include <random>
 #include <rpos/Config.h>
+#include <rpos/FisherYates.h>
 #include <rpos/RoleRandom.h>
 #include <rpos/RoleSelection.h>
 
@@ -59,6 +60,34 @@ BOOST_AUTO_TEST_SUITE(fisheryates_unittest)
         BOOST_CHECK(proposerNumber == Config::kDesiredProposerNumber);
     }
 
+    BOOST_AUTO_TEST_CASE(partial_shuffle) {
+        fc::sha256 h = fc::sha256::hash(std::string("ultrain"));
+        int committeeSize = 300;
+        FisherYates fys(h, committeeSize);
+        std::vector<int> all = fys.shuffle();
+        std::vector<int> part = fys.shuffle(Config::kDesiredVoterNumber);
+        BOOST_CHECK(std::equal(part.begin(), part.begin() + Config::kDesiredVoterNumber, all.begin()));
+    }
+
+    BOOST_AUTO_TEST_CASE(index_equal_account) {
+        BlockIdType seed(std::string("0000052af4157bf7f13c9f08305d6510053dbb58b1c33d0ea38a3e302c6e3287"));
+        RoleRandom r(seed, 1000);
+        int committeeSize = 200;
+        std::vector<std::string> committee = genCommitteeV(committeeSize);
+        RoleSelection selection(committee, r);
+        int voterNumber = 0;
+        for (int i = 0; i < committeeSize; i++) {
+            BOOST_CHECK(selection.isVoter(i) == selection.isVoter(committee[i]));
+            BOOST_CHECK(selection.isProposer(i) == selection.isProposer(committee[i]));
+            BOOST_CHECK(selection.proposerPriority(i) == selection.proposerPriority(committee[i]));
+            if (selection.isVoter(i)) {
+                voterNumber++;
+            }
+        }
+        BOOST_CHECK(voterNumber == selection.voterNumber());
+        BOOST_CHECK(!selection.isVoter(-1));
+        BOOST_CHECK(!selection.isVoter(committeeSize));
+    }
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,130 @@
+#define BOOST_TEST_MODULE roundmsgcache_unittest
+#include <boost/test/included/unit_test.hpp>
+
+#include <rpos/Config.h>
+#include <rpos/RoundMsgCache.h>
+
+using namespace ultrainio;
+
+static EchoMsg makeEcho(const std::string& account, uint32_t blockNum, ConsensusPhase phase, uint32_t baxCount) {
+    EchoMsg echo;
+    echo.blockId = BlockIdType();
+    echo.blockId._hash[0] = blockNum;
+    echo.phase = phase;
+    echo.baxCount = baxCount;
+    echo.account = AccountName(account);
+    echo.timestamp = blockNum;
+    return echo;
+}
+
+BOOST_AUTO_TEST_SUITE(roundmsgcache_unittest)
+
+    BOOST_AUTO_TEST_CASE(claim_find_erase) {
+        RoundMsgCache<EchoCacheSlot, 64> cache(200);
+        RoundInfo info(10, kPhaseBA1);
+        BOOST_CHECK(cache.find(info) == nullptr);
+        EchoCacheSlot* slot = cache.findOrClaim(info);
+        BOOST_REQUIRE(slot != nullptr);
+        slot->add(makeEcho("user.111", 10, kPhaseBA1, 0));
+        BOOST_CHECK(cache.find(info) == slot);
+        BOOST_CHECK(cache.findOrClaim(info) == slot);
+        BOOST_CHECK_EQUAL(cache.size(), 1);
+        cache.erase(info);
+        BOOST_CHECK(cache.find(info) == nullptr);
+        BOOST_CHECK(cache.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(held_slot_and_floor) {
+        // without overflow rounds the ring alone decides
+        RoundMsgCache<ProposeCacheSlot, 1> cache(0);
+        // block 11 and block 15 share a slot, the nearer round keeps it
+        BOOST_REQUIRE(cache.findOrClaim(RoundInfo(11, kPhaseBA0)) != nullptr);
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(15, kPhaseBA0)) == nullptr);
+        cache.expireBefore(RoundInfo(12, 0));
+        BOOST_CHECK(cache.find(RoundInfo(11, kPhaseBA0)) == nullptr);
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(11, kPhaseBA0)) == nullptr);
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(15, kPhaseBA0)) != nullptr);
+        // the floor never moves back
+        cache.expireBefore(RoundInfo(5, 0));
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(11, kPhaseBA0)) == nullptr);
+        cache.clear();
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(11, kPhaseBA0)) != nullptr);
+    }
+
+    BOOST_AUTO_TEST_CASE(echo_tallies) {
+        RoundMsgCache<EchoCacheSlot, 64> cache(200);
+        RoundInfo info(20, kPhaseBAX + 3);
+        EchoCacheSlot* slot = cache.findOrClaim(info);
+        BOOST_REQUIRE(slot != nullptr);
+        EchoMsg a = makeEcho("user.111", 20, kPhaseBAX, 3);
+        EchoMsg b = makeEcho("user.112", 20, kPhaseBAX, 3);
+        EchoMsg c = makeEcho("user.113", 21, kPhaseBAX, 3);
+        slot->add(a);
+        slot->add(b);
+        slot->add(c);
+        BOOST_CHECK(slot->contains(a));
+        BOOST_CHECK(!slot->contains(makeEcho("user.114", 20, kPhaseBAX, 3)));
+        BOOST_CHECK_EQUAL(slot->echoesOf(AccountName("user.111")), 1);
+        BOOST_CHECK_EQUAL(slot->echoesOf(AccountName("user.114")), 0);
+        BOOST_CHECK_EQUAL(slot->maxVoters, 2);
+        // a reclaimed slot starts empty
+        cache.expireBefore(RoundInfo(21, 0));
+        EchoCacheSlot* reused = cache.findOrClaim(RoundInfo(24, kPhaseBAX + 3));
+        BOOST_REQUIRE(reused == slot);
+        BOOST_CHECK(reused->msgs.empty());
+        BOOST_CHECK_EQUAL(reused->maxVoters, 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(overflow_rounds) {
+        RoundMsgCache<ProposeCacheSlot, 1> cache(2);
+        cache.expireBefore(RoundInfo(11, 0));
+        BOOST_REQUIRE(cache.findOrClaim(RoundInfo(15, kPhaseBA0)) != nullptr);
+        // block 11 takes the ring slot back, block 15 keeps its messages in the overflow
+        ProposeCacheSlot* far = cache.find(RoundInfo(15, kPhaseBA0));
+        far->add(ProposeMsg());
+        ProposeCacheSlot* near = cache.findOrClaim(RoundInfo(11, kPhaseBA0));
+        BOOST_REQUIRE(near != nullptr);
+        BOOST_CHECK(near->msgs.empty());
+        far = cache.find(RoundInfo(15, kPhaseBA0));
+        BOOST_REQUIRE(far != nullptr && far != near);
+        BOOST_CHECK_EQUAL(far->msgs.size(), 1);
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(15, kPhaseBA0)) == far);
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(19, kPhaseBA0)) != nullptr);
+        BOOST_CHECK_EQUAL(cache.size(), 3);
+        // a full overflow drops its oldest block
+        BOOST_CHECK(cache.findOrClaim(RoundInfo(23, kPhaseBA0)) != nullptr);
+        BOOST_CHECK(cache.find(RoundInfo(15, kPhaseBA0)) == nullptr);
+        BOOST_CHECK(cache.find(RoundInfo(19, kPhaseBA0)) != nullptr);
+        // the floor drops overflow rounds too
+        cache.expireBefore(RoundInfo(20, 0));
+        BOOST_CHECK(cache.find(RoundInfo(19, kPhaseBA0)) == nullptr);
+        BOOST_CHECK_EQUAL(cache.size(), 1);
+        cache.erase(RoundInfo(23, kPhaseBA0));
+        BOOST_CHECK(cache.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(echoes_ahead_need_sync) {
+        RoundMsgCache<EchoCacheSlot, 64> cache(200);
+        uint32_t blockNum = 100;
+        cache.expireBefore(RoundInfo(blockNum + 1, 0));
+        // the next blocks hold the ring slots that far rounds map to
+        for (uint32_t b = blockNum + 1; b <= blockNum + 4; b++) {
+            cache.findOrClaim(RoundInfo(b, kPhaseBA1))->add(makeEcho("user.111", b - 1, kPhaseBA1, 0));
+        }
+        BOOST_CHECK(hasEchoesAhead(cache, blockNum, THRESHOLD_SYNCING));
+        BOOST_CHECK(!hasEchoesAhead(cache, blockNum + 4, THRESHOLD_SYNCING));
+
+        // echoes of a block far ahead of the node, as seen by a node that fell behind
+        for (uint32_t ahead : {8, 150}) {
+            RoundInfo info(blockNum + 4 + ahead, kPhaseBA1);
+            EchoCacheSlot* slot = cache.findOrClaim(info);
+            BOOST_REQUIRE(slot != nullptr);
+            slot->add(makeEcho("user.112", info.blockNum - 1, kPhaseBA1, 0));
+            BOOST_CHECK(cache.find(info) == slot);
+            BOOST_CHECK(hasEchoesAhead(cache, blockNum + 4, THRESHOLD_SYNCING));
+            cache.erase(info);
+            BOOST_CHECK(!hasEchoesAhead(cache, blockNum + 4, THRESHOLD_SYNCING));
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()